@@ -108,6 +108,17 @@ class QPID_MESSAGING_CLASS_EXTERN Connection : public qpid::messaging::Handle<Co
      *      field set to the node name of the sender
      * - properties or client_properties: the properties to include in the open frame sent
      *
+     * The prefetch window of receivers can be sized automatically:
+     *
+     * - adaptive_capacity: if true, the capacity of each receiver
+     *      with a non-zero capacity is adjusted from the observed
+     *      consumption rate and the time spent waiting for messages
+     *      to arrive; Receiver::getCapacity() reports the current
+     *      window, and the value passed to Receiver::setCapacity() is
+     *      the starting point
+     * - adaptive_capacity_min: lower bound for the window (default 1)
+     * - adaptive_capacity_max: upper bound for the window (default 65535)
+     *
      * The following options can be used to tune behaviour if needed
      * (these are not yet supported over AMQP 1.0):
      *
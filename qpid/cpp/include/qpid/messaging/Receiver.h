@@ -27,6 +27,8 @@
 #include "qpid/messaging/Handle.h"
 #include "qpid/messaging/Duration.h"
 
+#include <vector>
+
 namespace qpid {
 namespace messaging {
 
@@ -89,6 +91,24 @@ class QPID_MESSAGING_CLASS_EXTERN Receiver : public qpid::messaging::Handle<Rece
      * closed, in which case isClose() will be true.
      */
     QPID_MESSAGING_EXTERN Message fetch(Duration timeout=Duration::FOREVER);
+    /**
+     * Retrieves a batch of messages for this Receiver's subscription
+     * in a single call. Waits for up to the specified timeout for the
+     * first message, as for fetch(), then takes any further messages
+     * that are already available without waiting, up to the size of
+     * the batch.
+     *
+     * The batch is owned by the caller and is intended to be reused
+     * across calls: its size determines the maximum number of
+     * messages retrieved and the Message instances it holds are
+     * overwritten in place.
+     *
+     * @return the number of messages retrieved, which are placed at
+     * the front of the batch; zero if there is no message available
+     * after waiting for the specified timeout, or if the receiver is
+     * closed.
+     */
+    QPID_MESSAGING_EXTERN uint32_t fetch(std::vector<Message>& batch, Duration timeout=Duration::FOREVER);
     /**
      * Sets the capacity for the Receiver. The capacity determines how
      * many incoming messages can be held in the Receiver before being
@@ -28,6 +28,7 @@
 #include "qpid/messaging/Handle.h"
 
 #include <string>
+#include <vector>
 
 namespace qpid {
 namespace messaging {
@@ -88,6 +89,12 @@ class QPID_MESSAGING_CLASS_EXTERN Session : public qpid::messaging::Handle<Sessi
      * Acknowledges all message up to the specified message.
      */
     QPID_MESSAGING_EXTERN void acknowledgeUpTo(Message&, bool sync=false);
+    /**
+     * Acknowledges the first count messages of a batch, as filled in
+     * by Receiver::fetch(std::vector<Message>&, Duration), using a
+     * single acknowledgement.
+     */
+    QPID_MESSAGING_EXTERN void acknowledge(std::vector<Message>& batch, uint32_t count, bool sync=false);
     /**
      * Rejects the specified message. The broker does not redeliver a
      * message that has been rejected. Once a message has been
@@ -27,6 +27,9 @@ except ImportError:
     import md5
     _md5Obj = md5.new
 
+# Statistics derived from each "hist" style (latency histogram) statistic
+HISTOGRAM_SUFFIXES = ["Samples", "Average", "Max", "P50", "P90", "P99"]
+
 class Hash:
   """ Manage the hash of an XML sub-tree """
   def __init__(self, node):
@@ -138,6 +141,18 @@ class SchemaType:
   def getName (self):
     return self.name
 
+  def genChanged (self, stream, changeFlag):
+    if self.perThread:
+      # Per-thread statistics are updated without a lock by many threads;
+      # only write the shared flag when it actually changes.
+      stream.write ("        if (!" + changeFlag + ") {\n")
+      stream.write ("            " + changeFlag + " = true;\n")
+      stream.write ("            notifyChange();\n")
+      stream.write ("        }\n")
+    else:
+      stream.write ("        " + changeFlag + " = true;\n")
+      stream.write ("        notifyChange();\n")
+
   def genAccessor (self, stream, varName, changeFlag = None, optional = False):
     if self.perThread:
       prefix = "getThreadStats()->"
@@ -149,7 +164,7 @@ class SchemaType:
       stream.write ("    inline void set_" + varName + " (" + self.asArg + " val) {\n");
       if not self.perThread:
         stream.write ("        ::qpid::management::Mutex::ScopedLock mutex(accessLock);\n")
-      if self.style != "mma":
+      if self.style not in ("mma", "hist"):
         stream.write ("        " + prefix + varName + " = val;\n")
         if optional:
           stream.write ("        presenceMask[presenceByte_%s] |= presenceMask_%s;\n" % (varName, varName))
@@ -165,10 +180,16 @@ class SchemaType:
         stream.write ("            " + prefix + varName + "Min = val;\n")
         stream.write ("        if (" + prefix + varName + "Max < val)\n")
         stream.write ("            " + prefix + varName + "Max = val;\n")
+      if self.style == "hist":
+        stream.write ("        " + prefix + varName + "Count++;\n")
+        stream.write ("        " + prefix + varName + "Total += val;\n")
+        stream.write ("        if (" + prefix + varName + "Max < val)\n")
+        stream.write ("            " + prefix + varName + "Max = val;\n")
+        stream.write ("        " + prefix + varName + "Buckets[::qpid::management::Histogram::bucket(val)]++;\n")
       if changeFlag != None:
-        stream.write ("        " + changeFlag + " = true;\n")
+        self.genChanged (stream, changeFlag)
       stream.write ("    }\n")
-      if self.style != "mma":
+      if self.style not in ("mma", "hist"):
         stream.write ("    inline " + self.asArg + " get_" + varName + "() {\n");
         if not self.perThread:
           stream.write ("        ::qpid::management::Mutex::ScopedLock mutex(accessLock);\n")
@@ -178,7 +199,7 @@ class SchemaType:
         stream.write ("    inline void clr_" + varName + "() {\n")
         stream.write ("        presenceMask[presenceByte_%s] &= ~presenceMask_%s;\n" % (varName, varName))
         if changeFlag != None:
-          stream.write ("        " + changeFlag + " = true;\n")
+          self.genChanged (stream, changeFlag)
         stream.write ("    }\n")
         stream.write ("    inline bool isSet_" + varName + "() {\n")
         stream.write ("        return (presenceMask[presenceByte_%s] & presenceMask_%s) != 0;\n" % (varName, varName))
@@ -192,7 +213,7 @@ class SchemaType:
         stream.write ("        if (" + varName + "High < " + varName + ")\n")
         stream.write ("            " + varName + "High = " + varName + ";\n")
       if changeFlag != None:
-        stream.write ("        " + changeFlag + " = true;\n")
+        self.genChanged (stream, changeFlag)
       stream.write ("    }\n");
       stream.write ("    inline void dec_" + varName + " (" + self.asArg + " by = 1) {\n");
       if not self.perThread:
@@ -202,7 +223,7 @@ class SchemaType:
         stream.write ("        if (" + varName + "Low > " + varName + ")\n")
         stream.write ("            " + varName + "Low = " + varName + ";\n")
       if changeFlag != None:
-        stream.write ("        " + changeFlag + " = true;\n")
+        self.genChanged (stream, changeFlag)
       stream.write ("    }\n");
 
   def genHiLoStatResets (self, stream, varName):
@@ -241,7 +262,7 @@ class SchemaType:
     stream.write(indent + "}\n")
 
   def genWrite (self, stream, varName, indent="    "):
-    if self.style != "mma":
+    if self.style not in ("mma", "hist"):
       stream.write (indent + self.encode.replace ("@", "buf").replace ("#", varName) + ";\n")
     if self.style == "wm":
       stream.write (indent + self.encode.replace ("@", "buf") \
@@ -258,11 +279,25 @@ class SchemaType:
       stream.write (indent + self.encode.replace ("@", "buf") \
                     .replace ("#", varName + "Count ? " + varName + "Total / " +
                               varName + "Count : 0") + ";\n")
+    if self.style == "hist":
+      for field in self.histogramFields (varName):
+        stream.write (indent + self.encode.replace ("@", "buf").replace ("#", field) + ";\n")
+
+  def histogramFields (self, varName):
+    # Order matches the statistics described by SchemaStatistic.genSchema
+    percentile = "::qpid::management::Histogram::percentile(" + varName + "Buckets, " + \
+                 varName + "Count, " + varName + "Max, %s)"
+    return [varName + "Count",
+            varName + "Count ? " + varName + "Total / " + varName + "Count : 0",
+            varName + "Max",
+            percentile % "0.5",
+            percentile % "0.9",
+            percentile % "0.99"]
 
   def genMap (self, stream, varName, indent="    ", key=None, mapName="_map"):
     if key is None:
       key = varName
-    if self.style != "mma":
+    if self.style not in ("mma", "hist"):
         var_cast = self.map.replace("#", varName)
         stream.write(indent + mapName + "[\"" + key + "\"] = ::qpid::types::Variant(" + var_cast + ");\n")
     if self.style == "wm":
@@ -284,6 +319,13 @@ class SchemaType:
         var_cast = self.map.replace("#", "(" + varName + "Total / " + varName + "Count)")
         stream.write(indent + mapName + "[\"" + key + "Avg\"] = " +
                      "(" + varName + "Count ? ::qpid::types::Variant(" + var_cast + ") : ::qpid::types::Variant(0));\n")
+    if self.style == "hist":
+        fields = self.histogramFields (varName)
+        for suffix, field in zip (HISTOGRAM_SUFFIXES, fields):
+            stream.write(indent + mapName + "[\"" + key + suffix + "\"] = " +
+                         "::qpid::types::Variant(" + self.map.replace("#", "(" + field + ")") + ");\n")
+        stream.write(indent + mapName + "[\"" + key + "Histogram\"] = " +
+                     "::qpid::management::Histogram::list(" + varName + "Buckets);\n")
 
   def getReadCode (self, varName, bufName):
     result = self.decode.replace ("@", bufName).replace ("#", varName)
@@ -576,7 +618,7 @@ class SchemaStatistic:
     return self.name
 
   def genDeclaration (self, stream, prefix="    "):
-    if self.type.type.style != "mma":
+    if self.type.type.style not in ("mma", "hist"):
       stream.write (prefix + self.type.type.cpp + "  " + self.name + ";\n")
     if self.type.type.style == 'wm':
       stream.write (prefix + self.type.type.cpp + "  " + self.name + "High;\n")
@@ -586,6 +628,11 @@ class SchemaStatistic:
       stream.write (prefix + "uint64_t  " + self.name + "Total;\n")
       stream.write (prefix + self.type.type.cpp + "  " + self.name + "Min;\n")
       stream.write (prefix + self.type.type.cpp + "  " + self.name + "Max;\n")
+    if self.type.type.style == "hist":
+      stream.write (prefix + "uint64_t  " + self.name + "Count;\n")
+      stream.write (prefix + "uint64_t  " + self.name + "Total;\n")
+      stream.write (prefix + self.type.type.cpp + "  " + self.name + "Max;\n")
+      stream.write (prefix + "uint64_t  " + self.name + "Buckets[::qpid::management::Histogram::BUCKETS];\n")
 
   def genAccessor (self, stream):
     self.type.type.genAccessor (stream, self.name, "instChanged")
@@ -596,29 +643,33 @@ class SchemaStatistic:
   def genPerThreadHiLoStatResets (self, stream):
     self.type.type.genPerThreadHiLoStatResets (stream, self.name, self.type.type.cpp)
 
-  def genSchemaText (self, stream, name, desc):
+  def genSchemaText (self, stream, name, desc, base=None):
+    if base == None:
+      base = self.type.type.base
     stream.write ("    ft.clear();\n")
     stream.write ("    ft[NAME] = \"" + name + "\";\n")
-    stream.write ("    ft[TYPE] = TYPE_" + self.type.type.base +";\n")
+    stream.write ("    ft[TYPE] = TYPE_" + base +";\n")
     if self.unit != None:
       stream.write ("    ft[UNIT] = \"" + self.unit   + "\";\n")
     if desc != None:
       stream.write ("    ft[DESC] = \"" + desc   + "\";\n")
     stream.write ("    buf.putMap(ft);\n\n")
 
-  def genSchemaTextMap(self, stream, name, desc):
+  def genSchemaTextMap(self, stream, name, desc, base=None):
+    if base == None:
+      base = self.type.type.base
     stream.write ("    {\n")
     stream.write ("        ::qpid::types::Variant::Map _value;\n")
-    stream.write ("        _value[TYPE] = TYPE_" + self.type.type.base +";\n")
+    stream.write ("        _value[TYPE] = TYPE_" + base +";\n")
     if self.unit != None:
       stream.write ("        _value[UNIT] = \"" + self.unit + "\";\n")
     if desc != None:
       stream.write ("        _value[DESC] = \"" + desc + "\";\n")
-    stream.write ("        _stats[\"" + self.name + "\"] = _value;\n")
+    stream.write ("        _stats[\"" + name + "\"] = _value;\n")
     stream.write ("    }\n\n")
 
   def genSchema (self, stream):
-    if self.type.type.style != "mma":
+    if self.type.type.style not in ("mma", "hist"):
       self.genSchemaText (stream, self.name, self.desc)
     if self.type.type.style == "wm":
       descHigh = self.desc
@@ -642,9 +693,17 @@ class SchemaStatistic:
       self.genSchemaText (stream, self.name + "Min",     descMin)
       self.genSchemaText (stream, self.name + "Max",     descMax)
       self.genSchemaText (stream, self.name + "Average", descAverage)
+    if self.type.type.style == "hist":
+      for suffix in HISTOGRAM_SUFFIXES:
+        self.genSchemaText (stream, self.name + suffix, self.histogramDesc (suffix))
+
+  def histogramDesc (self, suffix):
+    if self.desc == None:
+      return None
+    return self.desc + " (" + suffix + ")"
 
   def genSchemaMap (self, stream):
-    if self.type.type.style != "mma":
+    if self.type.type.style not in ("mma", "hist"):
       self.genSchemaTextMap (stream, self.name, self.desc)
     if self.type.type.style == "wm":
       descHigh = self.desc
@@ -668,6 +727,10 @@ class SchemaStatistic:
       self.genSchemaTextMap (stream, self.name + "Min",     descMin)
       self.genSchemaTextMap (stream, self.name + "Max",     descMax)
       self.genSchemaTextMap (stream, self.name + "Average", descAverage)
+    if self.type.type.style == "hist":
+      for suffix in HISTOGRAM_SUFFIXES:
+        self.genSchemaTextMap (stream, self.name + suffix, self.histogramDesc (suffix))
+      self.genSchemaTextMap (stream, self.name + "Histogram", self.histogramDesc ("Histogram"), "LIST")
 
   def genAssign (self, stream):
     if self.assign != None:
@@ -692,7 +755,7 @@ class SchemaStatistic:
 
   def genInitialize (self, stream, prefix="", indent="    "):
     val = self.type.type.init
-    if self.type.type.style != "mma":
+    if self.type.type.style not in ("mma", "hist"):
       stream.write (indent + prefix + self.name + " = " + val + ";\n")
     if self.type.type.style == "wm":
       stream.write (indent + prefix + self.name + "High = " + val + ";\n")
@@ -702,6 +765,15 @@ class SchemaStatistic:
       stream.write (indent + prefix + self.name + "Min   = std::numeric_limits<" + self.type.type.cpp + ">::max();\n")
       stream.write (indent + prefix + self.name + "Max   = std::numeric_limits<" + self.type.type.cpp + ">::min();\n")
       stream.write (indent + prefix + self.name + "Total = 0;\n")
+    if self.type.type.style == "hist":
+      self.genHistogramInitialize (stream, prefix, indent)
+
+  def genHistogramInitialize (self, stream, prefix, indent):
+    stream.write (indent + prefix + self.name + "Count = 0;\n")
+    stream.write (indent + prefix + self.name + "Total = 0;\n")
+    stream.write (indent + prefix + self.name + "Max   = 0;\n")
+    stream.write (indent + "for (size_t _b = 0; _b < ::qpid::management::Histogram::BUCKETS; _b++)\n")
+    stream.write (indent + "    " + prefix + self.name + "Buckets[_b] = 0;\n")
 
   def genInitializeTotalPerThreadStats (self, stream):
     if self.type.type.style == "mma":
@@ -709,6 +781,8 @@ class SchemaStatistic:
       stream.write ("    totals->" + self.name + "Min   = std::numeric_limits<" + self.type.type.cpp + ">::max();\n")
       stream.write ("    totals->" + self.name + "Max   = std::numeric_limits<" + self.type.type.cpp + ">::min();\n")
       stream.write ("    totals->" + self.name + "Total = 0;\n")
+    elif self.type.type.style == "hist":
+      self.genHistogramInitialize (stream, "totals->", "    ")
     else:
       stream.write ("    totals->" + self.name + " = 0;\n")
 
@@ -720,6 +794,13 @@ class SchemaStatistic:
       stream.write ("            if (totals->%sMax < threadStats->%sMax)\n" % (self.name, self.name))
       stream.write ("                totals->%sMax = threadStats->%sMax;\n" % (self.name, self.name))
       stream.write ("            totals->%sTotal += threadStats->%sTotal;\n" % (self.name, self.name))
+    elif self.type.type.style == "hist":
+      stream.write ("            totals->%sCount += threadStats->%sCount;\n" % (self.name, self.name))
+      stream.write ("            totals->%sTotal += threadStats->%sTotal;\n" % (self.name, self.name))
+      stream.write ("            if (totals->%sMax < threadStats->%sMax)\n" % (self.name, self.name))
+      stream.write ("                totals->%sMax = threadStats->%sMax;\n" % (self.name, self.name))
+      stream.write ("            for (size_t _b = 0; _b < ::qpid::management::Histogram::BUCKETS; _b++)\n")
+      stream.write ("                totals->%sBuckets[_b] += threadStats->%sBuckets[_b];\n" % (self.name, self.name))
     else:
       stream.write ("            totals->%s += threadStats->%s;\n" % (self.name, self.name))
 
@@ -1304,6 +1385,8 @@ class SchemaClass:
         count = count + 2
       if inst.type.type.style == "mma":
         count = count + 3
+      if inst.type.type.style == "hist":
+        count = count + len (HISTOGRAM_SUFFIXES) - 1
     stream.write ("%d" % count)
 
   def genInstDeclarations (self, stream, variables):
@@ -72,8 +72,7 @@ uint8_t /*MGEN:Class.NameCap*/::md5Sum[MD5_LEN]   =
 {
 /*MGEN:IF(Class.ExistPerThreadStats)*/
     for (int idx = 0; idx < maxThreads; idx++)
-        if (perThreadStatsArray[idx] != 0)
-            delete perThreadStatsArray[idx];
+        freeThreadStats(perThreadStatsArray[idx]);
     delete[] perThreadStatsArray;
 /*MGEN:ENDIF*/
 }
@@ -29,6 +29,7 @@
 #include <boost/shared_ptr.hpp>
 /*MGEN:ENDIF*/
 #include <limits>
+#include <new>
 
 namespace qpid {
     namespace management {
@@ -70,7 +71,7 @@ namespace qmf {
         int idx = getThreadIndex();
         struct PerThreadStats* threadStats = perThreadStatsArray[idx];
         if (threadStats == 0) {
-            threadStats = new(PerThreadStats);
+            threadStats = new(allocateThreadStats(sizeof(PerThreadStats))) PerThreadStats;
             perThreadStatsArray[idx] = threadStats;
 /*MGEN:Class.InitializePerThreadElements*/
         }
@@ -136,7 +137,7 @@ namespace qmf {
 
 /*MGEN:IF(Class.ExistPerThreadStats)*/
     struct PerThreadStats* getStatistics() { return getThreadStats(); }
-    void statisticsUpdated() { instChanged = true; }
+    void statisticsUpdated() { if (!instChanged) { instChanged = true; notifyChange(); } }
 /*MGEN:ENDIF*/
 };
 
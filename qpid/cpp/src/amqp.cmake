@@ -86,6 +86,7 @@ if (BUILD_AMQP)
          qpid/broker/amqp/NodeProperties.cpp
          qpid/broker/amqp/Outgoing.h
          qpid/broker/amqp/Outgoing.cpp
+         qpid/broker/amqp/PendingDeliveries.h
          qpid/broker/amqp/ProtocolPlugin.cpp
          qpid/broker/amqp/Relay.h
          qpid/broker/amqp/Relay.cpp
@@ -156,6 +156,26 @@ bool Acl::authorise(
     return result(aclreslt, id, action, objType, ExchangeName);
 }
 
+bool Acl::authorisePublish(
+    const std::string& id,
+    const std::string& ExchangeName,
+    const std::string& RoutingKey,
+    uint32_t&          version,
+    bool&              cacheable)
+{
+    boost::shared_ptr<AclData> dataLocal;
+    {
+        Mutex::ScopedLock locker(dataLock);
+        dataLocal = data;  //rcu copy
+        version = rulesVersion.get();
+    }
+
+    AclResult aclreslt = dataLocal->lookup(id, ACT_PUBLISH, OBJ_EXCHANGE, ExchangeName, RoutingKey);
+    cacheable = (aclreslt == ALLOW);
+
+    return result(aclreslt, id, ACT_PUBLISH, OBJ_EXCHANGE, ExchangeName);
+}
+
 
 bool Acl::approveConnection(const qpid::broker::Connection& conn)
 {
@@ -275,6 +295,7 @@ bool Acl::readAclFile(std::string& aclFile, std::string& errorText) {
     {
         Mutex::ScopedLock locker(dataLock);
         data = d;
+        ++rulesVersion;
     }
     transferAcl = data->transferAcl; // any transfer ACL
     userRules = true; // rules in force came from an ACL file
@@ -320,6 +341,7 @@ void Acl::loadEmptyAclRuleset() {
     {
         Mutex::ScopedLock locker(dataLock);
         data = d;
+        ++rulesVersion;
     }
     if (mgmtObject!=0){
         mgmtObject->set_transferAcl(transferAcl?1:0);
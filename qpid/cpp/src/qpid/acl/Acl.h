@@ -29,6 +29,7 @@
 #include "qpid/management/Manageable.h"
 #include "qpid/management/ManagementAgent.h"
 #include "qmf/org/apache/qpid/acl/Acl.h"
+#include "qpid/sys/AtomicValue.h"
 #include "qpid/sys/Mutex.h"
 
 #include <boost/shared_ptr.hpp>
@@ -63,6 +64,7 @@ private:
     broker::Broker*                      broker;
     bool                                 transferAcl;
     boost::shared_ptr<AclData>           data;
+    sys::AtomicValue<uint32_t>           rulesVersion; // changed with data
     qmf::org::apache::qpid::acl::Acl::shared_ptr mgmtObject;
     qpid::management::ManagementAgent*   agent;
     mutable qpid::sys::Mutex             dataLock;
@@ -106,6 +108,17 @@ public:
         const std::string&               ExchangeName,
         const std::string&               RoutingKey);
 
+    virtual bool authorisePublish(
+        const std::string&               id,
+        const std::string&               ExchangeName,
+        const std::string&               RoutingKey,
+        uint32_t&                        version,
+        bool&                            cacheable);
+
+    inline virtual uint32_t getRulesVersion() {
+        return rulesVersion.get();
+    };
+
     // Resource quota tracking
     virtual bool approveConnection(const broker::Connection& connection);
     virtual bool approveCreateQueue(const std::string& userId, const std::string& queueName);
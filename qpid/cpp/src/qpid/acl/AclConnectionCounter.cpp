@@ -49,6 +49,11 @@ ConnectionCounter::ConnectionCounter(Acl& a, uint16_t nl, uint16_t hl, uint16_t
 ConnectionCounter::~ConnectionCounter() {}
 
 
+ConnectionCounter::ProgressShard& ConnectionCounter::progressShard(const std::string& mgmtId) {
+    return progressShards[connectCountsMap_t::hasher()(mgmtId) % PROGRESS_SHARDS];
+}
+
+
 //
 // limitApproveLH
 //
@@ -88,7 +93,7 @@ bool ConnectionCounter::limitApproveLH(
 //
 // Increment the name's count in map and return an optional comparison
 //  against a connection limit.
-// Called with dataLock already taken.
+// Called with the lock guarding theMap already taken.
 //
 bool ConnectionCounter::countConnectionLH(
     connectCountsMap_t& theMap,
@@ -154,15 +159,18 @@ void ConnectionCounter::connection(broker::Connection& connection) {
 
     const std::string& hostName(getClientHost(connection.getMgmtId()));
 
-    Mutex::ScopedLock locker(dataLock);
-
     // Total connections goes up
     totalCurrentConnections += 1;
 
     // Record the fact that this connection exists
-    connectProgressMap[connection.getMgmtId()] = C_CREATED;
+    {
+        ProgressShard& shard(progressShard(connection.getMgmtId()));
+        Mutex::ScopedLock locker(shard.lock);
+        shard.connectProgressMap[connection.getMgmtId()] = C_CREATED;
+    }
 
     // Count the connection from this host.
+    Mutex::ScopedLock locker(dataLock);
     (void) countConnectionLH(connectByHostMap, hostName, hostLimit, false, false);
 }
 
@@ -174,11 +182,21 @@ void ConnectionCounter::closed(broker::Connection& connection) {
     QPID_LOG(trace, "ACL ConnectionCounter closed: " << connection.getMgmtId()
         << ", userId:" << connection.getUserId());
 
-    Mutex::ScopedLock locker(dataLock);
+    // Take and destroy the connection progress indicator
+    uint32_t progress(0);
+    {
+        ProgressShard& shard(progressShard(connection.getMgmtId()));
+        Mutex::ScopedLock locker(shard.lock);
+        connectCountsMap_t::iterator eRef = shard.connectProgressMap.find(connection.getMgmtId());
+        if (eRef != shard.connectProgressMap.end()) {
+            progress = (*eRef).second;
+            shard.connectProgressMap.erase(eRef);
+        }
+    }
 
-    connectCountsMap_t::iterator eRef = connectProgressMap.find(connection.getMgmtId());
-    if (eRef != connectProgressMap.end()) {
-        if ((*eRef).second == C_OPENED){
+    if (progress) {
+        Mutex::ScopedLock locker(dataLock);
+        if (progress == C_OPENED){
             // Normal case: connection was created and opened.
             // Decrement user in-use counts
             releaseLH(connectByNameMap,
@@ -192,9 +210,6 @@ void ConnectionCounter::closed(broker::Connection& connection) {
         releaseLH(connectByHostMap,
                   getClientHost(connection.getMgmtId()));
 
-        // destroy connection progress indicator
-        connectProgressMap.erase(eRef);
-
     } else {
         // connection not found in progress map
         QPID_LOG(notice, "ACL ConnectionCounter closed info for '" << connection.getMgmtId()
@@ -220,11 +235,13 @@ bool ConnectionCounter::approveConnection(
 {
     const std::string& hostName(getClientHost(connection.getMgmtId()));
 
-    Mutex::ScopedLock locker(dataLock);
-
     // Bump state from CREATED to OPENED
-    (void) countConnectionLH(connectProgressMap, connection.getMgmtId(),
-                             C_OPENED, false, false);
+    {
+        ProgressShard& shard(progressShard(connection.getMgmtId()));
+        Mutex::ScopedLock locker(shard.lock);
+        (void) countConnectionLH(shard.connectProgressMap, connection.getMgmtId(),
+                                 C_OPENED, false, false);
+    }
 
     // Run global black/white list check
     sys::SocketAddress sa(hostName, "");
@@ -241,19 +258,25 @@ bool ConnectionCounter::approveConnection(
     // Approve total connections
     bool okTotal  = true;
     if (totalLimit > 0) {
-        okTotal = totalCurrentConnections <= totalLimit;
+        uint32_t current = totalCurrentConnections.get();
+        okTotal = current <= totalLimit;
         QPID_LOG(trace, "ACL ConnectionApprover totalLimit=" << totalLimit
-                 << " curValue=" << totalCurrentConnections
+                 << " curValue=" << current
                  << " result=" << (okTotal ? "allow" : "deny"));
     }
 
-    // Approve by IP host connections
-    bool okByIP   = limitApproveLH(connectByHostMap, hostName, hostLimit, true);
+    bool okByIP, okByUser;
+    {
+        Mutex::ScopedLock locker(dataLock);
 
-    // Count and Approve the connection by the user
-    bool okByUser = countConnectionLH(connectByNameMap, userName,
-                                      connectionUserQuota, true,
-                                      enforcingConnectionQuotas);
+        // Approve by IP host connections
+        okByIP   = limitApproveLH(connectByHostMap, hostName, hostLimit, true);
+
+        // Count and Approve the connection by the user
+        okByUser = countConnectionLH(connectByNameMap, userName,
+                                     connectionUserQuota, true,
+                                     enforcingConnectionQuotas);
+    }
 
     // Emit separate log for each disapproval
     if (!okByHostList) {
@@ -23,11 +23,11 @@
  */
 
 #include "qpid/broker/ConnectionObserver.h"
+#include "qpid/sys/AtomicValue.h"
 #include "qpid/sys/Mutex.h"
+#include "qpid/sys/unordered_map.h"
 #include "qpid/acl/AclData.h"
 
-#include <map>
-
 namespace qpid {
 
 namespace broker {
@@ -44,18 +44,25 @@ class Acl;
 class ConnectionCounter : public broker::ConnectionObserver
 {
 private:
-    typedef std::map<std::string, uint32_t> connectCountsMap_t;
+    typedef qpid::sys::unordered_map<std::string, uint32_t> connectCountsMap_t;
     enum CONNECTION_PROGRESS { C_CREATED=1, C_OPENED=2 };
 
+    /** Per-connection states, split by management ID to spread the locking */
+    struct ProgressShard {
+        qpid::sys::Mutex   lock;
+        connectCountsMap_t connectProgressMap;
+    };
+    static const size_t PROGRESS_SHARDS = 32;
+
     Acl&             acl;
     uint16_t         nameLimit;
     uint16_t         hostLimit;
     uint16_t         totalLimit;
-    uint16_t         totalCurrentConnections;
-    qpid::sys::Mutex dataLock;
+    qpid::sys::AtomicValue<uint32_t> totalCurrentConnections;
+    qpid::sys::Mutex dataLock;  // Guards the per-username and per-host counts
 
     /** Records per-connection state */
-    connectCountsMap_t connectProgressMap;
+    ProgressShard progressShards[PROGRESS_SHARDS];
 
     /** Records per-username counts */
     connectCountsMap_t connectByNameMap;
@@ -63,6 +70,8 @@ private:
     /** Records per-host counts */
     connectCountsMap_t connectByHostMap;
 
+    ProgressShard& progressShard(const std::string& mgmtId);
+
     /** Given a connection's management ID, return the client host name */
     std::string getClientHost(const std::string mgmtId);
 
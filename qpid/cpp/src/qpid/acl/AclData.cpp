@@ -83,6 +83,38 @@ void AclData::clear ()
     queueQuotaRuleSettings->clear();
     connBWHostsGlobalRules->clear();
     connBWHostsUserRules->clear();
+    publishIndex.clear();
+}
+
+
+//
+// indexPublishRules
+//
+// Called once all the rules are loaded. A rule whose exchange name is
+// plain text can only match that exchange, all the others must be
+// checked for every exchange.
+//
+void AclData::indexPublishRules()
+{
+    publishIndex.clear();
+    if (!actionList[ACT_PUBLISH] || !actionList[ACT_PUBLISH][OBJ_EXCHANGE])
+        return;
+    actionObject& actors = *actionList[ACT_PUBLISH][OBJ_EXCHANGE];
+    for (actObjItr aoItr = actors.begin(); aoItr != actors.end(); aoItr++) {
+        PublishIndex& index = publishIndex[aoItr->first];
+        for (size_t pos = aoItr->second.size(); pos-- > 0; ) {
+            const Rule& rule = aoItr->second[pos];
+            const std::string& exch = rule.pubExchName;
+            if (!rule.pubExchNameInRule || rule.ruleHasUserSub[PROP_NAME] ||
+                (!exch.empty() && exch[exch.size()-1] == ACL_SYMBOL_WILDCARD)) {
+                index.anyExchange.push_back(pos);
+            } else if (rule.pubExchNameMatchesBlank) {
+                index.byExchange[std::string()].push_back(pos);
+            } else {
+                index.byExchange[exch].push_back(pos);
+            }
+        }
+    }
 }
 
 void AclData::printDecisionRules(int userFieldWidth) {
@@ -533,7 +565,29 @@ AclResult AclData::lookup(
         if (itrRule == actionList[action][objType]->end()) {
             itrRule = actionList[action][objType]->find(ACL_KEYWORD_WILDCARD);
         }
-        if (itrRule != actionList[action][objType]->end() ) {
+        publishIndexMap::const_iterator index = publishIndex.end();
+        if (itrRule != actionList[action][objType]->end() &&
+            action == ACT_PUBLISH && objType == OBJ_EXCHANGE) {
+            index = publishIndex.find(itrRule->first);
+        }
+        if (index != publishIndex.end()) {
+            // Check the rules for this exchange and the rules for any
+            // exchange, merged back into rule order.
+            static const PublishIndex::positions none;
+            std::map<std::string, PublishIndex::positions>::const_iterator
+                named = index->second.byExchange.find(name);
+            const PublishIndex::positions& exch =
+                named == index->second.byExchange.end() ? none : named->second;
+            const PublishIndex::positions& any = index->second.anyExchange;
+            PublishIndex::positions::const_iterator e = exch.begin(), a = any.begin();
+            while (e != exch.end() || a != any.end()) {
+                size_t pos = (a == any.end() || (e != exch.end() && *e > *a)) ? *e++ : *a++;
+                if (lookupMatchPublishExchangeRule(itrRule->second.begin() + pos,
+                                                   id, name, routingKey, aclresult)) {
+                    return aclresult;
+                }
+            }
+        } else if (itrRule != actionList[action][objType]->end() ) {
             // Found a rule list for this user-action-object set.
             // Search the rule list for a matching rule.
             ruleSetItr rsItr = itrRule->second.end();
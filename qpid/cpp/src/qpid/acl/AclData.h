@@ -168,6 +168,21 @@ public:
     typedef  std::map<std::string, bwHostRuleSet> bwHostUserRuleMap; //<username, hosts-vector>
     typedef  bwHostUserRuleMap::const_iterator    bwHostUserRuleMapItr;
 
+    //
+    // PublishIndex
+    //
+    // Built by indexPublishRules() for each actor's publish exchange
+    //  rules so a publish lookup only checks rules that can match the
+    //  exchange name. Entries are positions in the actor's ruleSet,
+    //  highest first, the order in which lookup() checks them.
+    //
+    struct PublishIndex {
+        typedef std::vector<size_t> positions;
+        std::map<std::string, positions> byExchange; // rules naming one exchange
+        positions anyExchange;  // rules with no name, a wildcard or substitution
+    };
+    typedef  std::map<std::string, PublishIndex> publishIndexMap; // <actor, index>
+
     // Action*[] -> Object*[] -> map<user, set<Rule> >
     aclAction*           actionList[qpid::acl::ACTIONSIZE];
     qpid::acl::AclResult decisionMode;  // allow/deny[-log] if no matching rule found
@@ -199,6 +214,7 @@ public:
 
     bool matchProp(const std::string & src, const std::string& src1);
     void clear ();
+    void indexPublishRules();
     void printDecisionRules(int userFieldWidth);
 
     static const std::string ACL_KEYWORD_USER_SUBST;
@@ -316,6 +332,9 @@ private:
 
     // Per-user host connection black/white rule set map
     boost::shared_ptr<bwHostUserRuleMap> connBWHostsUserRules;
+
+    // Per-actor index of publish exchange rules
+    publishIndexMap publishIndex;
 };
 
 }} // namespace qpid::acl
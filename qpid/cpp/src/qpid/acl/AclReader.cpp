@@ -278,6 +278,8 @@ namespace acl {
         d->setConnGlobalRules(globalHostRules);
         // user B/W connection rules
         d->setConnUserRules(userHostRules);
+        // fast path for publish lookups
+        d->indexPublishRules();
     }
 
 
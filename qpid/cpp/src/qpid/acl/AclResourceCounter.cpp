@@ -46,6 +46,11 @@ ResourceCounter::ResourceCounter(Acl& a, uint16_t ql) :
 ResourceCounter::~ResourceCounter() {}
 
 
+ResourceCounter::OwnerShard& ResourceCounter::ownerShard(const std::string& queueName) {
+    return ownerShards[queueOwnerMap_t::hasher()(queueName) % OWNER_SHARDS];
+}
+
+
 //
 // limitApproveLH
 //
@@ -130,13 +135,17 @@ bool ResourceCounter::approveCreateQueue(const std::string& userId,
         bool enforcingQueueQuotas,
         uint16_t queueUserQuota )
 {
-    Mutex::ScopedLock locker(dataLock);
-
-    bool okByQ = limitApproveLH(queuePerUserMap, userId, queueUserQuota, true, enforcingQueueQuotas);
+    bool okByQ;
+    {
+        Mutex::ScopedLock locker(dataLock);
+        okByQ = limitApproveLH(queuePerUserMap, userId, queueUserQuota, true, enforcingQueueQuotas);
+    }
 
     if (okByQ) {
         // Queue is owned by this userId
-        queueOwnerMap[queueName] = userId;
+        OwnerShard& shard(ownerShard(queueName));
+        Mutex::ScopedLock locker(shard.lock);
+        shard.queueOwnerMap[queueName] = userId;
 
         QPID_LOG(trace, "ACL create queue approved for user '" << userId
             << "' queue '" << queueName << "'");
@@ -158,13 +167,22 @@ bool ResourceCounter::approveCreateQueue(const std::string& userId,
 //
 void ResourceCounter::recordDestroyQueue(const std::string& queueName)
 {
-    Mutex::ScopedLock locker(dataLock);
-
-    queueOwnerMap_t::iterator eRef = queueOwnerMap.find(queueName);
-    if (eRef != queueOwnerMap.end()) {
-        releaseLH(queuePerUserMap, (*eRef).second);
+    std::string owner;
+    bool found(false);
+    {
+        OwnerShard& shard(ownerShard(queueName));
+        Mutex::ScopedLock locker(shard.lock);
+        queueOwnerMap_t::iterator eRef = shard.queueOwnerMap.find(queueName);
+        if (eRef != shard.queueOwnerMap.end()) {
+            owner = (*eRef).second;
+            found = true;
+            shard.queueOwnerMap.erase(eRef);
+        }
+    }
 
-        queueOwnerMap.erase(eRef);
+    if (found) {
+        Mutex::ScopedLock locker(dataLock);
+        releaseLH(queuePerUserMap, owner);
     } else {
         QPID_LOG(notice, "ACL resource counter: Queue '" << queueName
             << "' not found in queue owner map");
@@ -23,8 +23,9 @@
  */
 
 #include "qpid/sys/Mutex.h"
+#include "qpid/sys/unordered_map.h"
 
-#include <map>
+#include <string>
 
 namespace qpid {
 
@@ -37,19 +38,28 @@ class Acl;
 class ResourceCounter
 {
 private:
-    typedef std::map<std::string, uint32_t> countsMap_t;
-    typedef std::map<std::string, std::string> queueOwnerMap_t;
+    typedef qpid::sys::unordered_map<std::string, uint32_t> countsMap_t;
+    typedef qpid::sys::unordered_map<std::string, std::string> queueOwnerMap_t;
+
+    /** Queue owners, split by queue name to spread the locking */
+    struct OwnerShard {
+        qpid::sys::Mutex lock;
+        queueOwnerMap_t  queueOwnerMap;
+    };
+    static const size_t OWNER_SHARDS = 32;
 
     Acl&             acl;
     uint16_t         queueLimit;
-    qpid::sys::Mutex dataLock;
+    qpid::sys::Mutex dataLock;  // Guards the queue-by-owner counts
 
     /** Records queueName-queueUserId */
-    queueOwnerMap_t queueOwnerMap;
+    OwnerShard ownerShards[OWNER_SHARDS];
 
     /** Records queue-by-owner counts */
     countsMap_t queuePerUserMap;
 
+    OwnerShard& ownerShard(const std::string& queueName);
+
     /** Return approval for proposed resource creation */
     bool limitApproveLH(countsMap_t& theMap,
                         const std::string& theName,
@@ -19,7 +19,7 @@
  *
  */
 #include "qpid/amqp_0_10/Connection.h"
-#include "qpid/log/Statement.h"
+#include "qpid/log/BinaryTrace.h"
 #include "qpid/framing/reply_exceptions.h"
 #include "qpid/framing/AMQFrame.h"
 #include "qpid/framing/Buffer.h"
@@ -54,9 +54,13 @@ size_t  Connection::decode(const char* buffer, size_t size) {
         }
     }
     framing::AMQFrame frame;
+    size_t start = in.getPosition();
     while(!pushClosed && frame.decode(in)) {
-        QPID_LOG(trace, "RECV [" << identifier << "]: " << frame);
-         connection->received(frame);
+        QPID_LOG_BINARY(trace, "RECV [{}]: {}",
+                        << identifier << log::BinaryTrace::Frames(buffer + start, in.getPosition() - start),
+                        "RECV [" << identifier << "]: " << frame);
+        connection->received(frame);
+        start = in.getPosition();
     }
     return in.getPosition();
 }
@@ -93,7 +97,9 @@ size_t  Connection::encode(char* buffer, size_t size) {
     size_t encoded=0;
     while (!workQueue.empty() && ((frameSize=workQueue.front().encodedSize()) <= out.available())) {
         workQueue.front().encode(out);
-        QPID_LOG(trace, "SENT [" << identifier << "]: " << workQueue.front());
+        QPID_LOG_BINARY(trace, "SENT [{}]: {}",
+                        << identifier << log::BinaryTrace::Frames(buffer + out.getPosition() - frameSize, frameSize),
+                        "SENT [" << identifier << "]: " << workQueue.front());
         workQueue.pop_front();
         encoded += frameSize;
         if (workQueue.empty() && out.available() > 0) {
@@ -21,6 +21,7 @@
  */
 
 #include "qpid/acl/AclLexer.h"
+#include "qpid/sys/IntegerTypes.h"
 #include <map>
 #include <string>
 
@@ -56,6 +57,22 @@ namespace broker {
             const std::string&      ExchangeName,
             const std::string&      RoutingKey)=0;
 
+        /** As the publish authorise() above, also returning the version
+         *  of the rules that made the decision, see getRulesVersion(),
+         *  and whether the decision may be reused while that version is
+         *  in force: allow decisions that are not logged.
+         */
+        virtual bool authorisePublish(
+            const std::string&      id,
+            const std::string&      ExchangeName,
+            const std::string&      RoutingKey,
+            uint32_t&               version,
+            bool&                   cacheable)=0;
+
+        /** Version of the rules in force, changed when they are reloaded.
+         */
+        virtual uint32_t getRulesVersion()=0;
+
         // Add specialized authorise() methods as required.
 
         /** Approve connection by counting connections total, per-IP, and
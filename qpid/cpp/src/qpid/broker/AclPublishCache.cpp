@@ -0,0 +1,58 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/broker/AclPublishCache.h"
+#include "qpid/broker/AclModule.h"
+
+namespace qpid {
+namespace broker {
+
+namespace {
+// Bound on cached decisions: routing keys may be unique per message.
+const size_t MAX_SIZE = 1024;
+}
+
+AclPublishCache::AclPublishCache() : version(0), size(0) {}
+
+bool AclPublishCache::authorise(AclModule& acl, const std::string& user,
+                                const std::string& exchange, const std::string& routingKey)
+{
+    if (size && acl.getRulesVersion() == version) {
+        Exchanges::const_iterator i = allowed.find(exchange);
+        if (i != allowed.end() && i->second.find(routingKey) != i->second.end())
+            return true;
+    }
+    uint32_t decisionVersion;
+    bool cacheable = false;
+    bool result = acl.authorisePublish(user, exchange, routingKey, decisionVersion, cacheable);
+    if (result && cacheable) {
+        if (decisionVersion != version || size >= MAX_SIZE) {
+            allowed.clear();
+            size = 0;
+            version = decisionVersion;
+        }
+        allowed[exchange][routingKey] = true;
+        ++size;
+    }
+    return result;
+}
+
+}} // namespace qpid::broker
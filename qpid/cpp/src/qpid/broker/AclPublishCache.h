@@ -0,0 +1,62 @@
+#ifndef QPID_BROKER_ACLPUBLISHCACHE_H
+#define QPID_BROKER_ACLPUBLISHCACHE_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/broker/BrokerImportExport.h"
+#include "qpid/sys/IntegerTypes.h"
+#include "qpid/sys/unordered_map.h"
+#include <string>
+
+namespace qpid {
+namespace broker {
+class AclModule;
+
+/**
+ * Remembers which exchanges and routing keys a session's user has been
+ * allowed to publish to, so the ACL rules are not evaluated for every
+ * message. Only decisions the AclModule marks cacheable are kept, and
+ * all are forgotten when the ACL rules version changes.
+ *
+ * THREAD UNSAFE: used by a single session.
+ */
+class AclPublishCache
+{
+  public:
+    QPID_BROKER_EXTERN AclPublishCache();
+
+    /** @return true if user may publish to exchange with routingKey. */
+    QPID_BROKER_EXTERN bool authorise(AclModule&, const std::string& user,
+                                      const std::string& exchange, const std::string& routingKey);
+
+  private:
+    typedef sys::unordered_map<std::string, bool> Keys;
+    typedef sys::unordered_map<std::string, Keys> Exchanges;
+
+    uint32_t version;
+    size_t size;
+    Exchanges allowed;
+};
+
+}} // namespace qpid::broker
+
+#endif  /*!QPID_BROKER_ACLPUBLISHCACHE_H*/
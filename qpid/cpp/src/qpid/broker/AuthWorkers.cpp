@@ -0,0 +1,88 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/broker/AuthWorkers.h"
+#include "qpid/log/Statement.h"
+
+namespace qpid {
+namespace broker {
+
+AuthWorkers::AuthWorkers(size_t count, size_t l) : limit(l), stopped(false)
+{
+    for (size_t i = 0; i < count; ++i)
+        threads.push_back(sys::Thread(*this));
+}
+
+AuthWorkers::~AuthWorkers()
+{
+    stop();
+}
+
+bool AuthWorkers::submit(const Task& task, const Task& abandon)
+{
+    sys::Monitor::ScopedLock l(lock);
+    if (stopped || tasks.size() >= limit) return false;
+    tasks.push_back(std::make_pair(task, abandon));
+    lock.notify();
+    return true;
+}
+
+void AuthWorkers::stop()
+{
+    std::deque<std::pair<Task, Task> > abandoned;
+    {
+        sys::Monitor::ScopedLock l(lock);
+        if (stopped) return;
+        stopped = true;
+        abandoned.swap(tasks);
+        lock.notifyAll();
+    }
+    for (std::deque<std::pair<Task, Task> >::iterator i = abandoned.begin(); i != abandoned.end(); ++i) {
+        try {
+            i->second();
+        } catch (const std::exception& e) {
+            QPID_LOG(error, "Abandoning authentication task failed: " << e.what());
+        }
+    }
+    for (std::vector<sys::Thread>::iterator i = threads.begin(); i != threads.end(); ++i)
+        i->join();
+}
+
+void AuthWorkers::run()
+{
+    sys::Monitor::ScopedLock l(lock);
+    while (!stopped) {
+        if (tasks.empty()) {
+            lock.wait();
+        } else {
+            Task task = tasks.front().first;
+            tasks.pop_front();
+            sys::Monitor::ScopedUnlock u(lock);
+            try {
+                task();
+            } catch (const std::exception& e) {
+                QPID_LOG(error, "Authentication task failed: " << e.what());
+            }
+        }
+    }
+}
+
+}} // namespace qpid::broker
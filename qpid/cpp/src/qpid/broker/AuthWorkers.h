@@ -0,0 +1,75 @@
+#ifndef QPID_BROKER_AUTHWORKERS_H
+#define QPID_BROKER_AUTHWORKERS_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/sys/Monitor.h"
+#include "qpid/sys/Runnable.h"
+#include "qpid/sys/Thread.h"
+#include <boost/function.hpp>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace qpid {
+namespace broker {
+
+/**
+ * A bounded pool of threads that run the CPU-bound part of SASL
+ * authentication, so that a mass of clients authenticating at once does
+ * not hold up established connections on the IO threads.
+ *
+ * THREAD SAFE.
+ */
+class AuthWorkers : private sys::Runnable
+{
+  public:
+    typedef boost::function0<void> Task;
+
+    /** Start threads; at most limit tasks are queued. */
+    AuthWorkers(size_t threads, size_t limit);
+    ~AuthWorkers();
+
+    /**
+     * Queue task to run on a worker thread. If the pool is stopped before
+     * the task runs, abandon is called instead.
+     * @return false if the queue is full or the pool stopped: the caller
+     * should then do the work itself.
+     */
+    bool submit(const Task& task, const Task& abandon);
+
+    /** Stop the threads, abandoning any queued tasks. */
+    void stop();
+
+  private:
+    sys::Monitor lock;
+    std::deque<std::pair<Task, Task> > tasks;
+    std::vector<sys::Thread> threads;
+    const size_t limit;
+    bool stopped;
+
+    void run();
+};
+
+}} // namespace qpid::broker
+
+#endif  /*!QPID_BROKER_AUTHWORKERS_H*/
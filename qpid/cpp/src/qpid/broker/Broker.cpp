@@ -22,6 +22,7 @@
 #include "qpid/broker/Broker.h"
 
 #include "qpid/broker/AclModule.h"
+#include "qpid/broker/AuthWorkers.h"
 #include "qpid/broker/BrokerOptions.h"
 #include "qpid/broker/Connection.h"
 #include "qpid/broker/DirectExchange.h"
@@ -120,6 +121,8 @@ const std::string amq_fanout("amq.fanout");
 const std::string amq_match("amq.match");
 const std::string qpid_management("qpid.management");
 const std::string knownHostsNone("none");
+// Queued authentications per auth worker; beyond this, the IO thread authenticates.
+const size_t AUTH_TASKS_PER_WORKER(100);
 
 BrokerOptions::BrokerOptions(const std::string& name) :
     qpid::Options(name),
@@ -127,6 +130,8 @@ BrokerOptions::BrokerOptions(const std::string& name) :
     port(DEFAULT_PORT),
     workerThreads(5),
     connectionBacklog(10),
+    acceptSockets(1),
+    authWorkers(0),
     enableMgmt(1),
     mgmtPublish(1),
     mgmtPubInterval(10*sys::TIME_SEC),
@@ -148,6 +153,7 @@ BrokerOptions::BrokerOptions(const std::string& name) :
     timestampRcvMsgs(false),    // set the 0.10 timestamp delivery property
     linkMaintenanceInterval(2*sys::TIME_SEC),
     linkHeartbeatInterval(120*sys::TIME_SEC),
+    linkStripes(1),
     dtxDefaultTimeout(60),      // 60s
     dtxMaxTimeout(3600),        // 3600s
     maxNegotiateTime(10000)     // 10s
@@ -172,6 +178,10 @@ BrokerOptions::BrokerOptions(const std::string& name) :
         ("protocols", optValue(protocols, "<protocol name+version>"), "Which protocol versions to allow")
         ("worker-threads", optValue(workerThreads, "N"), "Sets the broker thread pool size")
         ("connection-backlog", optValue(connectionBacklog, "N"), "Sets the connection backlog limit for the server socket")
+        ("accept-sockets", optValue(acceptSockets, "N"),
+         "Number of server sockets sharing each listening port, so that connections are accepted in parallel by different IO threads")
+        ("auth-workers", optValue(authWorkers, "N"),
+         "Number of threads on which SASL authentication is computed, instead of on the IO threads (0 for none)")
         ("mgmt-enable,m", optValue(enableMgmt,"yes|no"), "Enable Management")
         ("mgmt-publish", optValue(mgmtPublish,"yes|no"), "Enable Publish of Management Data ('no' implies query-only)")
         ("mgmt-qmf2", optValue(qmf2Support,"yes|no"), "Enable broadcast of management information over QMF v2")
@@ -196,7 +206,9 @@ BrokerOptions::BrokerOptions(const std::string& name) :
          "Interval to check federation link health and re-connect if need be")
         ("link-heartbeat-interval", optValue(linkHeartbeatInterval, "SECONDS"),
          "Heartbeat interval for a federation link")
-        ("dtx-default-timeout", optValue(dtxDefaultTimeout, "SECONDS"), "Default timeout for DTX transaction before aborting it")
+        ("link-stripes", optValue(linkStripes, "N"),
+         "Number of parallel connections the routes of each federation link are spread across")
+        ("dtx-default-timeout", optValue(dtxDefaultTimeout, "SECONDS"), "Default timeout for DTX transaction before aborting it. Branches are timed out in batches, so a branch may be aborted up to 100ms after its timeout.")
         ("dtx-max-timeout", optValue(dtxMaxTimeout, "SECONDS"), "Maximum allowed timeout for DTX transaction. A value of zero disables maximum timeout limit checks and allows arbitrarily large timeout settings.")
         ("max-negotiate-time", optValue(maxNegotiateTime, "MILLISECONDS"), "Maximum time a connection can take to send the initial protocol negotiation")
         ("federation-tag", optValue(fedTag, "NAME"), "Override the federation tag")
@@ -228,6 +240,7 @@ Broker::Broker(const BrokerOptions& conf) :
                                     : 0),
     disabledListeningTransports(conf.listenDisabled.begin(), conf.listenDisabled.end()),
     store(new NullMessageStore),
+    authWorkers(conf.authWorkers ? new AuthWorkers(conf.authWorkers, conf.authWorkers*AUTH_TASKS_PER_WORKER) : 0),
     acl(0),
     dataDir(conf.noDataDir ? std::string() : conf.dataDir),
     pagingDir(!conf.pagingDir.empty() ? conf.pagingDir :
@@ -458,6 +471,11 @@ int Broker::getConnectionBacklog() const
     return config.connectionBacklog;
 }
 
+uint32_t Broker::getAcceptSockets() const
+{
+    return config.acceptSockets;
+}
+
 sys::Duration Broker::getLinkMaintenanceInterval() const
 {
     return config.linkMaintenanceInterval;
@@ -468,6 +486,11 @@ sys::Duration Broker::getLinkHeartbeatInterval() const
     return config.linkHeartbeatInterval;
 }
 
+uint32_t Broker::getLinkStripes() const
+{
+    return config.linkStripes;
+}
+
 uint32_t Broker::getDtxMaxTimeout() const
 {
     return config.dtxMaxTimeout;
@@ -549,6 +572,8 @@ Broker::~Broker() {
     if (mgmtObject != 0)
         mgmtObject->debugStats("destroying");
     shutdown();
+    if (authWorkers.get())
+        authWorkers->stop();
     finalize();                 // Finalize any plugins.
     if (config.auth)
         SaslAuthenticator::fini();
@@ -64,6 +64,7 @@ struct Url;
 namespace broker {
 
 class AclModule;
+class AuthWorkers;
 struct BrokerOptions;
 class Message;
 struct QueueSettings;
@@ -139,6 +140,7 @@ class Broker : public sys::Runnable, public Plugin::Target,
     std::set<std::string> disabledListeningTransports;
     TransportMap transportMap;
     std::auto_ptr<MessageStore> store;
+    std::auto_ptr<AuthWorkers> authWorkers;
     AclModule* acl;
     DataDir dataDir;
     DataDir pagingDir;
@@ -198,6 +200,8 @@ class Broker : public sys::Runnable, public Plugin::Target,
     MessageStore& getStore() { return *store; }
     void setAcl (AclModule* _acl) {acl = _acl;}
     AclModule* getAcl() { return acl; }
+    /** @return the pool for SASL computation, or 0 to authenticate on the IO threads */
+    AuthWorkers* getAuthWorkers() { return authWorkers.get(); }
     QueueRegistry& getQueues() { return queues; }
     ExchangeRegistry& getExchanges() { return exchanges; }
     LinkRegistry& getLinks() { return links; }
@@ -334,9 +338,11 @@ class Broker : public sys::Runnable, public Plugin::Target,
     QPID_BROKER_EXTERN uint16_t getPortOption() const;
     QPID_BROKER_EXTERN const std::vector<std::string>& getListenInterfaces() const;
     QPID_BROKER_EXTERN int getConnectionBacklog() const;
+    QPID_BROKER_EXTERN uint32_t getAcceptSockets() const;
     uint32_t getMaxNegotiateTime() const;
     sys::Duration getLinkMaintenanceInterval() const;
     QPID_BROKER_EXTERN sys::Duration getLinkHeartbeatInterval() const;
+    uint32_t getLinkStripes() const;
     uint32_t getDtxMaxTimeout() const;
     uint16_t getQueueThresholdEventRatio() const;
     uint getQueueLimit() const;
@@ -51,6 +51,8 @@ struct BrokerOptions : public qpid::Options
     std::vector<std::string> protocols;
     int workerThreads;
     int connectionBacklog;
+    uint32_t acceptSockets;     // Sockets sharing each listening port
+    uint32_t authWorkers;       // Threads for SASL computation, 0 for none
     bool enableMgmt;
     bool mgmtPublish;
     sys::Duration mgmtPubInterval;
@@ -74,6 +76,7 @@ struct BrokerOptions : public qpid::Options
     bool timestampRcvMsgs;
     sys::Duration linkMaintenanceInterval;
     sys::Duration linkHeartbeatInterval;
+    uint32_t linkStripes;       // Connections the routes of each federation link are spread across
     uint32_t dtxDefaultTimeout; // Default timeout of a DTX transaction
     uint32_t dtxMaxTimeout;     // Maximal timeout of a DTX transaction
     uint32_t maxNegotiateTime;  // Max time in ms for connection with no negotiation
@@ -23,6 +23,7 @@
 #include "qpid/broker/ConnectionHandler.h"
 
 #include "qpid/SaslFactory.h"
+#include "qpid/broker/AuthWorkers.h"
 #include "qpid/broker/Broker.h"
 #include "qpid/broker/amqp_0_10/Connection.h"
 #include "qpid/broker/SecureConnection.h"
@@ -34,12 +35,14 @@
 #include "qpid/log/Statement.h"
 #include "qpid/management/ManagementAgent.h"
 #include "qpid/sys/ConnectionOutputHandler.h"
+#include "qpid/sys/Mutex.h"
 #include "qpid/sys/SecurityLayer.h"
 #include "qpid/sys/Time.h"
 #include "qpid/broker/AclModule.h"
 #include "qpid/amqp_0_10/Codecs.h"
 #include "qmf/org/apache/qpid/broker/EventClientConnectFail.h"
 #include "qpid/Version.h"
+#include <boost/bind.hpp>
 
 using namespace qpid;
 using namespace qpid::broker;
@@ -59,6 +62,12 @@ const std::string CLIENT_PROCESS_NAME("qpid.client_process");
 const std::string CLIENT_PID("qpid.client_pid");
 const std::string CLIENT_PPID("qpid.client_ppid");
 const std::string SPACE(" ");
+
+void prepareStart(boost::shared_ptr<SaslAuthenticator> authenticator, const std::string& mechanism,
+                  bool hasResponse, const std::string& response)
+{
+    authenticator->prepareStart(mechanism, hasResponse ? &response : 0);
+}
 }
 
 void ConnectionHandler::close(connection::CloseCode code, const string& text)
@@ -129,7 +138,7 @@ ConnectionHandler::Handler::Handler(qpid::broker::amqp_0_10::Connection& c, bool
         }
         properties.setString(QPID_FED_TAG, connection.getBroker().getFederationTag());
 
-        authenticator = SaslAuthenticator::createAuthenticator(c);
+        authenticator.reset(SaslAuthenticator::createAuthenticator(c).release());
         authenticator->getMechanisms(mechanisms);
 
         Array locales(0x95);
@@ -157,12 +166,13 @@ void ConnectionHandler::Handler::startOk(const framing::FieldTable& /*clientProp
 
 void ConnectionHandler::Handler::startOk(const ConnectionStartOkBody& body)
 {
+    if (pending) throw ConnectionForcedException("Invalid protocol sequence.");
     const framing::FieldTable& clientProperties = body.getClientProperties();
     qmf::org::apache::qpid::broker::Connection::shared_ptr mgmtObject = connection.getMgmtObject();
-    types::Variant::Map properties;
-    qpid::amqp_0_10::translate(clientProperties, properties);
 
     if (mgmtObject != 0) {
+        types::Variant::Map properties;
+        qpid::amqp_0_10::translate(clientProperties, properties);
         string procName = clientProperties.getAsString(CLIENT_PROCESS_NAME);
         uint32_t pid = clientProperties.getAsInt(CLIENT_PID);
         uint32_t ppid = clientProperties.getAsInt(CLIENT_PPID);
@@ -175,29 +185,29 @@ void ConnectionHandler::Handler::startOk(const ConnectionStartOkBody& body)
         if (ppid != 0)
             mgmtObject->set_remoteParentPid(ppid);
     }
+    const string& mechanism = body.getMechanism();
+    bool hasResponse = body.hasResponse();
+    string response = hasResponse ? body.getResponse() : string();
+    if (!offload(boost::bind(&prepareStart, authenticator, mechanism, hasResponse, response),
+                 boost::bind(&Handler::completeStartOk, this, mechanism, hasResponse, response,
+                             clientProperties)))
+        completeStartOk(mechanism, hasResponse, response, clientProperties);
+}
+
+void ConnectionHandler::Handler::completeStartOk(const string& mechanism, bool hasResponse,
+                                                 const string& response,
+                                                 const framing::FieldTable& clientProperties)
+{
+    pending.reset();
     try {
-        authenticator->start(body.getMechanism(), body.hasResponse() ? &body.getResponse() : 0);
+        authenticator->start(mechanism, hasResponse ? &response : 0);
     } catch (std::exception& /*e*/) {
-        management::ManagementAgent* agent = connection.getAgent();
-        bool logEnabled;
-        QPID_LOG_TEST_CAT(debug, model, logEnabled);
-        if (logEnabled || agent)
-        {
-            string error;
-            string uid;
-            authenticator->getError(error);
-            authenticator->getUid(uid);
-            if (agent && mgmtObject) {
-                agent->raiseEvent(_qmf::EventClientConnectFail(connection.getMgmtId(), uid, error,
-                                                               mgmtObject->get_remoteProperties()));
-            }
-            QPID_LOG_CAT(debug, model, "Failed connection. rhost:" << connection.getMgmtId()
-                << " user:" << uid
-                << " reason:" << error );
-        }
+        authenticationFailed();
         throw;
     }
 
+    types::Variant::Map properties;
+    qpid::amqp_0_10::translate(clientProperties, properties);
     connection.setClientProperties(properties);
     if (clientProperties.isSet(QPID_FED_TAG)) {
         connection.setFederationPeerTag(clientProperties.getAsString(QPID_FED_TAG));
@@ -206,30 +216,118 @@ void ConnectionHandler::Handler::startOk(const ConnectionStartOkBody& body)
 
 void ConnectionHandler::Handler::secureOk(const string& response)
 {
+    if (pending) throw ConnectionForcedException("Invalid protocol sequence.");
+    if (!offload(boost::bind(&SaslAuthenticator::prepareStep, authenticator, response),
+                 boost::bind(&Handler::completeSecureOk, this, response)))
+        completeSecureOk(response);
+}
+
+void ConnectionHandler::Handler::completeSecureOk(const string& response)
+{
+    pending.reset();
     try {
         authenticator->step(response);
     } catch (std::exception& /*e*/) {
-        management::ManagementAgent* agent = connection.getAgent();
-        bool logEnabled;
-        QPID_LOG_TEST_CAT(debug, model, logEnabled);
-        if (logEnabled || agent)
-        {
-            string error;
-            string uid;
-            authenticator->getError(error);
-            authenticator->getUid(uid);
-            if (agent && connection.getMgmtObject()) {
-                agent->raiseEvent(_qmf::EventClientConnectFail(connection.getMgmtId(), uid, error,
-                                                               connection.getMgmtObject()->get_remoteProperties()));
-            }
-            QPID_LOG_CAT(debug, model, "Failed connection. rhost:" << connection.getMgmtId()
-                << " user:" << uid
-                << " reason:" << error );
-        }
+        authenticationFailed();
         throw;
     }
 }
 
+void ConnectionHandler::Handler::failAuthentication(const string& reason)
+{
+    pending.reset();
+    authenticationFailed();
+    throw ConnectionForcedException(reason);
+}
+
+void ConnectionHandler::Handler::authenticationFailed()
+{
+    management::ManagementAgent* agent = connection.getAgent();
+    bool logEnabled;
+    QPID_LOG_TEST_CAT(debug, model, logEnabled);
+    if (logEnabled || agent)
+    {
+        string error;
+        string uid;
+        authenticator->getError(error);
+        authenticator->getUid(uid);
+        if (agent && connection.getMgmtObject()) {
+            agent->raiseEvent(_qmf::EventClientConnectFail(connection.getMgmtId(), uid, error,
+                                                           connection.getMgmtObject()->get_remoteProperties()));
+        }
+        QPID_LOG_CAT(debug, model, "Failed connection. rhost:" << connection.getMgmtId()
+            << " user:" << uid
+            << " reason:" << error );
+    }
+}
+
+/**
+ * Runs an authentication step on an AuthWorkers thread, then hands the
+ * completion back to the connection's IO thread unless the connection
+ * has gone away in the meantime.
+ */
+class ConnectionHandler::Handler::PendingAuthentication
+{
+  public:
+    typedef boost::function1<void, std::string> Failure;
+
+    PendingAuthentication(amqp_0_10::Connection& c) : connection(&c) {}
+
+    void run(const boost::function0<void>& prepare, const boost::function0<void>& complete,
+             const Failure& fail)
+    {
+        try {
+            prepare();
+        } catch (const std::exception& e) {
+            // The SASL connection may have moved on, so the step can't be redone.
+            QPID_LOG(warning, "SASL: Offloaded authentication step failed: " << e.what());
+            post(boost::bind(fail, std::string("Authentication failed")));
+            return;
+        }
+        post(complete);
+    }
+
+    void abandon(const Failure& fail)
+    {
+        post(boost::bind(fail, std::string("Authentication abandoned, broker shutting down")));
+    }
+
+    void cancel()
+    {
+        sys::Mutex::ScopedLock l(lock);
+        connection = 0;
+    }
+
+  private:
+    sys::Mutex lock;
+    amqp_0_10::Connection* connection;
+
+    void post(const boost::function0<void>& callback)
+    {
+        sys::Mutex::ScopedLock l(lock);
+        if (connection) connection->requestHandshakeProcessing(callback);
+    }
+};
+
+bool ConnectionHandler::Handler::offload(const boost::function0<void>& prepare,
+                                         const boost::function0<void>& complete)
+{
+    AuthWorkers* workers = connection.getBroker().getAuthWorkers();
+    if (!workers || !authenticator->isOffloadable()) return false;
+    pending.reset(new PendingAuthentication(connection));
+    PendingAuthentication::Failure fail(boost::bind(&Handler::failAuthentication, this, _1));
+    if (workers->submit(boost::bind(&PendingAuthentication::run, pending, prepare, complete, fail),
+                        boost::bind(&PendingAuthentication::abandon, pending, fail)))
+        return true;
+    pending.reset();            // Pool is busy, authenticate inline.
+    return false;
+}
+
+void ConnectionHandler::Handler::cancelAuthentication()
+{
+    if (pending) pending->cancel();
+}
+
 void ConnectionHandler::Handler::tuneOk(uint16_t /*channelmax*/,
     uint16_t framemax, uint16_t heartbeat)
 {
@@ -37,6 +37,8 @@
 #include "qpid/Exception.h"
 #include "qpid/sys/SecurityLayer.h"
 #include "qpid/broker/System.h"
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 
 
 
@@ -61,9 +63,12 @@ class ConnectionHandler : public framing::FrameHandler
         framing::AMQP_AllProxy::Connection proxy;
         amqp_0_10::Connection& connection;
         bool serverMode;
-        std::auto_ptr<SaslAuthenticator> authenticator;
+        boost::shared_ptr<SaslAuthenticator> authenticator;
         SecureConnection* secured;
         bool isOpen;
+        // Set while an AuthWorkers thread is preparing an authentication step.
+        class PendingAuthentication;
+        boost::shared_ptr<PendingAuthentication> pending;
 
         Handler(amqp_0_10::Connection& connection, bool isClient);
         ~Handler();
@@ -72,6 +77,15 @@ class ConnectionHandler : public framing::FrameHandler
                      const std::string& mechanism, const std::string& response,
                      const std::string& locale);
         void secureOk(const std::string& response);
+        void completeStartOk(const std::string& mechanism, bool hasResponse,
+                             const std::string& response,
+                             const framing::FieldTable& clientProperties);
+        void completeSecureOk(const std::string& response);
+        bool offload(const boost::function0<void>& prepare,
+                     const boost::function0<void>& complete);
+        void failAuthentication(const std::string& reason);
+        void authenticationFailed();
+        void cancelAuthentication();
         void tuneOk(uint16_t channelMax, uint16_t frameMax, uint16_t heartbeat);
         void heartbeat();
         void open(const std::string& virtualHost,
@@ -103,6 +117,7 @@ class ConnectionHandler : public framing::FrameHandler
 
     bool handle(const qpid::framing::AMQMethodBody& method);
     void close(framing::connection::CloseCode code, const std::string& text);
+    void cancelAuthentication() { handler->cancelAuthentication(); }
   public:
     ConnectionHandler(amqp_0_10::Connection& connection, bool isClient );
     void heartbeat();
@@ -19,6 +19,7 @@
  *
  */
 #include "qpid/broker/Credit.h"
+#include <algorithm>
 
 namespace qpid {
 namespace broker {
@@ -39,7 +40,9 @@ void CreditBalance::grant(uint32_t value)
         }
     }
 }
-void CreditBalance::consume(uint32_t value) { if (!unlimited()) balance -= value; }
+// Deliveries that bypass the credit check, like HA events, may take more
+// than is left: don't wrap round to (almost) unlimited credit.
+void CreditBalance::consume(uint32_t value) { if (!unlimited()) balance -= std::min(balance, value); }
 bool CreditBalance::check(uint32_t required) const { return balance >= required; }
 uint32_t CreditBalance::remaining() const { return balance; }
 uint32_t CreditBalance::allocated() const { return balance; }
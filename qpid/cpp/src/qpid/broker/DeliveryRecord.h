@@ -32,6 +32,7 @@
 #include "qpid/broker/QueueCursor.h"
 #include "qpid/broker/DeliveryId.h"
 #include "qpid/broker/Message.h"
+#include "qpid/sys/Time.h"
 
 namespace qpid {
 namespace broker {
@@ -69,6 +70,7 @@ class DeliveryRecord
     uint32_t credit;
     framing::SequenceNumber msgId;
     framing::SequenceNumber replicationId;
+    sys::AbsTime deliveryTime;  // Only set when accept latency is sampled
 
   public:
     QPID_BROKER_EXTERN DeliveryRecord(const QueueCursor& msgCursor,
@@ -108,6 +110,8 @@ class DeliveryRecord
     const std::string& getTag() const { return tag; }
 
     void setId(DeliveryId _id) { id = _id; }
+    void setDeliveryTime(const sys::AbsTime& t) { deliveryTime = t; }
+    const sys::AbsTime& getDeliveryTime() const { return deliveryTime; }
 
     typedef std::deque<DeliveryRecord> DeliveryRecords;
     static AckRange findRange(DeliveryRecords& records, DeliveryId first, DeliveryId last);
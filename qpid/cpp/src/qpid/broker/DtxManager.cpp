@@ -24,17 +24,16 @@
 #include "qpid/framing/StructHelper.h"
 #include "qpid/log/Statement.h"
 #include "qpid/sys/Timer.h"
-#include "qpid/ptr_map.h"
 
 #include <boost/format.hpp>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 using boost::intrusive_ptr;
 using qpid::sys::Mutex;
-using qpid::ptr_map_ptr;
 using namespace qpid::broker;
 using namespace qpid::framing;
 
@@ -71,7 +70,19 @@ DtxManager::DtxManager(qpid::sys::Timer& t, uint32_t _dtxDefaultTimeout) :
 {
 }
 
-DtxManager::~DtxManager() {}
+DtxManager::~DtxManager()
+{
+    for (size_t i = 0; i < SHARDS; ++i) {
+        for (WorkMap::iterator j = shards[i].work.begin(); j != shards[i].work.end(); ++j) {
+            delete j->second;
+        }
+    }
+}
+
+DtxManager::Shard& DtxManager::shard(const std::string& xid)
+{
+    return shards[WorkMap::hasher()(xid) % SHARDS];
+}
 
 void DtxManager::start(const std::string& xid, boost::intrusive_ptr<DtxBuffer> ops)
 {
@@ -126,44 +137,53 @@ void DtxManager::rollback(const std::string& xid)
 
 DtxWorkRecord* DtxManager::getWork(const std::string& xid)
 {
-    Mutex::ScopedLock locker(lock);
-    WorkMap::iterator i = work.find(xid);
-    if (i == work.end()) {
+    Shard& s = shard(xid);
+    Mutex::ScopedLock locker(s.lock);
+    WorkMap::iterator i = s.work.find(xid);
+    if (i == s.work.end()) {
         throw NotFoundException(QPID_MSG("Unrecognised xid " << convert(xid)));
     }
-    return ptr_map_ptr(i);
+    return i->second;
 }
 
 bool DtxManager::exists(const std::string& xid) {
-    Mutex::ScopedLock locker(lock);
-    return  work.find(xid) != work.end();
+    Shard& s = shard(xid);
+    Mutex::ScopedLock locker(s.lock);
+    return  s.work.find(xid) != s.work.end();
 }
 
 void DtxManager::remove(const std::string& xid)
 {
-    Mutex::ScopedLock locker(lock);
-    WorkMap::iterator i = work.find(xid);
-    if (i == work.end()) {
-        throw NotFoundException(QPID_MSG("Unrecognised xid " << convert(xid)));
-    } else {
-        work.erase(i);
+    DtxWorkRecord* record;
+    {
+        Shard& s = shard(xid);
+        Mutex::ScopedLock locker(s.lock);
+        WorkMap::iterator i = s.work.find(xid);
+        if (i == s.work.end()) {
+            throw NotFoundException(QPID_MSG("Unrecognised xid " << convert(xid)));
+        }
+        record = i->second;
+        s.work.erase(i);
     }
+    delete record;
 }
 
 DtxWorkRecord* DtxManager::createWork(const std::string& xid)
 {
-    Mutex::ScopedLock locker(lock);
-    WorkMap::iterator i = work.find(xid);
-    if (i != work.end()) {
-        throw NotAllowedException(QPID_MSG("Xid " << convert(xid) << " is already known (use 'join' to add work to an existing xid)"));
-    } else {
-        std::string ncxid = xid; // Work around const correctness problems with work.insert
-        DtxWorkRecord* dtxWorkRecord = new DtxWorkRecord(xid, store);
-        work.insert(ncxid, dtxWorkRecord);
-        if (dtxDefaultTimeout>0)
-            setTimeout(xid, dtxDefaultTimeout);
-        return dtxWorkRecord;
+    DtxWorkRecord* dtxWorkRecord;
+    {
+        Shard& s = shard(xid);
+        Mutex::ScopedLock locker(s.lock);
+        WorkMap::iterator i = s.work.find(xid);
+        if (i != s.work.end()) {
+            throw NotAllowedException(QPID_MSG("Xid " << convert(xid) << " is already known (use 'join' to add work to an existing xid)"));
+        }
+        dtxWorkRecord = new DtxWorkRecord(xid, store);
+        s.work[xid] = dtxWorkRecord;
     }
+    if (dtxDefaultTimeout>0)
+        setTimeout(xid, dtxDefaultTimeout);
+    return dtxWorkRecord;
 }
 
 void DtxManager::setTimeout(const std::string& xid, uint32_t secs)
@@ -172,11 +192,23 @@ void DtxManager::setTimeout(const std::string& xid, uint32_t secs)
     intrusive_ptr<DtxTimeout> timeout = record->getTimeout();
     if (timeout.get()) {
         if (timeout->timeout == secs) return;//no need to do anything further if timeout hasn't changed
-        timeout->cancel();
+        timeout->remove(record->getId());
     }
-    timeout = intrusive_ptr<DtxTimeout>(new DtxTimeout(secs, *this, xid));
-    record->setTimeout(timeout);
-    timer->add(timeout);
+    Mutex::ScopedLock locker(timeoutLock);
+    // Closed batches stay with the timer until they fire, but are no use
+    // here: drop them so the map only holds batches opened in the last
+    // window, however many different timeouts are used.
+    for (Timeouts::iterator i = timeouts.begin(); i != timeouts.end();) {
+        if (i->second->isOpen()) ++i;
+        else timeouts.erase(i++);
+    }
+    intrusive_ptr<DtxTimeout>& batch = timeouts[secs];
+    if (!batch || !batch->add(xid, record->getId())) {
+        batch = intrusive_ptr<DtxTimeout>(new DtxTimeout(secs, *this));
+        batch->add(xid, record->getId());
+        timer->add(batch);
+    }
+    record->setTimeout(batch);
 }
 
 uint32_t DtxManager::getTimeout(const std::string& xid)
@@ -185,16 +217,28 @@ uint32_t DtxManager::getTimeout(const std::string& xid)
     return !timeout ? 0 : timeout->timeout;
 }
 
-void DtxManager::timedout(const std::string& xid)
+void DtxManager::timedout(const DtxTimeout::Branches& branches)
 {
-    Mutex::ScopedLock locker(lock);
-    WorkMap::iterator i = work.find(xid);
-    if (i == work.end()) {
-        QPID_LOG(warning, "Transaction timeout failed: no record for xid");
-    } else {
-        ptr_map_ptr(i)->timedout();
-        //TODO: do we want to have a timed task to cleanup, or can we rely on an explicit completion?
-        //timer->add(new DtxCleanup(60*30/*30 mins*/, boost::bind(&DtxManager::remove, this, xid)));
+    // Expire the batch one shard at a time, taking each shard lock once.
+    typedef std::vector<std::pair<size_t, DtxTimeout::Branches::value_type> > Batch;
+    Batch batch;
+    batch.reserve(branches.size());
+    for (DtxTimeout::Branches::const_iterator i = branches.begin(); i != branches.end(); ++i) {
+        batch.push_back(std::make_pair(WorkMap::hasher()(i->first) % SHARDS, *i));
+    }
+    std::sort(batch.begin(), batch.end());
+    for (Batch::const_iterator i = batch.begin(); i != batch.end();) {
+        const size_t index = i->first;
+        Mutex::ScopedLock locker(shards[index].lock);
+        for (; i != batch.end() && i->first == index; ++i) {
+            WorkMap::iterator j = shards[index].work.find(i->second.first);
+            if (j == shards[index].work.end()) {
+                QPID_LOG(warning, "Transaction timeout failed: no record for xid");
+            } else if (j->second->getId() == i->second.second) {
+                j->second->timedout();
+            }
+            // Otherwise the xid was re-created since, the new branch has its own timeout.
+        }
     }
 }
 
@@ -22,12 +22,16 @@
 #define _DtxManager_
 
 #include "qpid/broker/DtxBuffer.h"
+#include "qpid/broker/DtxTimeout.h"
 #include "qpid/broker/DtxWorkRecord.h"
 #include "qpid/broker/TransactionalStore.h"
 #include "qpid/framing/amqp_types.h"
 #include "qpid/framing/Xid.h"
 #include "qpid/sys/Mutex.h"
-#include "qpid/ptr_map.h"
+#include "qpid/sys/unordered_map.h"
+#include <map>
+#include <vector>
+#include <boost/intrusive_ptr.hpp>
 
 namespace qpid {
 namespace sys {
@@ -36,15 +40,34 @@ class Timer;
 
 namespace broker {
 
+/**
+ * Tracks the work records of all known distributed transaction branches.
+ *
+ * Branches are identified by their encoded xid (see convert) and spread
+ * over a fixed number of shards, each with its own lock, so operations on
+ * unrelated branches do not contend. Branch timeouts are batched: branches
+ * given the same timeout within 100ms share one timer task, and are expired
+ * together with one lock per shard. A branch may so expire up to 100ms
+ * after its timeout, never before.
+ */
 class DtxManager{
-    typedef boost::ptr_map<std::string, DtxWorkRecord> WorkMap;
+    typedef qpid::sys::unordered_map<std::string, DtxWorkRecord*> WorkMap;
+    typedef std::map<uint32_t, boost::intrusive_ptr<DtxTimeout> > Timeouts;
+
+    struct Shard {
+        qpid::sys::Mutex lock;
+        WorkMap work;
+    };
+    static const size_t SHARDS = 32;
 
-    WorkMap work;
+    Shard shards[SHARDS];
     TransactionalStore* store;
-    qpid::sys::Mutex lock;
     qpid::sys::Timer* timer;
     uint32_t dtxDefaultTimeout;
+    qpid::sys::Mutex timeoutLock;
+    Timeouts timeouts;          // Open batch for each timeout value.
 
+    Shard& shard(const std::string& xid);
     void remove(const std::string& xid);
     DtxWorkRecord* createWork(const std::string& xid);
 
@@ -59,7 +82,7 @@ public:
     void rollback(const std::string& xid);
     void setTimeout(const std::string& xid, uint32_t secs);
     uint32_t getTimeout(const std::string& xid);
-    void timedout(const std::string& xid);
+    void timedout(const DtxTimeout::Branches& branches);
     void setStore(TransactionalStore* store);
     void setTimer(sys::Timer& t) { timer = &t; }
 
@@ -25,13 +25,49 @@
 
 using namespace qpid::broker;
 
-DtxTimeout::DtxTimeout(uint32_t _timeout, DtxManager& _mgr, const std::string& _xid) 
-    : TimerTask(qpid::sys::Duration(_timeout * qpid::sys::TIME_SEC),"DtxTimeout-"+_xid), timeout(_timeout), mgr(_mgr), xid(_xid)
+namespace {
+// Branches given the same timeout within this window share a timer task.
+const qpid::sys::Duration BATCH_WINDOW(100*qpid::sys::TIME_MSEC);
+}
+
+DtxTimeout::DtxTimeout(uint32_t _timeout, DtxManager& _mgr)
+    : TimerTask(qpid::sys::Duration(_timeout * qpid::sys::TIME_SEC + BATCH_WINDOW), "DtxTimeout"),
+      timeout(_timeout), mgr(_mgr), opened(qpid::sys::AbsTime::now()), fired(false)
+{
+}
+
+bool DtxTimeout::add(const std::string& xid, uint64_t id)
+{
+    qpid::sys::Mutex::ScopedLock l(lock);
+    if (fired || qpid::sys::Duration(opened, qpid::sys::AbsTime::now()) > BATCH_WINDOW) return false;
+    branches[id] = xid;
+    return true;
+}
+
+bool DtxTimeout::isOpen()
+{
+    qpid::sys::Mutex::ScopedLock l(lock);
+    return !fired && qpid::sys::Duration(opened, qpid::sys::AbsTime::now()) <= BATCH_WINDOW;
+}
+
+void DtxTimeout::remove(uint64_t id)
 {
+    qpid::sys::Mutex::ScopedLock l(lock);
+    branches.erase(id);
 }
 
 void DtxTimeout::fire()
 {
-    QPID_LOG(debug, "DTX transaction timeouted, XID=" << xid << ", timeout=" << timeout);
-    mgr.timedout(xid);
+    Branches expired;
+    {
+        qpid::sys::Mutex::ScopedLock l(lock);
+        fired = true;
+        expired.reserve(branches.size());
+        for (std::map<uint64_t, std::string>::const_iterator i = branches.begin(); i != branches.end(); ++i)
+            expired.push_back(std::make_pair(i->second, i->first));
+        branches.clear();
+    }
+    if (expired.empty()) return;
+    QPID_LOG(debug, "DTX transactions timed out, count=" << expired.size() << ", timeout=" << timeout);
+    mgr.timedout(expired);
 }
@@ -22,7 +22,12 @@
 #define _DtxTimeout_
 
 #include "qpid/Exception.h"
+#include "qpid/sys/Mutex.h"
 #include "qpid/sys/Timer.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace qpid {
 namespace broker {
@@ -33,14 +38,36 @@ struct DtxTimeoutException : public Exception {
     DtxTimeoutException(const std::string& msg=std::string()) : Exception(msg) {}
 };
 
+/**
+ * Times out a batch of branches that were given the same timeout within
+ * a short window of each other. The task is scheduled for the end of the
+ * window plus the timeout, so no branch expires early.
+ *
+ * Branches are held by the id of their work record rather than by xid:
+ * an xid may be re-created and join the batch before the record it
+ * replaces is destroyed, and only that record's entry must go.
+ */
 struct DtxTimeout : public sys::TimerTask
 {
+    /** xid and work record id of each branch. */
+    typedef std::vector<std::pair<std::string, uint64_t> > Branches;
+
     const uint32_t timeout;
     DtxManager& mgr;
-    const std::string xid;
 
-    DtxTimeout(uint32_t timeout, DtxManager& mgr, const std::string& xid);
+    DtxTimeout(uint32_t timeout, DtxManager& mgr);
+    /** @return false if the batch is no longer accepting branches. */
+    bool add(const std::string& xid, uint64_t id);
+    /** @return true if the batch may still accept branches. */
+    bool isOpen();
+    void remove(uint64_t id);
     void fire();
+
+  private:
+    const sys::AbsTime opened;
+    sys::Mutex lock;
+    std::map<uint64_t, std::string> branches;
+    bool fired;
 };
 
 }
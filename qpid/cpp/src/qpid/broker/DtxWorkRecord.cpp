@@ -22,6 +22,7 @@
 #include "qpid/broker/DtxManager.h"
 #include "qpid/broker/DtxTimeout.h"
 #include "qpid/framing/reply_exceptions.h"
+#include "qpid/sys/AtomicValue.h"
 #include "qpid/sys/Timer.h"
 
 #include <boost/format.hpp>
@@ -32,13 +33,17 @@ using qpid::sys::Mutex;
 using namespace qpid::broker;
 using namespace qpid::framing;
 
+namespace {
+qpid::sys::AtomicValue<uint64_t> lastId;
+}
+
 DtxWorkRecord::DtxWorkRecord(const std::string& _xid, TransactionalStore* const _store) :
-    xid(_xid), store(_store), completed(false), rolledback(false), prepared(false), expired(false) {}
+    xid(_xid), id(++lastId), store(_store), completed(false), rolledback(false), prepared(false), expired(false) {}
 
 DtxWorkRecord::~DtxWorkRecord()
 {
     if (timeout.get()) {
-        timeout->cancel();
+        timeout->remove(id);
     }
 }
 
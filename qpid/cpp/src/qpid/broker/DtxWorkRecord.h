@@ -26,6 +26,7 @@
 #include "qpid/broker/TransactionalStore.h"
 
 #include "qpid/framing/amqp_types.h"
+#include "qpid/sys/IntegerTypes.h"
 #include "qpid/sys/Mutex.h"
 
 #include <algorithm>
@@ -49,6 +50,7 @@ class DtxWorkRecord
     typedef std::vector<boost::intrusive_ptr<DtxBuffer> >Work;
 
     const std::string xid;
+    const uint64_t id;          // Unique to this record, the xid may be reused.
     TransactionalStore* const store;
     bool completed;
     bool rolledback;
@@ -75,6 +77,7 @@ public:
     void setTimeout(boost::intrusive_ptr<DtxTimeout> t);
     boost::intrusive_ptr<DtxTimeout> getTimeout();
     std::string getXid() const { return xid; }
+    uint64_t getId() const { return id; }
     bool isCompleted() const { return completed; }
     bool isRolledback() const { return rolledback; }
     bool isPrepared() const { return prepared; }
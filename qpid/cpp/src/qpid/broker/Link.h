@@ -164,6 +164,7 @@ class Link : public PersistableConfig, public management::Manageable {
     std::string getAuthMechanism() { return authMechanism; }
     std::string getUsername()      { return username; }
     std::string getPassword()      { return password; }
+    bool isFailover() const        { return failover; }
     Broker* getBroker()       { return broker; }
 
     bool isConnecting() const { return state == STATE_CONNECTING; }
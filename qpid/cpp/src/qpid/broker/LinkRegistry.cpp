@@ -39,6 +39,15 @@ using boost::format;
 using boost::str;
 namespace _qmf = qmf::org::apache::qpid::broker;
 
+const std::string LinkRegistry::STRIPE_SEPARATOR(".stripe-");
+
+bool LinkRegistry::isStripeOf(const std::string& stripe, const std::string& link)
+{
+    return stripe.size() > link.size() + STRIPE_SEPARATOR.size()
+        && stripe.compare(0, link.size(), link) == 0
+        && stripe.compare(link.size(), STRIPE_SEPARATOR.size(), STRIPE_SEPARATOR) == 0;
+}
+
 // TODO: This constructor is only used by the store unit tests -
 // That probably indicates that LinkRegistry isn't correctly
 // factored: The persistence element should be factored separately
@@ -124,7 +133,19 @@ pair<Link::shared_ptr, bool> LinkRegistry::declare(const string& name,
 
 {
     Mutex::ScopedLock   locker(lock);
+    return declareLH(name, host, port, transport, durable, authMechanism, username, password, failover);
+}
 
+pair<Link::shared_ptr, bool> LinkRegistry::declareLH(const string& name,
+                                                     const string&  host,
+                                                     uint16_t port,
+                                                     const string&  transport,
+                                                     bool     durable,
+                                                     const string&  authMechanism,
+                                                     const string&  username,
+                                                     const string&  password,
+                                                     bool failover)
+{
     LinkMap::iterator i = links.find(name);
     if (i == links.end())
     {
@@ -155,7 +176,8 @@ Bridge::shared_ptr LinkRegistry::getBridge(const Link&  link,
     for (BridgeMap::iterator i = bridges.begin(); i != bridges.end(); ++i) {
         if (i->second->getSrc() == src && i->second->getDest() == dest &&
             i->second->getKey() == key && i->second->getLink() &&
-            i->second->getLink()->getName() == link.getName()) {
+            (i->second->getLink()->getName() == link.getName() ||
+             isStripeOf(i->second->getLink()->getName(), link.getName()))) {
             return i->second;
         }
     }
@@ -213,6 +235,9 @@ pair<Bridge::shared_ptr, bool> LinkRegistry::declare(const std::string& name,
     BridgeMap::iterator b = bridges.find(name);
     if (b == bridges.end())
     {
+        // Routes with their own initializer are not ordinary federation
+        // routes (e.g. HA replication) and stay on the link they are declared on.
+        Link& target = init ? link : stripeLH(link);
         _qmf::ArgsLinkBridge args;
         Bridge::shared_ptr bridge;
 
@@ -229,15 +254,15 @@ pair<Bridge::shared_ptr, bool> LinkRegistry::declare(const std::string& name,
         args.i_credit     = credit;
 
         bridge = Bridge::shared_ptr
-          (new Bridge (name, &link, link.nextChannel(),
+          (new Bridge (name, &target, target.nextChannel(),
                        boost::bind(&LinkRegistry::destroyBridge, this, _1),
                        args, init, queueName, altExchange));
         bridges[name] = bridge;
-        link.add(bridge);
+        target.add(bridge);
         if (durable && store && !broker->inRecovery())
             store->create(*bridge);
 
-        QPID_LOG(debug, "Bridge '" << name <<"' declared on link '" << link.getName() <<
+        QPID_LOG(debug, "Bridge '" << name <<"' declared on link '" << target.getName() <<
                  "' from " << src << " to " << dest << " (" << key << ")");
 
         return std::pair<Bridge::shared_ptr, bool>(bridge, true);
@@ -245,19 +270,63 @@ pair<Bridge::shared_ptr, bool> LinkRegistry::declare(const std::string& name,
     return std::pair<Bridge::shared_ptr, bool>(b->second, false);
 }
 
+/**
+ * Spread new routes over the link and its stripes: a route goes on
+ * whichever has fewest routes, creating the next stripe if all the
+ * existing ones have some. Routes recovered from the store, or declared
+ * directly on a stripe, stay where they are.
+ */
+Link& LinkRegistry::stripeLH(Link& link)
+{
+    const uint32_t stripes = broker ? broker->getLinkStripes() : 1;
+    if (stripes <= 1 || broker->inRecovery() ||
+        link.getName().find(STRIPE_SEPARATOR) != std::string::npos)
+        return link;
+
+    std::map<std::string, size_t> routes;
+    for (BridgeMap::iterator b = bridges.begin(); b != bridges.end(); ++b) {
+        if (b->second->getLink()) ++routes[b->second->getLink()->getName()];
+    }
+    Link* chosen = &link;
+    size_t fewest = routes[link.getName()];
+    for (uint32_t i = 1; i < stripes && fewest; ++i) {
+        std::string name = str(format("%1%%2%%3%") % link.getName() % STRIPE_SEPARATOR % i);
+        Link::shared_ptr stripe = declareLH(name, link.getHost(), link.getPort(), link.getTransport(),
+                                            link.isDurable(), link.getAuthMechanism(),
+                                            link.getUsername(), link.getPassword(),
+                                            link.isFailover()).first;
+        if (routes[name] < fewest) {
+            chosen = stripe.get();
+            fewest = routes[name];
+        }
+    }
+    return *chosen;
+}
+
 /** called back by the link when it has completed its cleanup and can be removed. */
 void LinkRegistry::linkDestroyed(Link *link)
 {
-    QPID_LOG(debug, "LinkRegistry::destroy(); link= " << link->getName());
-    Mutex::ScopedLock   locker(lock);
-
-    pendingLinks.erase(link->getName());
-    LinkMap::iterator i = links.find(link->getName());
-    if (i != links.end())
+    const std::string name = link->getName();
+    QPID_LOG(debug, "LinkRegistry::destroy(); link= " << name);
+    std::vector<Link::shared_ptr> stripes;
     {
-        if (i->second->isDurable() && store)
-            store->destroy(*(i->second));
-        links.erase(i);
+        Mutex::ScopedLock   locker(lock);
+
+        pendingLinks.erase(name);
+        LinkMap::iterator i = links.find(name);
+        if (i != links.end())
+        {
+            if (i->second->isDurable() && store)
+                store->destroy(*(i->second));
+            links.erase(i);
+        }
+        for (i = links.lower_bound(name); i != links.end() && i->first.compare(0, name.size(), name) == 0; ++i) {
+            if (isStripeOf(i->first, name)) stripes.push_back(i->second);
+        }
+    }
+    // Close stripes outside the lock, they call back here when destroyed.
+    for (std::vector<Link::shared_ptr>::iterator i = stripes.begin(); i != stripes.end(); ++i) {
+        (*i)->close();
     }
 }
 
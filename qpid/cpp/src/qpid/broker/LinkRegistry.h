@@ -70,6 +70,19 @@ namespace amqp_0_10 {
         /** Request to destroy a Bridge */
         void destroyBridge(Bridge*);
 
+        std::pair<boost::shared_ptr<Link>, bool>
+        declareLH(const std::string& name,
+                  const std::string& host,
+                  uint16_t     port,
+                  const std::string& transport,
+                  bool         durable,
+                  const std::string& authMechanism,
+                  const std::string& username,
+                  const std::string& password,
+                  bool failover);
+        /** Choose the link a new route declared on link should use */
+        Link& stripeLH(Link& link);
+
     public:
         QPID_BROKER_EXTERN LinkRegistry (); // Only used in store tests
         QPID_BROKER_EXTERN LinkRegistry (Broker* _broker);
@@ -116,6 +129,17 @@ namespace amqp_0_10 {
         );
         QPID_BROKER_EXTERN static const uint32_t INFINITE_CREDIT = 0xFFFFFFFF;
 
+        /**
+         * With --link-stripes N the routes declared on a link are
+         * spread across the link and N-1 stripe links to the same
+         * broker, each with its own connection, so that routes are not
+         * all limited by the throughput of one connection. Stripe
+         * links are named for their link with this separator and an
+         * index, share its durability, and are closed with it.
+         */
+        QPID_BROKER_EXTERN static const std::string STRIPE_SEPARATOR;
+        QPID_BROKER_EXTERN static bool isStripeOf(const std::string& stripe, const std::string& link);
+
         /** determine if Bridge exists */
         QPID_BROKER_EXTERN Bridge::shared_ptr
           getBridge(const std::string&  name);
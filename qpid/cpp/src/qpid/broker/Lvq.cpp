@@ -61,4 +61,11 @@ void Lvq::push(Message& message, bool isRecovery)
             dequeueFromStore(old.getPersistentContext());//do outside of lock
     }
 }
+
+void Lvq::pushBatch(std::vector<Message>& msgs)
+{
+    for (std::vector<Message>::iterator i = msgs.begin(); i != msgs.end(); ++i) {
+        push(*i);
+    }
+}
 }} // namespace qpid::broker
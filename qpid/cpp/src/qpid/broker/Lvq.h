@@ -37,6 +37,7 @@ class Lvq : public virtual Queue
   public:
     Lvq(const std::string&, std::auto_ptr<MessageMap>, const QueueSettings&, MessageStore* const, management::Manageable*, Broker*);
     void push(Message& msg, bool isRecovery=false);
+    void pushBatch(std::vector<Message>& msgs);
   private:
     MessageMap& messageMap;
 };
@@ -28,6 +28,7 @@
 #include "qpid/management/ManagementObject.h"
 #include "qpid/management/Manageable.h"
 #include "qpid/StringUtils.h"
+#include "qpid/sys/Mutex.h"
 #include "qpid/log/Statement.h"
 #include "qpid/assert.h"
 
@@ -237,6 +238,16 @@ Message::SharedState& Message::getSharedState()
 {
     return *sharedState;
 }
+intrusive_ptr<const RefCounted> Message::getTranslation(const std::string& protocol) const
+{
+    return sharedState->getTranslation(protocol);
+}
+
+intrusive_ptr<const RefCounted> Message::setTranslation(const std::string& protocol, intrusive_ptr<const RefCounted> translation) const
+{
+    return sharedState->setTranslation(protocol, translation);
+}
+
 const Message::Encoding& Message::getEncoding() const
 {
     return *sharedState;
@@ -331,6 +342,8 @@ sys::AbsTime Message::getExpiration() const
 
 Message::SharedStateImpl::SharedStateImpl() : publisher(0), expiration(qpid::sys::FAR_FUTURE), isManagementMessage(false) {}
 
+Message::SharedStateImpl::~SharedStateImpl() {}
+
 const Connection* Message::SharedStateImpl::getPublisher() const
 {
     return publisher;
@@ -378,4 +391,35 @@ void Message::SharedStateImpl::setIsManagementMessage(bool b)
     isManagementMessage = b;
 }
 
+namespace {
+// Translations are rare and brief, so rather than a lock per message a
+// message's translations are guarded by one of a fixed set of locks
+// chosen by address.
+const size_t TRANSLATION_LOCKS = 31;
+sys::Mutex translationLocks[TRANSLATION_LOCKS];
+
+sys::Mutex& translationLock(const void* state)
+{
+    return translationLocks[reinterpret_cast<size_t>(state) % TRANSLATION_LOCKS];
+}
+}
+
+intrusive_ptr<const RefCounted> Message::SharedStateImpl::getTranslation(const std::string& protocol) const
+{
+    sys::Mutex::ScopedLock l(translationLock(this));
+    if (translations) {
+        Translations::const_iterator i = translations->find(protocol);
+        if (i != translations->end()) return i->second;
+    }
+    return intrusive_ptr<const RefCounted>();
+}
+
+intrusive_ptr<const RefCounted> Message::SharedStateImpl::setTranslation(const std::string& protocol, intrusive_ptr<const RefCounted> translation) const
+{
+    sys::Mutex::ScopedLock l(translationLock(this));
+    if (!translations) translations.reset(new Translations);
+    std::pair<Translations::iterator, bool> result = translations->insert(Translations::value_type(protocol, translation));
+    return result.first->second;
+}
+
 }} // namespace qpid::broker
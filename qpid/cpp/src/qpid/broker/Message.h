@@ -31,6 +31,7 @@
 
 #include "qpid/broker/BrokerImportExport.h"
 
+#include <map>
 #include <string>
 #include <vector>
 #include <boost/intrusive_ptr.hpp>
@@ -97,16 +98,30 @@ public:
 
         virtual bool getIsManagementMessage() const = 0;
         virtual void setIsManagementMessage(bool b) = 0;
+        /**
+         * @returns the encoding of this message translated for the
+         * named protocol, if it has been cached, else null.
+         */
+        virtual boost::intrusive_ptr<const RefCounted> getTranslation(const std::string& protocol) const = 0;
+        /**
+         * Caches the encoding of this message translated for the named
+         * protocol, unless another thread has already done so.
+         * @returns the cached translation
+         */
+        virtual boost::intrusive_ptr<const RefCounted> setTranslation(const std::string& protocol, boost::intrusive_ptr<const RefCounted>) const = 0;
     };
 
     class SharedStateImpl : public SharedState
     {
+        typedef std::map<std::string, boost::intrusive_ptr<const RefCounted> > Translations;
+
         const Connection* publisher;
         qpid::sys::AbsTime expiration;
         bool isManagementMessage;
+        mutable boost::scoped_ptr<Translations> translations;//only allocated if translated
       public:
         QPID_BROKER_EXTERN SharedStateImpl();
-        virtual ~SharedStateImpl() {}
+        QPID_BROKER_EXTERN virtual ~SharedStateImpl();
         QPID_BROKER_EXTERN const Connection* getPublisher() const;
         QPID_BROKER_EXTERN void setPublisher(const Connection* p);
         QPID_BROKER_EXTERN void setExpiration(sys::AbsTime e);
@@ -115,6 +130,8 @@ public:
         QPID_BROKER_EXTERN void computeExpiration();
         QPID_BROKER_EXTERN bool getIsManagementMessage() const;
         QPID_BROKER_EXTERN void setIsManagementMessage(bool b);
+        QPID_BROKER_EXTERN boost::intrusive_ptr<const RefCounted> getTranslation(const std::string& protocol) const;
+        QPID_BROKER_EXTERN boost::intrusive_ptr<const RefCounted> setTranslation(const std::string& protocol, boost::intrusive_ptr<const RefCounted>) const;
     };
 
     QPID_BROKER_EXTERN Message(boost::intrusive_ptr<SharedState>, boost::intrusive_ptr<PersistableMessage>);
@@ -159,12 +176,24 @@ public:
     QPID_BROKER_EXTERN const Encoding& getEncoding() const;
     QPID_BROKER_EXTERN operator bool() const;
     QPID_BROKER_EXTERN SharedState& getSharedState();
+    /**
+     * Translations of the message into the encodings of other
+     * protocols are cached on the shared state, so that a message
+     * delivered to many consumers using another protocol is only
+     * translated once.
+     */
+    QPID_BROKER_EXTERN boost::intrusive_ptr<const RefCounted> getTranslation(const std::string& protocol) const;
+    QPID_BROKER_EXTERN boost::intrusive_ptr<const RefCounted> setTranslation(const std::string& protocol, boost::intrusive_ptr<const RefCounted>) const;
 
     bool getIsManagementMessage() const;
 
     QPID_BROKER_EXTERN qpid::framing::SequenceNumber getSequence() const;
     QPID_BROKER_EXTERN void setSequence(const qpid::framing::SequenceNumber&);
 
+    /** Time the message was enqueued, recorded only on managed queues */
+    const sys::AbsTime& getEnqueueTime() const { return enqueueTime; }
+    void setEnqueueTime(const sys::AbsTime& t) { enqueueTime = t; }
+
     MessageState getState() const;
     void setState(MessageState);
 
@@ -223,6 +252,7 @@ public:
     MessageState state;
     qpid::framing::SequenceNumber sequence;
     framing::SequenceNumber replicationId;
+    sys::AbsTime enqueueTime;
     bool isReplicationIdSet:1;
 
     void annotationsChanged();
@@ -97,10 +97,14 @@ boost::intrusive_ptr<const qpid::broker::amqp_0_10::MessageTransfer> ProtocolReg
 {
     boost::intrusive_ptr<const qpid::broker::amqp_0_10::MessageTransfer> transfer;
     const qpid::broker::amqp_0_10::MessageTransfer* ptr = dynamic_cast<const qpid::broker::amqp_0_10::MessageTransfer*>(&m.getEncoding());
-    if (ptr) transfer = boost::intrusive_ptr<const qpid::broker::amqp_0_10::MessageTransfer>(ptr);
+    if (ptr) return boost::intrusive_ptr<const qpid::broker::amqp_0_10::MessageTransfer>(ptr);
+    transfer = dynamic_cast<const qpid::broker::amqp_0_10::MessageTransfer*>(m.getTranslation(AMQP_0_10).get());
+    if (transfer) return transfer;
     for (Protocols::const_iterator i = protocols.begin(); !transfer && i != protocols.end(); ++i) {
         transfer = i->second->translate(m);
     }
+    //cache for other consumers of the same message, keeping any already cached
+    if (transfer) transfer = dynamic_cast<const qpid::broker::amqp_0_10::MessageTransfer*>(m.setTranslation(AMQP_0_10, transfer).get());
     if (!transfer) throw new Exception("Could not convert message into 0-10");
     return transfer;
 }
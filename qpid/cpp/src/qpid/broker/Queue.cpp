@@ -36,6 +36,7 @@
 #include "qpid/broker/QueueRegistry.h"
 #include "qpid/broker/Selector.h"
 #include "qpid/broker/TransactionObserver.h"
+#include "qpid/broker/TxBuffer.h"
 #include "qpid/broker/TxDequeue.h"
 
 //TODO: get rid of this
@@ -130,6 +131,10 @@ inline void mgntDeqStats(const Message& msg,
         }
         mgmtObject->statisticsUpdated();
         brokerMgmtObject->statisticsUpdated();
+        if (!(msg.getEnqueueTime() == sys::ZERO)) {
+            int64_t residency = sys::Duration(msg.getEnqueueTime(), sys::AbsTime::now());
+            mgmtObject->set_residencyTime(residency > 0 ? residency : 0);
+        }
     }
 }
 
@@ -153,21 +158,33 @@ QueueSettings merge(const QueueSettings& inputs, const Broker& broker)
 }
 
 
-Queue::TxPublish::TxPublish(const Message& m, boost::shared_ptr<Queue> q) : message(m), queue(q), prepared(false) {}
+Queue::TxPublish::TxPublish(const Message& m, boost::shared_ptr<Queue> q) : messages(1, m), queue(q), prepared(false) {}
+void Queue::TxPublish::add(const Message& m)
+{
+    messages.push_back(m);
+}
 bool Queue::TxPublish::prepare(TransactionContext* ctxt) throw()
 {
+    // Only messages the queue accepted are committed or rolled back.
+    std::vector<Message> enqueued;
+    enqueued.reserve(messages.size());
+    bool ok = true;
     try {
-        prepared = queue->enqueue(ctxt, message);
-        return true;
+        for (std::vector<Message>::iterator i = messages.begin(); i != messages.end(); ++i) {
+            if (queue->enqueue(ctxt, *i)) enqueued.push_back(*i);
+        }
     } catch (const std::exception& e) {
         QPID_LOG(error, "Failed to prepare: " << e.what());
-        return false;
+        ok = false;
     }
+    messages.swap(enqueued);
+    prepared = true;
+    return ok;
 }
 void Queue::TxPublish::commit() throw()
 {
     try {
-        if (prepared) queue->process(message);
+        if (prepared) queue->process(messages);
     } catch (const std::exception& e) {
         QPID_LOG(error, "Failed to commit: " << e.what());
     }
@@ -175,7 +192,11 @@ void Queue::TxPublish::commit() throw()
 void Queue::TxPublish::rollback() throw()
 {
     try {
-        if (prepared) queue->enqueueAborted(message);
+        if (prepared) {
+            for (std::vector<Message>::iterator i = messages.begin(); i != messages.end(); ++i) {
+                queue->enqueueAborted(*i);
+            }
+        }
     } catch (const std::exception& e) {
         QPID_LOG(error, "Failed to rollback: " << e.what());
     }
@@ -184,7 +205,9 @@ void Queue::TxPublish::rollback() throw()
 void Queue::TxPublish::callObserver(
     const boost::shared_ptr<TransactionObserver>& observer)
 {
-    observer->enqueue(queue, message);
+    for (std::vector<Message>::iterator i = messages.begin(); i != messages.end(); ++i) {
+        observer->enqueue(queue, *i);
+    }
 }
 
 Queue::Queue(const string& _name, const QueueSettings& _settings,
@@ -295,8 +318,15 @@ void Queue::deliverTo(Message msg, TxBuffer* txn)
     if (accept(msg)) {
         interceptors.record(msg);
         if (txn) {
-            TxOp::shared_ptr op(new TxPublish(msg, shared_from_this()));
-            txn->enlist(op);
+            // Keyed by this queue: the op holds a reference to the queue,
+            // so the key can't be reused by another queue.
+            TxOp::shared_ptr op = txn->getEnlisted(this);
+            if (op) {
+                boost::static_pointer_cast<TxPublish>(op)->add(msg);
+                txn->getObserver()->enqueue(shared_from_this(), msg);
+            } else {
+                txn->enlist(TxOp::shared_ptr(new TxPublish(msg, shared_from_this())), this);
+            }
             QPID_LOG(debug, "Message " << msg.getSequence() << " enqueue on " << name
                      << " enlisted in " << txn);
         } else {
@@ -340,6 +370,27 @@ void Queue::process(Message& msg)
     }
 }
 
+void Queue::process(std::vector<Message>& msgs)
+{
+    pushBatch(msgs);
+    if (mgmtObject != 0){
+        _qmf::Queue::PerThreadStats *qStats = mgmtObject->getStatistics();
+        uint64_t contentSize = 0;
+        for (std::vector<Message>::const_iterator i = msgs.begin(); i != msgs.end(); ++i) {
+            contentSize += i->getMessageSize();
+        }
+        qStats->msgTxnEnqueues  += msgs.size();
+        qStats->byteTxnEnqueues += contentSize;
+        mgmtObject->statisticsUpdated();
+        if (brokerMgmtObject) {
+            _qmf::Broker::PerThreadStats *bStats = brokerMgmtObject->getStatistics();
+            bStats->msgTxnEnqueues += msgs.size();
+            bStats->byteTxnEnqueues += contentSize;
+            brokerMgmtObject->statisticsUpdated();
+        }
+    }
+}
+
 void Queue::release(const QueueCursor& position, bool markRedelivered)
 {
     QueueListeners::NotificationSet copy;
@@ -825,6 +876,7 @@ uint32_t Queue::move(const Queue::shared_ptr destq, uint32_t qty,
 void Queue::push(Message& message, bool /*isRecovery*/)
 {
     QueueListeners::NotificationSet copy;
+    if (mgmtObject) message.setEnqueueTime(sys::AbsTime::now());
     {
         Mutex::ScopedLock locker(messageLock);
         message.setSequence(++sequence);
@@ -837,6 +889,29 @@ void Queue::push(Message& message, bool /*isRecovery*/)
     copy.notify();
 }
 
+void Queue::pushBatch(std::vector<Message>& msgs)
+{
+    QueueListeners::NotificationSet copy;
+    if (mgmtObject) {
+        sys::AbsTime now = sys::AbsTime::now();
+        for (std::vector<Message>::iterator i = msgs.begin(); i != msgs.end(); ++i) {
+            i->setEnqueueTime(now);
+        }
+    }
+    {
+        Mutex::ScopedLock locker(messageLock);
+        for (std::vector<Message>::iterator i = msgs.begin(); i != msgs.end(); ++i) {
+            i->setSequence(++sequence);
+            if (settings.sequencing) i->addAnnotation(settings.sequenceKey, (uint32_t)sequence);
+            interceptors.publish(*i);
+            messages->publish(*i);
+            observeEnqueue(*i, locker);
+        }
+        listeners.populate(copy);
+    }
+    copy.notify();
+}
+
 uint32_t Queue::getMessageCount() const
 {
     Mutex::ScopedLock locker(messageLock);
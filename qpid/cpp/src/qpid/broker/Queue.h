@@ -108,13 +108,15 @@ class Queue : public boost::enable_shared_from_this<Queue>,
         ~ScopedUse() { if (acquired) barrier.release(); }
     };
 
+    /** All of a transaction's enqueues onto one queue. */
     class TxPublish : public TxOp
     {
-        Message message;
+        std::vector<Message> messages;
         boost::shared_ptr<Queue> queue;
         bool prepared;
       public:
         TxPublish(const Message&,boost::shared_ptr<Queue>);
+        void add(const Message&);
         bool prepare(TransactionContext* ctxt) throw();
         void commit() throw();
         void rollback() throw();
@@ -228,8 +230,10 @@ class Queue : public boost::enable_shared_from_this<Queue>,
     bool isUnused(const qpid::sys::Mutex::ScopedLock&) const;
     bool isEmpty(const qpid::sys::Mutex::ScopedLock&) const;
     virtual void push(Message& msg, bool isRecovery=false);
+    virtual void pushBatch(std::vector<Message>& msgs);
     bool accept(const Message&);
     void process(Message& msg);
+    void process(std::vector<Message>& msgs);
     bool enqueue(TransactionContext* ctxt, Message& msg);
     bool getNextMessage(Message& msg, Consumer::shared_ptr& c);
 
@@ -78,8 +78,14 @@ class CyrusAuthenticator : public SaslAuthenticator
     amqp_0_10::Connection& connection;
     framing::AMQP_ClientProxy::Connection client;
     const bool encrypt;
+    // Result of sasl_server_start/step run ahead by prepareStart/Step.
+    bool prepared;
+    int preparedCode;
+    std::string preparedChallenge;
 
+    void prepare(int code, const char *challenge, unsigned int challenge_len);
     void processAuthenticationStep(int code, const char *challenge, unsigned int challenge_len);
+    void processPrepared();
     bool getUsername(std::string& uid);
 
 public:
@@ -89,6 +95,9 @@ public:
     void getMechanisms(framing::Array& mechanisms);
     void start(const std::string& mechanism, const std::string* response);
     void step(const std::string& response);
+    bool isOffloadable() const { return true; }
+    void prepareStart(const std::string& mechanism, const std::string* response);
+    void prepareStep(const std::string& response);
     void getError(std::string& error);
     void getUid(std::string& uid) { getUsername(uid); }
     std::auto_ptr<SecurityLayer> getSecurityLayer(uint16_t maxFrameSize);
@@ -288,7 +297,8 @@ std::auto_ptr<SecurityLayer> NullAuthenticator::getSecurityLayer(uint16_t)
 #if HAVE_SASL
 
 CyrusAuthenticator::CyrusAuthenticator(amqp_0_10::Connection& c, bool _encrypt) :
-    sasl_conn(0), connection(c), client(c.getOutput()), encrypt(_encrypt)
+    sasl_conn(0), connection(c), client(c.getOutput()), encrypt(_encrypt),
+    prepared(false), preparedCode(SASL_FAIL)
 {
     init();
 }
@@ -453,24 +463,59 @@ void CyrusAuthenticator::getMechanisms(Array& mechanisms)
 }
 
 void CyrusAuthenticator::start(const string& mechanism, const string* response)
+{
+    if (prepared) {
+        processPrepared();
+    } else {
+        const char *challenge;
+        unsigned int challenge_len;
+
+        // This should be at same debug level as mech list in getMechanisms().
+        QPID_LOG(info, "SASL: Starting authentication with mechanism: " << mechanism);
+        int code = sasl_server_start(sasl_conn,
+                                     mechanism.c_str(),
+                                     (response ? response->c_str() : 0), (response ? response->size() : 0),
+                                     &challenge, &challenge_len);
+
+        processAuthenticationStep(code, challenge, challenge_len);
+    }
+    qmf::org::apache::qpid::broker::Connection::shared_ptr cnxMgmt = connection.getMgmtObject();
+    if ( cnxMgmt )
+        cnxMgmt->set_saslMechanism(mechanism);
+}
+
+void CyrusAuthenticator::step(const string& response)
+{
+    if (prepared) {
+        processPrepared();
+        return;
+    }
+    const char *challenge;
+    unsigned int challenge_len;
+
+    int code = sasl_server_step(sasl_conn,
+                            response.c_str(), response.length(),
+                            &challenge, &challenge_len);
+
+    processAuthenticationStep(code, challenge, challenge_len);
+}
+
+// prepareStart and prepareStep run on an AuthWorkers thread, so must not
+// touch the connection: they only drive sasl_conn and keep the result.
+void CyrusAuthenticator::prepareStart(const string& mechanism, const string* response)
 {
     const char *challenge;
     unsigned int challenge_len;
 
-    // This should be at same debug level as mech list in getMechanisms().
     QPID_LOG(info, "SASL: Starting authentication with mechanism: " << mechanism);
     int code = sasl_server_start(sasl_conn,
                                  mechanism.c_str(),
                                  (response ? response->c_str() : 0), (response ? response->size() : 0),
                                  &challenge, &challenge_len);
-
-    processAuthenticationStep(code, challenge, challenge_len);
-    qmf::org::apache::qpid::broker::Connection::shared_ptr cnxMgmt = connection.getMgmtObject();
-    if ( cnxMgmt )
-        cnxMgmt->set_saslMechanism(mechanism);
+    prepare(code, challenge, challenge_len);
 }
 
-void CyrusAuthenticator::step(const string& response)
+void CyrusAuthenticator::prepareStep(const string& response)
 {
     const char *challenge;
     unsigned int challenge_len;
@@ -478,8 +523,21 @@ void CyrusAuthenticator::step(const string& response)
     int code = sasl_server_step(sasl_conn,
                             response.c_str(), response.length(),
                             &challenge, &challenge_len);
+    prepare(code, challenge, challenge_len);
+}
 
-    processAuthenticationStep(code, challenge, challenge_len);
+void CyrusAuthenticator::prepare(int code, const char *challenge, unsigned int challenge_len)
+{
+    preparedCode = code;
+    if (SASL_CONTINUE == code) preparedChallenge.assign(challenge, challenge_len);
+    else preparedChallenge.clear();
+    prepared = true;
+}
+
+void CyrusAuthenticator::processPrepared()
+{
+    prepared = false;
+    processAuthenticationStep(preparedCode, preparedChallenge.data(), preparedChallenge.size());
 }
 
 void CyrusAuthenticator::processAuthenticationStep(int code, const char *challenge, unsigned int challenge_len)
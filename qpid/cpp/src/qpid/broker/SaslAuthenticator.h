@@ -50,6 +50,16 @@ public:
     virtual void getError(std::string&) {}
     virtual std::auto_ptr<qpid::sys::SecurityLayer> getSecurityLayer(uint16_t maxFrameSize) = 0;
 
+    /**
+     * An offloadable authenticator can do the expensive part of start()
+     * or step() in prepareStart() or prepareStep() on another thread.
+     * The following start() or step() call, made on the connection's IO
+     * thread, then only acts on the prepared result.
+     */
+    virtual bool isOffloadable() const { return false; }
+    virtual void prepareStart(const std::string& /*mechanism*/, const std::string* /*response*/) {}
+    virtual void prepareStep(const std::string& /*response*/) {}
+
     static bool available(void);
 
     // Initialize the SASL mechanism; throw if it fails.
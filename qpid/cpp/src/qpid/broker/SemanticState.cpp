@@ -307,6 +307,8 @@ void SemanticState::checkDtxTimeout()
 void SemanticState::record(const DeliveryRecord& delivery)
 {
     unacked.push_back(delivery);
+    if (!delivery.isAccepted() && getSession().sampleAcceptTime())
+        unacked.back().setDeliveryTime(AbsTime::now());
     getSession().setUnackedCount(unacked.size());
 }
 
@@ -498,7 +500,7 @@ void SemanticState::route(Message& msg, Deliverable& strategy) {
     AclModule* acl = getSession().getBroker().getAcl();
     if (acl && acl->doTransferAcl())
     {
-        if (!acl->authorise(getSession().getConnection().getUserId(),acl::ACT_PUBLISH,acl::OBJ_EXCHANGE,exchangeName, msg.getRoutingKey() ))
+        if (!publishAcl.authorise(*acl, getSession().getConnection().getUserId(), exchangeName, msg.getRoutingKey()))
             throw UnauthorizedAccessException(QPID_MSG(userID << " cannot publish to " <<
                                                exchangeName << " with routing-key " << msg.getRoutingKey()));
     }
@@ -540,6 +542,13 @@ bool SemanticState::complete(DeliveryRecord& delivery)
     return delivery.isRedundant();
 }
 
+bool SemanticState::accept(DeliveryRecord& delivery, const AbsTime& now)
+{
+    if (!delivery.isEnded() && !(delivery.getDeliveryTime() == ZERO) && !(now == ZERO))
+        getSession().recordAcceptTime(delivery.getDeliveryTime(), now);
+    return delivery.accept(0);
+}
+
 void SemanticStateConsumerImpl::complete(DeliveryRecord& delivery)
 {
     if (!delivery.isComplete()) {
@@ -797,11 +806,11 @@ void SemanticState::accepted(const SequenceSet& commands) {
             unacked.erase(removed, unacked.end());
         }
     } else {
+        AbsTime now = getSession().sampleAcceptTime() ? AbsTime::now() : ZERO;
         DeliveryRecords::iterator removed =
             remove_if(unacked.begin(), unacked.end(),
                       isInSequenceSetAnd(commands,
-                                         bind(&DeliveryRecord::accept, _1,
-                                              (TransactionContext*) 0)));
+                                         bind(&SemanticState::accept, this, _1, now)));
         unacked.erase(removed, unacked.end());
     }
     getSession().setUnackedCount(unacked.size());
@@ -22,6 +22,7 @@
  *
  */
 
+#include "qpid/broker/AclPublishCache.h"
 #include "qpid/broker/BrokerImportExport.h"
 #include "qpid/broker/Consumer.h"
 #include "qpid/broker/Credit.h"
@@ -101,6 +102,7 @@ class SemanticState : private boost::noncopyable {
     DtxBufferMap suspendedXids;
     framing::SequenceSet accumulatedAck;
     boost::shared_ptr<Exchange> cacheExchange;
+    AclPublishCache publishAcl;
     const bool authMsg;
     const std::string userID;
     bool closeComplete;
@@ -112,6 +114,7 @@ class SemanticState : private boost::noncopyable {
     void checkDtxTimeout();
 
     bool complete(DeliveryRecord&);
+    bool accept(DeliveryRecord&, const sys::AbsTime& now);
     AckRange findRange(DeliveryId first, DeliveryId last);
     void requestDispatch();
     void cancel(boost::shared_ptr<ConsumerImpl>);
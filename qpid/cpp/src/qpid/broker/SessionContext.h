@@ -23,6 +23,7 @@
  */
 
 #include "qpid/broker/OwnershipToken.h"
+#include "qpid/sys/Time.h"
 
 #include <boost/noncopyable.hpp>
 
@@ -52,6 +53,8 @@ class SessionContext : public OwnershipToken
     virtual const SessionId& getSessionId() const = 0;
     virtual bool addPendingExecutionSync() = 0;
     virtual void setUnackedCount(uint64_t) {}
+    virtual bool sampleAcceptTime() const { return false; }
+    virtual void recordAcceptTime(const sys::AbsTime& /*delivered*/, const sys::AbsTime& /*accepted*/) {}
 };
 
 }} // namespace qpid::broker
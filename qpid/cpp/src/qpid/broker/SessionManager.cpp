@@ -25,6 +25,7 @@
 #include "qpid/log/Statement.h"
 #include "qpid/log/Helpers.h"
 #include "qpid/memory.h"
+#include "qpid/sys/unordered_map.h"
 
 #include <boost/bind.hpp>
 #include <boost/range.hpp>
@@ -44,59 +45,89 @@ SessionManager::SessionManager(const SessionState::Configuration& c, Broker& b)
     : config(c), broker(b) {}
 
 SessionManager::~SessionManager() {
-    detached.clear();           // Must clear before destructor as session dtor will call forget()
+    // Must clear before destructor as session dtor will call forget()
+    for (size_t i = 0; i < SHARDS; ++i) {
+        shards[i].index.clear();
+        shards[i].detached.clear();
+    }
+}
+
+SessionManager::Shard& SessionManager::shard(const SessionId& id) {
+    sys::unordered_map<std::string, int>::hasher hash;
+    return shards[(hash(id.getUserId()) * 31 + hash(id.getName())) % SHARDS];
 }
 
 std::auto_ptr<SessionState>  SessionManager::attach(SessionHandler& h, const SessionId& id, bool force) {
-    Mutex::ScopedLock l(lock);
-    eraseExpired();             // Clean up expired table
-    std::pair<Attached::iterator, bool> insert = attached.insert(id);
-    if (!insert.second && !force)
-        throw SessionBusyException(QPID_MSG("Session already attached: " << id));
-    Detached::iterator i = std::find(detached.begin(), detached.end(), id);
+    Detached expired;           // Destroyed after the lock is released.
     std::auto_ptr<SessionState> state;
-    if (i == detached.end())  
+    Shard& s = shard(id);
+    {
+        Mutex::ScopedLock l(s.lock);
+        eraseExpired(s, expired); // Clean up expired table
+        std::pair<Attached::iterator, bool> insert = s.attached.insert(id);
+        if (!insert.second && !force)
+            throw SessionBusyException(QPID_MSG("Session already attached: " << id));
+        DetachedIndex::iterator i = s.index.find(id);
+        if (i != s.index.end()) {
+            state.reset(s.detached.release(i->second).release());
+            s.index.erase(i);
+        }
+    }
+    if (!state.get())
         state.reset(new SessionState(broker, h, id, config));
-    else {
-        state.reset(detached.release(i).release());
+    else
         state->attach(h);
-    }
     return state;
 }
 
 void  SessionManager::detach(std::auto_ptr<SessionState> session) {
-    Mutex::ScopedLock l(lock);
-    attached.erase(session->getId());
+    Detached expired;           // Destroyed after the lock is released.
+    Shard& s = shard(session->getId());
+    Mutex::ScopedLock l(s.lock);
+    s.attached.erase(session->getId());
     session->detach();
     if (session->getTimeout() > 0) {
         session->expiry = AbsTime(now(), session->getTimeout()*TIME_SEC);
         if (session->mgmtObject != 0) {
             session->mgmtObject->set_expireTime (Duration::FromEpoch()+session->getTimeout()*TIME_SEC);
         }
-        detached.push_back(session.release()); // In expiry order
-        eraseExpired();
+        SessionId id = session->getId();
+        // A force-attach can leave an older session with the same id
+        // detached: the newer one supersedes it.
+        DetachedIndex::iterator i = s.index.find(id);
+        if (i != s.index.end()) {
+            expired.transfer(expired.end(), i->second, s.detached);
+            s.index.erase(i);
+        }
+        s.detached.push_back(session.release()); // In expiry order
+        s.index[id] = --s.detached.end();
+        eraseExpired(s, expired);
     }
 }
 
 void SessionManager::forget(const SessionId& id) {
-    Mutex::ScopedLock l(lock);
-    attached.erase(id);
+    Shard& s = shard(id);
+    Mutex::ScopedLock l(s.lock);
+    s.attached.erase(id);
 }
 
-void SessionManager::eraseExpired() {
-    // Called with lock held.
-    if (!detached.empty()) {
+void SessionManager::eraseExpired(Shard& s, Detached& expired) {
+    // Called with the shard lock held, moves expired sessions to expired.
+    if (!s.detached.empty()) {
         // This used to use a more elegant invocation of std::lower_bound
         // but violated the strict weak ordering rule which Visual Studio
         // enforced. See QPID-1424 for more info should you be tempted to
         // replace the loop with something more elegant.
         AbsTime now = AbsTime::now();
-        Detached::iterator keep = detached.begin();
-        while ((keep != detached.end()) && ((*keep).expiry < now))
+        Detached::iterator keep = s.detached.begin();
+        while ((keep != s.detached.end()) && ((*keep).expiry < now)) {
+            DetachedIndex::iterator i = s.index.find(keep->getId());
+            if (i != s.index.end() && i->second == keep) s.index.erase(i);
             keep++;
-        if (detached.begin() != keep) {
-            QPID_LOG(debug, "Expiring sessions: " << log::formatList(detached.begin(), keep));
-            detached.erase(detached.begin(), keep);
+        }
+        if (s.detached.begin() != keep) {
+            QPID_LOG(debug, "Expiring sessions: " << log::formatList(s.detached.begin(), keep));
+            expired.transfer(expired.end(), s.detached.begin(), keep, s.detached);
         }
     }
 }
@@ -27,12 +27,13 @@
 #include <qpid/sys/Mutex.h>
 #include <qpid/RefCounted.h>
 
+#include <map>
 #include <set>
 #include <vector>
 #include <memory>
 
 #include <boost/noncopyable.hpp>
-#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/ptr_container/ptr_list.hpp>
 #include <boost/intrusive_ptr.hpp>
 
 namespace qpid {
@@ -43,6 +44,10 @@ class SessionHandler;
 
 /**
  * Create and manage SessionState objects.
+ *
+ * Sessions are spread over shards by session id, each with its own lock,
+ * so that a storm of clients attaching at once does not serialize on a
+ * single lock.
  */
 class SessionManager : private boost::noncopyable {
   public:
@@ -64,14 +69,22 @@ class SessionManager : private boost::noncopyable {
     const qpid::SessionState::Configuration& getSessionConfig() const { return config; }
 
   private:
-    typedef boost::ptr_vector<SessionState> Detached; // Sorted in expiry order.
+    typedef boost::ptr_list<SessionState> Detached; // Sorted in expiry order.
+    typedef std::map<SessionId, Detached::iterator> DetachedIndex;
     typedef std::set<SessionId> Attached;
 
-    void eraseExpired();             
+    struct Shard {
+        sys::Mutex lock;
+        Detached detached;
+        DetachedIndex index;
+        Attached attached;
+    };
+    static const size_t SHARDS = 64;
+
+    Shard& shard(const SessionId&);
+    void eraseExpired(Shard&, Detached& expired);
 
-    sys::Mutex lock;
-    Detached detached;
-    Attached attached;
+    Shard shards[SHARDS];
     qpid::SessionState::Configuration config;
     Broker& broker;
 };
@@ -135,6 +135,14 @@ class SessionState : public qpid::SessionState,
             mgmtObject->set_unackedMessages(count);
     }
 
+    // Delivery to accept latency is only sampled for managed sessions
+    bool sampleAcceptTime() const { return mgmtObject != 0; }
+    void recordAcceptTime(const sys::AbsTime& delivered, const sys::AbsTime& accepted) {
+        int64_t latency = sys::Duration(delivered, accepted);
+        if (mgmtObject)
+            mgmtObject->set_acceptTime(latency > 0 ? latency : 0);
+    }
+
     // Used to delay creation of management object for sessions
     // belonging to inter-broker bridges
     void addManagementObject();
@@ -51,6 +51,7 @@ void TxBuffer::commit()
     observer->commit();
     std::for_each(ops.begin(), ops.end(), mem_fn(&TxOp::commit));
     ops.clear();
+    keyed.clear();
 }
 
 void TxBuffer::rollback()
@@ -58,12 +59,27 @@ void TxBuffer::rollback()
     observer->rollback();
     std::for_each(ops.begin(), ops.end(), mem_fn(&TxOp::rollback));
     ops.clear();
+    keyed.clear();
 }
 
 void TxBuffer::enlist(TxOp::shared_ptr op)
 {
     op->callObserver(observer);
     ops.push_back(op);
+    keyed.clear();
+}
+
+void TxBuffer::enlist(TxOp::shared_ptr op, const void* key)
+{
+    op->callObserver(observer);
+    ops.push_back(op);
+    keyed[key] = op;
+}
+
+TxOp::shared_ptr TxBuffer::getEnlisted(const void* key) const
+{
+    Keyed::const_iterator i = keyed.find(key);
+    return i == keyed.end() ? TxOp::shared_ptr() : i->second;
 }
 
 void TxBuffer::startCommit(TransactionalStore* const store)
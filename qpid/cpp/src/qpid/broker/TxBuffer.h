@@ -27,6 +27,7 @@
 #include "qpid/broker/TxOp.h"
 #include "qpid/broker/AsyncCompletion.h"
 #include "qpid/sys/Mutex.h"
+#include "qpid/sys/unordered_map.h"
 #include <algorithm>
 #include <functional>
 #include <vector>
@@ -65,6 +66,18 @@ class TransactionObserver;
  * changes made during prepare should be subject to the control of the
  * TransactionalStore in use.
  *
+ * Work on a single resource, e.g. all the enqueues onto one queue, can be
+ * collected into one op enlisted with a key for that resource, so commit
+ * makes each queue's messages available under one lock. Prepare still
+ * enqueues each message to the store separately.
+ *
+ * Collecting moves later work on a resource forward to where its op was
+ * enlisted, ahead of keyed ops for other resources enlisted in between.
+ * That is safe because nothing is visible before commit and the work on
+ * each resource keeps its order. Enlisting an op without a key ends all
+ * collections, so no work is ever moved past an unkeyed op such as an
+ * accept or dequeue.
+ *
  * TxBuffer inherits AsyncCompletion because transactions can be completed
  * asynchronously if the broker is part of a HA cluster.
  */
@@ -72,6 +85,8 @@ class TxBuffer : public AsyncCompletion {
   private:
     typedef std::vector<TxOp::shared_ptr>::iterator op_iterator;
     std::vector<TxOp::shared_ptr> ops;
+    typedef sys::unordered_map<const void*, TxOp::shared_ptr> Keyed;
+    Keyed keyed;
     boost::shared_ptr<TransactionObserver> observer;
     std::auto_ptr<TransactionContext> txContext;
     std::string error;
@@ -81,10 +96,24 @@ class TxBuffer : public AsyncCompletion {
     QPID_BROKER_EXTERN TxBuffer();
 
     /**
-     * Adds an operation to the transaction.
+     * Adds an operation to the transaction. Later work must not be
+     * added to ops enlisted with a key before this one.
      */
     QPID_BROKER_EXTERN void enlist(TxOp::shared_ptr op);
 
+    /**
+     * Adds an operation that collects the transaction's work on the
+     * resource identified by key.
+     */
+    QPID_BROKER_EXTERN void enlist(TxOp::shared_ptr op, const void* key);
+
+    /**
+     * @return the operation enlisted with key, or null if there is none
+     * since the last unkeyed op. Further work on the resource should be
+     * added to it.
+     */
+    QPID_BROKER_EXTERN TxOp::shared_ptr getEnlisted(const void* key) const;
+
     /**
      * Requests that all ops are prepared. This should
      * primarily involve making sure that a persistent record
@@ -21,6 +21,7 @@
  * under the License.
  *
  */
+#include "qpid/broker/AclPublishCache.h"
 #include <string>
 #include <boost/shared_ptr.hpp>
 
@@ -59,6 +60,7 @@ class Authorise
   private:
     const std::string user;
     AclModule* const acl;
+    AclPublishCache publishAcl;
 
 };
 }}} // namespace qpid::broker::amqp
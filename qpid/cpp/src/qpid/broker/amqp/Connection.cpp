@@ -22,13 +22,14 @@
 #include "DataReader.h"
 #include "Session.h"
 #include "Exception.h"
+#include "Outgoing.h"
 #include "qpid/broker/AclModule.h"
 #include "qpid/broker/Broker.h"
 #include "qpid/amqp/descriptors.h"
 #include "qpid/framing/Buffer.h"
 #include "qpid/framing/ProtocolInitiation.h"
 #include "qpid/framing/ProtocolVersion.h"
-#include "qpid/log/Statement.h"
+#include "qpid/log/BinaryTrace.h"
 #include "qpid/sys/Time.h"
 #include "qpid/sys/Timer.h"
 #include "qpid/sys/OutputControl.h"
@@ -131,7 +132,8 @@ Connection::Connection(qpid::sys::OutputControl& o, const std::string& i, Broker
     out.activateOutput();
     bool enableTrace(false);
     QPID_LOG_TEST_CAT(trace, protocol, enableTrace);
-    if (enableTrace) {
+    // A binary trace records the raw frames in decode() and encode() instead.
+    if (enableTrace && !qpid::log::BinaryTrace::isOpen()) {
         pn_transport_trace(transport, PN_TRACE_FRM);
         set_tracer(transport, this);
     }
@@ -194,6 +196,7 @@ size_t Connection::decode(const char* buffer, size_t size)
                 n = size;   // assume all consumed
             }
         }
+        QPID_TRACE_BINARY(trace, "[{}]: RECV {}", << id << qpid::log::BinaryTrace::Amqp(buffer, n));
         QPID_LOG_CAT(debug, network, id << " decoded " << n << " bytes from " << size);
         try {
             process();
@@ -235,6 +238,7 @@ size_t Connection::encode(char* buffer, size_t size)
     doOutput(size);
     ssize_t n = pn_transport_output(transport, buffer, size);
     if (n > 0) {
+        QPID_TRACE_BINARY(trace, "[{}]: SENT {}", << id << qpid::log::BinaryTrace::Amqp(buffer, n));
         QPID_LOG_CAT(debug, network, id << " encoded " << n << " bytes from " << size)
         haveOutput = true;
         if (ticker) ticker->restart();
@@ -264,7 +268,10 @@ void Connection::doOutput(size_t capacity)
 {
     ssize_t n = 0;
     do {
-        if (dispatch()) {
+        //Share the space left in the output buffer between the
+        //outgoing links, so that a pass fills the buffer without one
+        //busy link starving the others.
+        if (dispatch(capacity - (size_t) n)) {
             processDeliveries();
             ssize_t next = pn_transport_pending(transport);
             if (n == next) break;
@@ -273,8 +280,18 @@ void Connection::doOutput(size_t capacity)
     } while (n > 0 && n < (ssize_t) capacity);
 }
 
-bool Connection::dispatch()
+size_t Connection::getOutgoingLinkCount() const
 {
+    size_t count(0);
+    for (Sessions::const_iterator i = sessions.begin(); i != sessions.end(); ++i) {
+        count += i->second->getOutgoingLinkCount();
+    }
+    return count;
+}
+
+bool Connection::dispatch(size_t bytes)
+{
+    OutputBudget budget(bytes, getOutgoingLinkCount());
     bool result = false;
     for (Sessions::iterator i = sessions.begin();i != sessions.end();) {
         if (i->second->endedByManagement()) {
@@ -284,7 +301,7 @@ bool Connection::dispatch()
             result = true;
             QPID_LOG_CAT(debug, model, id << " session ended by management");
         } else {
-            if (i->second->dispatch()) result = true;
+            if (i->second->dispatch(budget)) result = true;
             ++i;
         }
     }
@@ -299,7 +316,8 @@ bool Connection::canEncode()
             return true;
         }
         try {
-            if (dispatch()) haveOutput = true;
+            //only checking for output here, so at most one message per link
+            if (dispatch(0)) haveOutput = true;
             process();
         } catch (const Exception& e) {
             QPID_LOG(error, id << ": " << e.what());
@@ -85,7 +85,8 @@ class Connection : public BrokerContext, public sys::ConnectionCodec, public Man
 
     virtual void process();
     void doOutput(size_t);
-    bool dispatch();
+    bool dispatch(size_t bytes);
+    size_t getOutgoingLinkCount() const;
     void processDeliveries();
     std::string getError();
     void close();
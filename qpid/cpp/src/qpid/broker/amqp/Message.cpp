@@ -45,6 +45,25 @@ using qpid::amqp::Reader;
 
 namespace {
 std::string empty;
+
+/**
+ * The header of a first delivery with no ttl: only durability and
+ * priority vary from message to message.
+ */
+class FirstDeliveryHeader : public qpid::amqp::MessageEncoder::Header
+{
+  public:
+    FirstDeliveryHeader(bool d, uint8_t p) : durable(d), priority(p) {}
+    bool isDurable() const { return durable; }
+    uint8_t getPriority() const { return priority; }
+    bool hasTtl() const { return false; }
+    uint32_t getTtl() const { return 0; }
+    bool isFirstAcquirer() const { return true; }
+    uint32_t getDeliveryCount() const { return 0; }
+  private:
+    bool durable;
+    uint8_t priority;
+};
 }
 
 std::string Message::getRoutingKey() const
@@ -235,7 +254,7 @@ std::string Message::getContent() const
     return std::string(body.data, body.size);
 }
 
-Message::Message(size_t size) : data(size), bodyDescriptor(0)
+Message::Message(size_t size) : data(size), bodyDescriptor(0), firstDeliveryHeaderSize(0)
 {
     deliveryAnnotations.init();
     messageAnnotations.init();
@@ -251,6 +270,7 @@ Message::Message(size_t size) : data(size), bodyDescriptor(0)
     applicationProperties.init();
     body.init();
     footer.init();
+    sectionsAfterHeader.init();
 }
 char* Message::getData() { return &data[0]; }
 const char* Message::getData() const { return &data[0]; }
@@ -310,6 +330,32 @@ void Message::scan()
     if (bareMessage.data && !bareMessage.size) {
         bareMessage.size = getSize() - (bareMessage.data - getData());
     }
+
+    qpid::amqp::MessageEncoder encoder(firstDeliveryHeader, sizeof(firstDeliveryHeader));
+    encoder.writeHeader(FirstDeliveryHeader(isPersistent(), getPriority()));
+    firstDeliveryHeaderSize = encoder.getPosition();
+
+    sectionsAfterHeader.init();
+    const CharSequence* sections[] = { &deliveryAnnotations, &messageAnnotations, &bareMessage, &footer };
+    const char* start(0);
+    size_t total(0);
+    for (size_t i = 0; i < sizeof(sections)/sizeof(sections[0]); ++i) {
+        if (!sections[i]->size) continue;
+        if (!start) start = sections[i]->data;
+        else if (sections[i]->data != start + total) return;//not contiguous
+        total += sections[i]->size;
+    }
+    if (start) sectionsAfterHeader = CharSequence::create(start, total);
+}
+
+CharSequence Message::getFirstDeliveryHeader() const
+{
+    return CharSequence::create(firstDeliveryHeader, firstDeliveryHeaderSize);
+}
+
+CharSequence Message::getSectionsAfterHeader() const
+{
+    return sectionsAfterHeader;
 }
 
 const Message& Message::get(const qpid::broker::Message& message)
@@ -73,6 +73,21 @@ class Message : public qpid::broker::Message::SharedStateImpl, private qpid::amq
     qpid::types::Variant getTypedBody() const;
     const qpid::amqp::Descriptor& getBodyDescriptor() const;
 
+    /**
+     * @returns the encoded header for the first delivery of this
+     * message when it has no ttl. That is the same for every
+     * subscriber, so it is encoded once when the message is scanned,
+     * into a few bytes held on the message, rather than for each
+     * delivery.
+     */
+    qpid::amqp::CharSequence getFirstDeliveryHeader() const;
+    /**
+     * @returns the delivery and message annotations, bare message and
+     * footer as one sequence so they can be sent with a single write,
+     * or an empty sequence if they are not contiguous in the data.
+     */
+    qpid::amqp::CharSequence getSectionsAfterHeader() const;
+
     Message(size_t size);
     char* getData();
     const char* getData() const;
@@ -125,6 +140,11 @@ class Message : public qpid::broker::Message::SharedStateImpl, private qpid::amq
     //footer:
     qpid::amqp::CharSequence footer;
 
+    //encodings shared by all outgoing 1.0 deliveries:
+    char firstDeliveryHeader[16];
+    size_t firstDeliveryHeaderSize;
+    qpid::amqp::CharSequence sectionsAfterHeader;
+
     //header:
     void onDurable(bool b);
     void onPriority(uint8_t i);
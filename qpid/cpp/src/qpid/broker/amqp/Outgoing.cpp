@@ -21,6 +21,7 @@
 #include "qpid/broker/amqp/Outgoing.h"
 #include "qpid/broker/amqp/Exception.h"
 #include "qpid/broker/amqp/Header.h"
+#include "qpid/broker/amqp/Message.h"
 #include "qpid/broker/amqp/Session.h"
 #include "qpid/broker/amqp/Translation.h"
 #include "qpid/broker/Queue.h"
@@ -65,7 +66,7 @@ OutgoingFromQueue::OutgoingFromQueue(Broker& broker, const std::string& source,
       exclusive(e),
       isControllingUser(p),
       queue(q), deliveries(5000), link(l), out(o),
-      current(0),
+      current(0), written(0),
       buffer(1024)/*used only for header at present*/,
       //for exclusive queues, assume unreliable unless reliable is explicitly requested; otherwise assume reliable unless unreliable requested
       unreliable(exclusive ? !requested_reliable(link) : requested_unreliable(link)),
@@ -82,20 +83,28 @@ void OutgoingFromQueue::init()
     queue->consume(shared_from_this(), exclusive);//may throw exception
 }
 
-bool OutgoingFromQueue::doWork()
+bool OutgoingFromQueue::doWork(OutputBudget& budget)
 {
     QPID_LOG(trace, "Dispatching to " << getName() << ": " << pn_link_credit(link));
+    size_t share = budget.take();
     if (canDeliver()) {
+        bool worked(false);
+        written = 0;
         try{
-            if (queue->dispatch(shared_from_this())) {
-                return true;
-            } else {
-                pn_link_drained(link);
-                QPID_LOG(trace, "No message available on " << queue->getName());
-            }
+            do {
+                if (queue->dispatch(shared_from_this())) {
+                    worked = true;
+                } else {
+                    pn_link_drained(link);
+                    QPID_LOG(trace, "No message available on " << queue->getName());
+                    break;
+                }
+            } while (written < share && canDeliver());
         } catch (const qpid::framing::ResourceDeletedException& e) {
             throw Exception(qpid::amqp::error_conditions::RESOURCE_DELETED, e.what());
         }
+        budget.spend(written);
+        return worked;
     } else {
         QPID_LOG(trace, "Can't deliver to " << getName() << " from " << queue->getName() << ": " << pn_link_credit(link));
     }
@@ -105,6 +114,7 @@ bool OutgoingFromQueue::doWork()
 void OutgoingFromQueue::write(const char* data, size_t size)
 {
     pn_link_send(link, data, size);
+    written += size;
 }
 
 void OutgoingFromQueue::handle(pn_delivery_t* delivery)
@@ -195,9 +205,17 @@ bool OutgoingFromQueue::deliver(const QueueCursor& cursor, const qpid::broker::M
     r.msg = msg;
     r.delivery = pn_delivery(link, r.tag);
     //write header
-    qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
-    encoder.writeHeader(Header(r.msg));
-    write(&buffer[0], encoder.getPosition());
+    Header header(r.msg);
+    const Message* native = dynamic_cast<const Message*>(&r.msg.getEncoding());
+    if (native && header.isFirstAcquirer() && !header.getDeliveryCount() && !header.hasTtl()) {
+        //same for every subscriber, so shared rather than encoded per delivery
+        qpid::amqp::CharSequence shared = native->getFirstDeliveryHeader();
+        if (shared.size) write(shared.data, shared.size);
+    } else {
+        qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
+        encoder.writeHeader(header);
+        write(&buffer[0], encoder.getPosition());
+    }
     Translation t(r.msg);
     t.write(*this);
     if (pn_link_advance(link)) {
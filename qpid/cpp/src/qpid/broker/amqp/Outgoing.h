@@ -25,6 +25,7 @@
 #include "qpid/broker/amqp/ManagedOutgoingLink.h"
 #include "qpid/broker/Consumer.h"
 
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -56,6 +57,33 @@ class CircularArray
     size_t next;
 };
 
+/**
+ * The bytes one pass over a connection's outgoing links may send. Each
+ * link in turn is offered an equal share of what the links before it
+ * left unused, so a busy link can use the space that idle links leave.
+ */
+class OutputBudget
+{
+  public:
+    OutputBudget(size_t b, size_t l) : bytes(b), links(l) {}
+    /**
+     * @returns the share of the remaining bytes for the next link
+     */
+    size_t take()
+    {
+        size_t share = links ? bytes / links : bytes;
+        if (links) --links;
+        return share;
+    }
+    /**
+     * Records bytes sent by a link against the remaining budget
+     */
+    void spend(size_t n) { bytes -= std::min(bytes, n); }
+  private:
+    size_t bytes;
+    size_t links;
+};
+
 class Outgoing : public ManagedOutgoingLink
 {
   public:
@@ -64,9 +92,11 @@ class Outgoing : public ManagedOutgoingLink
     virtual void setSelectorFilter(const std::string&) = 0;
     virtual void init() = 0;
     /**
-     * Allows the link to initiate any outgoing transfers
+     * Allows the link to initiate any outgoing transfers. The link
+     * takes its share of the budget and spends what it sends; a link
+     * that can send always sends at least one message.
      */
-    virtual bool doWork() = 0;
+    virtual bool doWork(OutputBudget& budget) = 0;
     /**
      * Signals that this link has been detached
      */
@@ -94,7 +124,7 @@ class OutgoingFromQueue : public Outgoing, public qpid::broker::Consumer, public
     void setSubjectFilter(const std::string&);
     void setSelectorFilter(const std::string&);
     void init();
-    bool doWork();
+    bool doWork(OutputBudget& budget);
     void write(const char* data, size_t size);
     void handle(pn_delivery_t* delivery);
     bool canDeliver();
@@ -140,6 +170,7 @@ class OutgoingFromQueue : public Outgoing, public qpid::broker::Consumer, public
     pn_link_t* link;
     qpid::sys::OutputControl& out;
     size_t current;
+    size_t written;//bytes written in current call to doWork()
     std::vector<char> buffer;
     std::string subjectFilter;
     boost::scoped_ptr<Selector> selector;
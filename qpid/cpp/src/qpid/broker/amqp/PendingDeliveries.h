@@ -0,0 +1,109 @@
+#ifndef QPID_BROKER_AMQP_PENDINGDELIVERIES_H
+#define QPID_BROKER_AMQP_PENDINGDELIVERIES_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/sys/IntegerTypes.h"
+#include "qpid/sys/unordered_map.h"
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace qpid {
+namespace broker {
+namespace amqp {
+
+/**
+ * Incoming deliveries waiting to be accepted, and those that have
+ * completed asynchronously but are not yet settled. The IO thread takes
+ * the completed deliveries as a batch, in the order they were received:
+ * store completions may arrive out of order, and settling in order lets
+ * the transport coalesce the dispositions of consecutive deliveries into
+ * a single frame.
+ *
+ * Not thread safe, the Session calls it with its lock held.
+ */
+template <class Delivery> class PendingDeliveries
+{
+  public:
+    PendingDeliveries() : received(0) {}
+
+    void add(Delivery d) { pending[d] = received++; }
+
+    bool isPending(Delivery d) const { return pending.find(d) != pending.end(); }
+
+    /** @return true if d was pending. */
+    bool remove(Delivery d) { return pending.erase(d) != 0; }
+
+    /** Remove the pending deliveries for which f returns true. */
+    template <class F> void removeIf(F f) {
+        for (typename Map::iterator i = pending.begin(); i != pending.end();) {
+            if (f(i->first)) pending.erase(i++);
+            else ++i;
+        }
+    }
+
+    /**
+     * A pending delivery has completed.
+     *@return true if it is the first completion since the last take(),
+     * so the IO thread must be woken to take the batch.
+     */
+    bool complete(Delivery d) {
+        if (!isPending(d)) return false;
+        completed.push_back(d);
+        return completed.size() == 1;
+    }
+
+    /**
+     * Take the completed deliveries that are still pending, in the order
+     * they were received. They are no longer pending.
+     *@return false if there were no completions to take.
+     */
+    bool take(std::vector<Delivery>& settle) {
+        if (completed.empty()) return false;
+        std::vector<std::pair<uint64_t, Delivery> > ordered;
+        ordered.reserve(completed.size());
+        for (typename std::deque<Delivery>::iterator i = completed.begin(); i != completed.end(); ++i) {
+            typename Map::iterator p = pending.find(*i);
+            if (p != pending.end()) {
+                ordered.push_back(std::make_pair(p->second, *i));
+                pending.erase(p);
+            }
+        }
+        completed.clear();
+        std::sort(ordered.begin(), ordered.end());
+        settle.reserve(settle.size() + ordered.size());
+        for (size_t i = 0; i < ordered.size(); ++i) settle.push_back(ordered[i].second);
+        return true;
+    }
+
+  private:
+    typedef qpid::sys::unordered_map<Delivery, uint64_t> Map;
+    Map pending;                // Value is the order received.
+    std::deque<Delivery> completed;
+    uint64_t received;
+};
+
+}}} // namespace qpid::broker::amqp
+
+#endif  /*!QPID_BROKER_AMQP_PENDINGDELIVERIES_H*/
@@ -121,10 +121,13 @@ OutgoingFromRelay::OutgoingFromRelay(pn_link_t* l, Broker& broker, Session& pare
                                      const std::string& target, const std::string& name_, boost::shared_ptr<Relay> r)
     : Outgoing(broker, parent, source, target, name_), name(name_), link(l), relay(r) {}
 /**
- * Allows the link to initiate any outgoing transfers
+ * Allows the link to initiate any outgoing transfers. The relay sends
+ * whatever it has buffered, which its credit already bounds, so it
+ * spends none of its share and leaves it to the other links.
  */
-bool OutgoingFromRelay::doWork()
+bool OutgoingFromRelay::doWork(OutputBudget& budget)
 {
+    budget.take();
     relay->check();
     relay->setCredit(pn_link_credit(link));
     bool worked = relay->send(link);
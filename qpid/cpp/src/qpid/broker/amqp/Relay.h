@@ -98,7 +98,7 @@ class OutgoingFromRelay : public Outgoing
   public:
     OutgoingFromRelay(pn_link_t*, Broker&, Session&, const std::string& source,
                       const std::string& target, const std::string& name, boost::shared_ptr<Relay>);
-    bool doWork();
+    bool doWork(OutputBudget& budget);
     void handle(pn_delivery_t* delivery);
     void detached(bool closed);
     void init();
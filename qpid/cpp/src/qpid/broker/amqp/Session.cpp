@@ -53,6 +53,7 @@
 #include <boost/format.hpp>
 #include <map>
 #include <sstream>
+#include <vector>
 extern "C" {
 #include <proton/engine.h>
 }
@@ -646,32 +647,33 @@ void Session::detach(pn_link_t* link, bool closed)
 void Session::pending_accept(pn_delivery_t* delivery)
 {
     qpid::sys::Mutex::ScopedLock l(lock);
-    pending.insert(delivery);
+    pending.add(delivery);
 }
 
 bool Session::clear_pending(pn_delivery_t* delivery)
 {
     qpid::sys::Mutex::ScopedLock l(lock);
-    std::set<pn_delivery_t*>::iterator i = pending.find(delivery);
-    if (i != pending.end()) {
-        pending.erase(i);
+    return pending.remove(delivery);
+}
+
+namespace {
+struct SettleIfOnLink
+{
+    pn_link_t* link;
+    SettleIfOnLink(pn_link_t* l) : link(l) {}
+    bool operator()(pn_delivery_t* delivery) const
+    {
+        if (pn_delivery_link(delivery) != link) return false;
+        pn_delivery_settle(delivery);
         return true;
-    } else {
-        return false;
     }
+};
 }
 
 void Session::abort_pending(pn_link_t* link)
 {
     qpid::sys::Mutex::ScopedLock l(lock);
-    for (std::set<pn_delivery_t*>::iterator i = pending.begin(); i != pending.end();) {
-        if (pn_delivery_link(*i) == link) {
-            pn_delivery_settle(*i);
-            pending.erase(i++);
-        } else {
-            ++i;
-        }
-    }
+    pending.removeIf(SettleIfOnLink(link));
 }
 
 void Session::accepted(pn_delivery_t* delivery, bool sync)
@@ -687,13 +689,27 @@ void Session::accepted(pn_delivery_t* delivery, bool sync)
     } else {
         //this is not on IO thread, need to delay processing until on IO thread
         qpid::sys::Mutex::ScopedLock l(lock);
-        if (!deleted && pending.find(delivery) != pending.end()) {
-            completed.push_back(delivery);
-            out.activateOutput();
-        }
+        //output is already activated if earlier completions are still queued
+        if (!deleted && pending.complete(delivery)) out.activateOutput();
     }
 }
 
+bool Session::settle_completed()
+{
+    std::vector<pn_delivery_t*> settled;
+    {
+        qpid::sys::Mutex::ScopedLock l(lock);
+        if (!pending.take(settled)) return false;
+    }
+    //in the order received, see PendingDeliveries
+    for (std::vector<pn_delivery_t*>::iterator i = settled.begin(); i != settled.end(); ++i) {
+        pn_delivery_update(*i, PN_ACCEPTED);
+        pn_delivery_settle(*i);
+        incomingMessageAccepted();
+    }
+    return true;
+}
+
 void Session::readable(pn_link_t* link, pn_delivery_t* delivery)
 {
     pn_delivery_tag_t tag = pn_delivery_tag(delivery);
@@ -725,7 +741,12 @@ void Session::writable(pn_link_t* link, pn_delivery_t* delivery)
     }
 }
 
-bool Session::dispatch()
+size_t Session::getOutgoingLinkCount() const
+{
+    return outgoing.size();
+}
+
+bool Session::dispatch(OutputBudget& budget)
 {
     bool output(false);
     if (tx.commitPending.boolCompareAndSwap(true, false)) {
@@ -733,7 +754,7 @@ bool Session::dispatch()
     }
     for (OutgoingLinks::iterator s = outgoing.begin(); s != outgoing.end();) {
         try {
-            if (s->second->doWork()) output = true;
+            if (s->second->doWork(budget)) output = true;
             ++s;
         } catch (const Exception& e) {
             pn_condition_t* error = pn_link_condition(s->first);
@@ -745,17 +766,7 @@ bool Session::dispatch()
             output = true;
         }
     }
-    if (completed.size()) {
-        output = true;
-        std::deque<pn_delivery_t*> copy;
-        {
-            qpid::sys::Mutex::ScopedLock l(lock);
-            completed.swap(copy);
-        }
-        for (std::deque<pn_delivery_t*>::iterator i = copy.begin(); i != copy.end(); ++i) {
-            accepted(*i, true);
-        }
-    }
+    if (settle_completed()) output = true;
     for (IncomingLinks::iterator i = incoming.begin(); i != incoming.end();) {
         try {
             if (i->second->doWork()) output = true;
@@ -27,7 +27,7 @@
 #include "qpid/broker/amqp/Authorise.h"
 #include "qpid/broker/amqp/ManagedSession.h"
 #include "qpid/broker/amqp/NodeProperties.h"
-#include <deque>
+#include "qpid/broker/amqp/PendingDeliveries.h"
 #include <map>
 #include <set>
 #include <boost/intrusive_ptr.hpp>
@@ -52,6 +52,7 @@ namespace amqp {
 class Connection;
 class Incoming;
 class Outgoing;
+class OutputBudget;
 class Relay;
 class Topic;
 /**
@@ -68,7 +69,12 @@ class Session : public ManagedSession, public boost::enable_shared_from_this<Ses
     void detach(pn_link_t*, bool closed);
     void readable(pn_link_t*, pn_delivery_t*);
     void writable(pn_link_t*, pn_delivery_t*);
-    bool dispatch();
+    /**
+     * Allows links to do any work that requires output. Outgoing links
+     * send up to their share of the budget.
+     */
+    bool dispatch(OutputBudget& budget);
+    size_t getOutgoingLinkCount() const;
     bool endedByManagement() const;
     void close();
 
@@ -105,8 +111,7 @@ class Session : public ManagedSession, public boost::enable_shared_from_this<Ses
     qpid::sys::OutputControl& out;
     IncomingLinks incoming;
     OutgoingLinks outgoing;
-    std::deque<pn_delivery_t*> completed;
-    std::set<pn_delivery_t*> pending;
+    PendingDeliveries<pn_delivery_t*> pending;
     bool deleted;
     qpid::sys::Mutex lock;
     std::set< boost::shared_ptr<Queue> > exclusiveQueues;
@@ -144,6 +149,7 @@ class Session : public ManagedSession, public boost::enable_shared_from_this<Ses
     std::string qualifyName(const std::string&);
     bool clear_pending(pn_delivery_t*);//tests and clears pending status for delivery
     void abort_pending(pn_link_t*);//removes pending status for all deliveries associated with link
+    bool settle_completed();//accepts and settles all deliveries completed since last called
 };
 }}} // namespace qpid::broker::amqp
 
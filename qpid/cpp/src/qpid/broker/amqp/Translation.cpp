@@ -42,6 +42,7 @@ const std::string FORWARD_SLASH("/");
 const std::string TEXT_PLAIN("text/plain");
 const std::string SUBJECT_KEY("qpid.subject");
 const std::string APP_ID("x-amqp-0-10.app-id");
+const std::string AMQP_1_0("amqp1.0");
 
 qpid::framing::ReplyTo translate(const std::string address, Broker* broker)
 {
@@ -151,6 +152,56 @@ class Properties_0_10 : public qpid::amqp::MessageEncoder::Properties
         return transfer.getMethod<qpid::framing::MessageTransferBody>()->getDestination();
     }
 };
+
+/**
+ * The 1.0 bare message translated from an 0-10 transfer.
+ */
+class EncodedBareMessage : public qpid::RefCounted
+{
+  public:
+    std::vector<char> data;
+};
+
+void encode(const qpid::broker::amqp_0_10::MessageTransfer& transfer, std::vector<char>& buffer)
+{
+    Properties_0_10 properties(transfer);
+    qpid::types::Variant::Map applicationProperties;
+    qpid::amqp_0_10::translate(properties.getApplicationProperties(), applicationProperties);
+    if (properties.getContentType() == qpid::amqp_0_10::MapCodec::contentType) {
+        qpid::types::Variant::Map content;
+        qpid::amqp_0_10::MapCodec::decode(transfer.getContent(), content);
+        size_t size = qpid::amqp::MessageEncoder::getEncodedSize(properties);
+        size += qpid::amqp::MessageEncoder::getEncodedSize(applicationProperties, true) + 3;/*descriptor*/
+        size += qpid::amqp::MessageEncoder::getEncodedSize(content, true) + 3/*descriptor*/;
+        buffer.resize(size);
+        qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
+        encoder.writeProperties(properties);
+        encoder.writeApplicationProperties(applicationProperties);
+        encoder.writeMap(content, &qpid::amqp::message::AMQP_VALUE);
+        buffer.resize(encoder.getPosition());
+    } else if (properties.getContentType() == qpid::amqp_0_10::ListCodec::contentType) {
+        qpid::types::Variant::List content;
+        qpid::amqp_0_10::ListCodec::decode(transfer.getContent(), content);
+        size_t size = qpid::amqp::MessageEncoder::getEncodedSize(properties);
+        size += qpid::amqp::MessageEncoder::getEncodedSize(applicationProperties, true) + 3;/*descriptor*/
+        size += qpid::amqp::MessageEncoder::getEncodedSize(content, true) + 3/*descriptor*/;
+        buffer.resize(size);
+        qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
+        encoder.writeProperties(properties);
+        encoder.writeApplicationProperties(applicationProperties);
+        encoder.writeList(content, &qpid::amqp::message::AMQP_VALUE);
+        buffer.resize(encoder.getPosition());
+    } else {
+        std::string content = transfer.getContent();
+        size_t size = qpid::amqp::MessageEncoder::getEncodedSize(properties, applicationProperties, content);
+        buffer.resize(size);
+        qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
+        encoder.writeProperties(properties);
+        encoder.writeApplicationProperties(applicationProperties);
+        if (content.size()) encoder.writeBinary(content, &qpid::amqp::message::DATA);
+        buffer.resize(encoder.getPosition());
+    }
+}
 }
 
 Translation::Translation(const qpid::broker::Message& m, Broker* b) : original(m), broker(b) {}
@@ -283,6 +334,12 @@ void Translation::write(OutgoingFromQueue& out)
     //persistent context will contain any newly added annotations
     if (!message) message = dynamic_cast<const Message*>(&original.getEncoding());
     if (message) {
+        //annotations, bare message and footer are usually contiguous
+        qpid::amqp::CharSequence sections = message->getSectionsAfterHeader();
+        if (sections.size) {
+            out.write(sections.data, sections.size);
+            return;
+        }
         //write annotations
         qpid::amqp::CharSequence deliveryAnnotations = message->getDeliveryAnnotations();
         qpid::amqp::CharSequence messageAnnotations = message->getMessageAnnotations();
@@ -297,43 +354,16 @@ void Translation::write(OutgoingFromQueue& out)
     } else {
         const qpid::broker::amqp_0_10::MessageTransfer* transfer = dynamic_cast<const qpid::broker::amqp_0_10::MessageTransfer*>(&original.getEncoding());
         if (transfer) {
-            Properties_0_10 properties(*transfer);
-            qpid::types::Variant::Map applicationProperties;
-            qpid::amqp_0_10::translate(properties.getApplicationProperties(), applicationProperties);
-            if (properties.getContentType() == qpid::amqp_0_10::MapCodec::contentType) {
-                qpid::types::Variant::Map content;
-                qpid::amqp_0_10::MapCodec::decode(transfer->getContent(), content);
-                size_t size = qpid::amqp::MessageEncoder::getEncodedSize(properties);
-                size += qpid::amqp::MessageEncoder::getEncodedSize(applicationProperties, true) + 3;/*descriptor*/
-                size += qpid::amqp::MessageEncoder::getEncodedSize(content, true) + 3/*descriptor*/;
-                std::vector<char> buffer(size);
-                qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
-                encoder.writeProperties(properties);
-                encoder.writeApplicationProperties(applicationProperties);
-                encoder.writeMap(content, &qpid::amqp::message::AMQP_VALUE);
-                out.write(&buffer[0], encoder.getPosition());
-            } else if (properties.getContentType() == qpid::amqp_0_10::ListCodec::contentType) {
-                qpid::types::Variant::List content;
-                qpid::amqp_0_10::ListCodec::decode(transfer->getContent(), content);
-                size_t size = qpid::amqp::MessageEncoder::getEncodedSize(properties);
-                size += qpid::amqp::MessageEncoder::getEncodedSize(applicationProperties, true) + 3;/*descriptor*/
-                size += qpid::amqp::MessageEncoder::getEncodedSize(content, true) + 3/*descriptor*/;
-                std::vector<char> buffer(size);
-                qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
-                encoder.writeProperties(properties);
-                encoder.writeApplicationProperties(applicationProperties);
-                encoder.writeList(content, &qpid::amqp::message::AMQP_VALUE);
-                out.write(&buffer[0], encoder.getPosition());
-            } else {
-                std::string content = transfer->getContent();
-                size_t size = qpid::amqp::MessageEncoder::getEncodedSize(properties, applicationProperties, content);
-                std::vector<char> buffer(size);
-                qpid::amqp::MessageEncoder encoder(&buffer[0], buffer.size());
-                encoder.writeProperties(properties);
-                encoder.writeApplicationProperties(applicationProperties);
-                if (content.size()) encoder.writeBinary(content, &qpid::amqp::message::DATA);
-                out.write(&buffer[0], encoder.getPosition());
+            //the translation is the same for every 1.0 consumer, so cache it on the message
+            boost::intrusive_ptr<const qpid::RefCounted> cached = original.getTranslation(AMQP_1_0);
+            const EncodedBareMessage* encoded = dynamic_cast<const EncodedBareMessage*>(cached.get());
+            if (!encoded) {
+                boost::intrusive_ptr<EncodedBareMessage> translated(new EncodedBareMessage());
+                encode(*transfer, translated->data);
+                cached = original.setTranslation(AMQP_1_0, translated);
+                encoded = dynamic_cast<const EncodedBareMessage*>(cached.get());
             }
+            if (encoded->data.size()) out.write(&encoded->data[0], encoded->data.size());
         } else {
             QPID_LOG(error, "Could not write message data in AMQP 1.0 format");
         }
@@ -170,8 +170,16 @@ void Connection::requestIOProcessing(boost::function0<void> callback)
     if (isOpen()) out->activateOutput();
 }
 
+void Connection::requestHandshakeProcessing(boost::function0<void> callback)
+{
+    ScopedLock<Mutex> l(ioCallbackLock);
+    handshakeCallbacks.push(callback);
+    out->activateOutput();
+}
+
 Connection::~Connection()
 {
+    adapter.cancelAuthentication();
     if (mgmtObject != 0) {
         mgmtObject->debugStats("destroying");
         if (!link)
@@ -379,6 +387,15 @@ void Connection::closed(){ // Physically closed, suspend open sessions.
 }
 
 void Connection::doIoCallbacks() {
+    {
+        ScopedLock<Mutex> l(ioCallbackLock);
+        while (!handshakeCallbacks.empty()) {
+            boost::function0<void> cb = handshakeCallbacks.front();
+            handshakeCallbacks.pop();
+            ScopedUnlock<Mutex> ul(ioCallbackLock);
+            cb();
+        }
+    }
     if (!isOpen()) return; // Don't process IO callbacks until we are open.
     ScopedLock<Mutex> l(ioCallbackLock);
     while (!ioCallbacks.empty()) {
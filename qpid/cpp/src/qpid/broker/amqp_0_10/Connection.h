@@ -137,6 +137,10 @@ class Connection : public sys::ConnectionInputHandler, public qpid::broker::Conn
         ManagementMethod (uint32_t methodId, management::Args& args, std::string&);
 
     void requestIOProcessing (boost::function0<void>);
+    /** Like requestIOProcessing, but the callback is run even if the
+     * connection is not yet open. Used to complete the handshake.
+     */
+    void requestHandshakeProcessing (boost::function0<void>);
     void recordFromServer (const framing::AMQFrame& frame);
     void recordFromClient (const framing::AMQFrame& frame);
 
@@ -207,6 +211,7 @@ class Connection : public sys::ConnectionInputHandler, public qpid::broker::Conn
     const std::string mgmtId;
     sys::Mutex ioCallbackLock;
     std::queue<boost::function0<void> > ioCallbacks;
+    std::queue<boost::function0<void> > handshakeCallbacks;
     LinkRegistry& links;
     management::ManagementAgent* agent;
     sys::Timer& timer;
@@ -39,6 +39,7 @@
 #include "qpid/Msg.h"
 #include "qpid/types/Exception.h"
 
+#include <deque>
 #include <iostream>
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
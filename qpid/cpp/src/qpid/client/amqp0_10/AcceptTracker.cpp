@@ -49,6 +49,17 @@ SequenceSet AcceptTracker::State::accept(qpid::framing::SequenceNumber id, bool
     return accepting;
 }
 
+SequenceSet AcceptTracker::State::accept(const qpid::framing::SequenceSet& ids)
+{
+    SequenceSet accepting;
+    for (SequenceSet::iterator i = ids.begin(); i != ids.end(); ++i) {
+        if (unaccepted.contains(*i)) accepting.add(*i);
+    }
+    unaccepted.remove(accepting);
+    unconfirmed.add(accepting);
+    return accepting;
+}
+
 void AcceptTracker::State::release()
 {
     unaccepted.clear();
@@ -105,6 +116,17 @@ void AcceptTracker::accept(qpid::framing::SequenceNumber id, qpid::client::Async
     addToPending(session, record);
 }
 
+void AcceptTracker::accept(const qpid::framing::SequenceSet& ids, qpid::client::AsyncSession& session)
+{
+    for (StateMap::iterator i = destinationState.begin(); i != destinationState.end(); ++i) {
+        i->second.accept(ids);
+    }
+    Record record;
+    record.accepted = aggregateState.accept(ids);
+    record.status = session.messageAccept(record.accepted);
+    addToPending(session, record);
+}
+
 void AcceptTracker::release(qpid::client::AsyncSession& session)
 {
     session.messageRelease(aggregateState.unaccepted);
@@ -43,6 +43,7 @@ class AcceptTracker
     void delivered(const std::string& destination, const qpid::framing::SequenceNumber& id);
     void accept(qpid::client::AsyncSession&);
     void accept(qpid::framing::SequenceNumber, qpid::client::AsyncSession&, bool cumulative);
+    void accept(const qpid::framing::SequenceSet&, qpid::client::AsyncSession&);
     void release(qpid::client::AsyncSession&);
     uint32_t acceptsPending();
     uint32_t acceptsPending(const std::string& destination);
@@ -63,6 +64,7 @@ class AcceptTracker
 
         void accept();
         qpid::framing::SequenceSet accept(qpid::framing::SequenceNumber, bool cumulative);
+        qpid::framing::SequenceSet accept(const qpid::framing::SequenceSet&);
         void release();
         uint32_t acceptsPending();
         void completed(qpid::framing::SequenceSet&);
@@ -89,7 +89,8 @@ bool expired(const sys::AbsTime& start, double timeout)
 ConnectionImpl::ConnectionImpl(const std::string& url, const Variant::Map& options) :
     replaceUrls(false), autoReconnect(false), timeout(FOREVER), limit(-1),
     minReconnectInterval(0.001), maxReconnectInterval(2),
-    retries(0), reconnectOnLimitExceeded(true), disableAutoDecode(false)
+    retries(0), reconnectOnLimitExceeded(true), disableAutoDecode(false),
+    adaptiveCapacity(false), adaptiveCapacityMin(1), adaptiveCapacityMax(65535)
 {
     setOptions(options);
     urls.insert(urls.begin(), url);
@@ -163,6 +164,12 @@ void ConnectionImpl::setOption(const std::string& name, const Variant& value)
         amqp_0_10::translate(value.asMap(), settings.clientProperties);
     } else if (name == "disable-auto-decode" || name == "disable_auto_decode") {
         disableAutoDecode = value;
+    } else if (name == "adaptive-capacity" || name == "adaptive_capacity") {
+        adaptiveCapacity = value;
+    } else if (name == "adaptive-capacity-min" || name == "adaptive_capacity_min") {
+        adaptiveCapacityMin = value;
+    } else if (name == "adaptive-capacity-max" || name == "adaptive_capacity_max") {
+        adaptiveCapacityMax = value;
     } else {
         throw qpid::messaging::MessagingException(QPID_MSG("Invalid option: " << name << " not recognised"));
     }
@@ -396,6 +403,12 @@ bool ConnectionImpl::getAutoDecode() const
 {
     return !disableAutoDecode;
 }
+std::auto_ptr<qpid::messaging::AdaptiveCredit> ConnectionImpl::createAdaptiveCredit() const
+{
+    std::auto_ptr<qpid::messaging::AdaptiveCredit> credit;
+    if (adaptiveCapacity) credit.reset(new qpid::messaging::AdaptiveCredit(adaptiveCapacityMin, adaptiveCapacityMax));
+    return credit;
+}
 bool ConnectionImpl::getAutoReconnect() const
 {
     return autoReconnect;
@@ -21,6 +21,7 @@
  * under the License.
  *
  */
+#include "qpid/messaging/AdaptiveCredit.h"
 #include "qpid/messaging/ConnectionImpl.h"
 #include "qpid/types/Variant.h"
 #include "qpid/client/Connection.h"
@@ -28,6 +29,7 @@
 #include "qpid/sys/Mutex.h"
 #include "qpid/sys/Semaphore.h"
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace qpid {
@@ -58,6 +60,7 @@ class ConnectionImpl : public qpid::messaging::ConnectionImpl
     std::string getUrl() const;
     bool getAutoDecode() const;
     bool getAutoReconnect() const;
+    std::auto_ptr<qpid::messaging::AdaptiveCredit> createAdaptiveCredit() const;
   private:
     typedef std::map<std::string, qpid::messaging::Session> Sessions;
 
@@ -76,6 +79,9 @@ class ConnectionImpl : public qpid::messaging::ConnectionImpl
     int32_t retries;
     bool reconnectOnLimitExceeded;
     bool disableAutoDecode;
+    bool adaptiveCapacity;
+    uint32_t adaptiveCapacityMin;
+    uint32_t adaptiveCapacityMax;
 
     void setOptions(const qpid::types::Variant::Map& options);
     void connect(const qpid::sys::AbsTime& started);
@@ -177,6 +177,38 @@ bool IncomingMessages::get(Handler& handler, qpid::sys::Duration timeout)
     } while (AbsTime::now() < deadline);
     return false;
 }
+
+/**
+ * Passes up to max messages that are already available to the
+ * handler without waiting, returning the number accepted. The
+ * received list is scanned once under the lock, then the session
+ * queue is pumped unless another thread is already waiting on it.
+ */
+uint32_t IncomingMessages::drain(Handler& handler, uint32_t max)
+{
+    uint32_t count = 0;
+    sys::Mutex::ScopedLock l(lock);
+    for (FrameSetQueue::iterator i = received.begin(); i != received.end() && count < max;)
+    {
+        MessageTransfer transfer(*i, *this);
+        if (transfer.checkExpired()) {
+            i = received.erase(i);
+        } else if (handler.accept(transfer)) {
+            i = received.erase(i);
+            ++count;
+        } else {
+            ++i;
+        }
+    }
+    if (count < max && !inUse) {
+        inUse = true;
+        ScopedRelease release(inUse, lock);
+        sys::Mutex::ScopedUnlock l(lock);
+        while (count < max && process(&handler, 0) == OK) ++count;
+    }
+    return count;
+}
+
 namespace {
 struct Wakeup : public qpid::types::Exception {};
 }
@@ -225,6 +257,11 @@ void IncomingMessages::accept(qpid::framing::SequenceNumber id, bool cumulative)
     acceptTracker.accept(id, session, cumulative);
 }
 
+void IncomingMessages::accept(const qpid::framing::SequenceSet& ids)
+{
+    sys::Mutex::ScopedLock l(lock);
+    acceptTracker.accept(ids, session);
+}
 
 void IncomingMessages::releaseAll()
 {
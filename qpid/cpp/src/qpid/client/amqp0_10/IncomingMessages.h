@@ -73,10 +73,12 @@ class IncomingMessages
     IncomingMessages();
     void setSession(qpid::client::AsyncSession session);
     bool get(Handler& handler, qpid::sys::Duration timeout);
+    uint32_t drain(Handler& handler, uint32_t max);
     void wakeup();
     bool getNextDestination(std::string& destination, qpid::sys::Duration timeout);
     void accept();
     void accept(qpid::framing::SequenceNumber id, bool cumulative);
+    void accept(const qpid::framing::SequenceSet& ids);
     void releaseAll();
     void releasePending(const std::string& destination);
 
@@ -27,6 +27,7 @@
 #include "qpid/messaging/Session.h"
 #include "qpid/amqp_0_10/Codecs.h"
 #include "qpid/types/encodings.h"
+#include "qpid/log/Statement.h"
 
 namespace qpid {
 namespace client {
@@ -40,7 +41,13 @@ void ReceiverImpl::received(qpid::messaging::Message&)
 {
     //TODO: should this be configurable
     sys::Mutex::ScopedLock l(lock);
-    if (capacity && --window <= capacity/2) {
+    uint32_t previous = capacity;
+    if (capacity && adaptive.get() && adaptive->consumed(capacity)) {
+        QPID_LOG(debug, "Adaptive capacity for " << destination << " now " << capacity);
+        if (state == STARTED) resizeFlow(l, previous);
+        session.sendCompletion();
+        window = capacity;
+    } else if (capacity && --window <= capacity/2) {
         session.sendCompletion();
         window = capacity;
     }
@@ -74,6 +81,13 @@ bool ReceiverImpl::fetch(qpid::messaging::Message& message, qpid::messaging::Dur
     return f.result;
 }
 
+uint32_t ReceiverImpl::fetch(std::vector<qpid::messaging::Message>& batch, qpid::messaging::Duration timeout)
+{
+    FetchBatch f(*this, batch, timeout);
+    while (!parent->execute(f)) {}
+    return f.result;
+}
+
 void ReceiverImpl::close()
 {
     execute<Close>();
@@ -111,6 +125,24 @@ void ReceiverImpl::startFlow(const sys::Mutex::ScopedLock&)
     }
 }
 
+/**
+ * In window mode the broker restores credit as deliveries are completed,
+ * so a larger window only needs the difference granted. To shrink it,
+ * completions for what has been consumed are sent first so none are
+ * still pending when the credit is reset to the new window.
+ */
+void ReceiverImpl::resizeFlow(const sys::Mutex::ScopedLock& l, uint32_t previous)
+{
+    if (previous && capacity > previous) {
+        session.messageFlow(destination, CREDIT_UNIT_MESSAGE, capacity - previous);
+        window += capacity - previous;
+    } else {
+        session.sendCompletion();
+        session.messageStop(destination);
+        startFlow(l);
+    }
+}
+
 void ReceiverImpl::init(qpid::client::AsyncSession s, AddressResolution& resolver)
 {
     sys::Mutex::ScopedLock l(lock);
@@ -151,10 +183,11 @@ qpid::messaging::Address ReceiverImpl::getAddress() const
 }
 
 ReceiverImpl::ReceiverImpl(SessionImpl& p, const std::string& name,
-                           const qpid::messaging::Address& a, bool autoDecode_) :
+                           const qpid::messaging::Address& a, bool autoDecode_,
+                           std::auto_ptr<qpid::messaging::AdaptiveCredit> adaptive_) :
 
     parent(&p), destination(name), address(a), byteCredit(0xFFFFFFFF), autoDecode(autoDecode_),
-    state(UNRESOLVED), capacity(0), window(0) {}
+    state(UNRESOLVED), capacity(0), window(0), adaptive(adaptive_) {}
 
 namespace {
 const std::string TEXT_PLAIN("text/plain");
@@ -166,29 +199,39 @@ bool ReceiverImpl::getImpl(qpid::messaging::Message& message, qpid::messaging::D
         sys::Mutex::ScopedLock l(lock);
         if (state == CANCELLED) return false;
     }
+    qpid::sys::AbsTime start(adaptive.get() ? qpid::sys::AbsTime::now() : qpid::sys::AbsTime());
     if (parent->get(*this, message, timeout)) {
-        if (autoDecode) {
-            if (message.getContentType() == qpid::amqp_0_10::MapCodec::contentType) {
-                message.getContentObject() = qpid::types::Variant::Map();
-                decode(message, message.getContentObject().asMap());
-            } else if (message.getContentType() == qpid::amqp_0_10::ListCodec::contentType) {
-                message.getContentObject() = qpid::types::Variant::List();
-                decode(message, message.getContentObject().asList());
-            } else if (!message.getContentBytes().empty()) {
-                message.getContentObject() = message.getContentBytes();
-                if (message.getContentType() == TEXT_PLAIN) {
-                    message.getContentObject().setEncoding(qpid::types::encodings::UTF8);
-                } else {
-                    message.getContentObject().setEncoding(qpid::types::encodings::BINARY);
-                }
-            }
+        if (adaptive.get()) {
+            sys::Mutex::ScopedLock l(lock);
+            adaptive->waited(qpid::sys::Duration(start, qpid::sys::AbsTime::now()));
         }
+        decodeContent(message);
         return true;
     } else {
         return false;
     }
 }
 
+void ReceiverImpl::decodeContent(qpid::messaging::Message& message)
+{
+    if (autoDecode) {
+        if (message.getContentType() == qpid::amqp_0_10::MapCodec::contentType) {
+            message.getContentObject() = qpid::types::Variant::Map();
+            decode(message, message.getContentObject().asMap());
+        } else if (message.getContentType() == qpid::amqp_0_10::ListCodec::contentType) {
+            message.getContentObject() = qpid::types::Variant::List();
+            decode(message, message.getContentObject().asList());
+        } else if (!message.getContentBytes().empty()) {
+            message.getContentObject() = message.getContentBytes();
+            if (message.getContentType() == TEXT_PLAIN) {
+                message.getContentObject().setEncoding(qpid::types::encodings::UTF8);
+            } else {
+                message.getContentObject().setEncoding(qpid::types::encodings::BINARY);
+            }
+        }
+    }
+}
+
 bool ReceiverImpl::fetchImpl(qpid::messaging::Message& message, qpid::messaging::Duration timeout)
 {
     {
@@ -220,6 +263,48 @@ bool ReceiverImpl::fetchImpl(qpid::messaging::Message& message, qpid::messaging:
     }
 }
 
+/**
+ * Waits for the first message of the batch as for a single fetch,
+ * then drains whatever else is already available for this
+ * destination in one pass over the incoming queue. Where the
+ * receiver is not prefetching, credit for the whole batch is issued
+ * up front and any unused credit is flushed before draining.
+ */
+uint32_t ReceiverImpl::fetchImpl(std::vector<qpid::messaging::Message>& batch, qpid::messaging::Duration timeout)
+{
+    if (batch.empty()) return 0;
+    bool prefetching;
+    {
+        sys::Mutex::ScopedLock l(lock);
+        if (state == CANCELLED) return 0;
+
+        prefetching = capacity > 0 && state == STARTED;
+        if (!prefetching) {
+            session.messageSetFlowMode(destination, FLOW_MODE_CREDIT);
+            session.messageFlow(destination, CREDIT_UNIT_MESSAGE, batch.size());
+            session.messageFlow(destination, CREDIT_UNIT_BYTE, 0xFFFFFFFF);
+        }
+    }
+    uint32_t count = parent->get(*this, batch[0], timeout) ? 1 : 0;
+    if (!count || !prefetching) {
+        qpid::client::Session s;
+        {
+            sys::Mutex::ScopedLock l(lock);
+            if (state == CANCELLED) return 0; // Might have been closed during get.
+            s = sync(session);
+        }
+        s.messageFlush(destination);
+        {
+            sys::Mutex::ScopedLock l(lock);
+            startFlow(l); //reallocate credit
+            session.sendCompletion();//ensure previously received messages are signalled as completed
+        }
+    }
+    count += parent->get(*this, batch, count);
+    for (uint32_t i = 0; i < count; ++i) decodeContent(batch[i]);
+    return count;
+}
+
 void ReceiverImpl::closeImpl()
 {
     sys::Mutex::ScopedLock l(lock);
@@ -246,12 +331,12 @@ bool ReceiverImpl::isClosed() const {
 void ReceiverImpl::setCapacityImpl(uint32_t c)
 {
     sys::Mutex::ScopedLock l(lock);
+    if (c && adaptive.get()) c = adaptive->bound(c);
     if (c != capacity) {
+        uint32_t previous = capacity;
         capacity = c;
-        if (state == STARTED) {
-            session.messageStop(destination);
-            startFlow(l);
-        }
+        if (state == STARTED) resizeFlow(l, previous);
+        else window = capacity;
     }
 }
 
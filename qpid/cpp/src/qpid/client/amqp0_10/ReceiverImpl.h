@@ -21,6 +21,7 @@
  * under the License.
  *
  */
+#include "qpid/messaging/AdaptiveCredit.h"
 #include "qpid/messaging/Address.h"
 #include "qpid/messaging/Message.h"
 #include "qpid/messaging/ReceiverImpl.h"
@@ -48,13 +49,15 @@ class ReceiverImpl : public qpid::messaging::ReceiverImpl
     enum State {UNRESOLVED, STOPPED, STARTED, CANCELLED};
 
     ReceiverImpl(SessionImpl& parent, const std::string& name,
-                 const qpid::messaging::Address& address, bool autoDecode);
+                 const qpid::messaging::Address& address, bool autoDecode,
+                 std::auto_ptr<qpid::messaging::AdaptiveCredit> adaptive);
 
     void init(qpid::client::AsyncSession session, AddressResolution& resolver);
     bool get(qpid::messaging::Message& message, qpid::messaging::Duration timeout);
     qpid::messaging::Message get(qpid::messaging::Duration timeout);
     bool fetch(qpid::messaging::Message& message, qpid::messaging::Duration timeout);
     qpid::messaging::Message fetch(qpid::messaging::Duration timeout);
+    uint32_t fetch(std::vector<qpid::messaging::Message>& batch, qpid::messaging::Duration timeout);
     void close();
     void start();
     void stop();
@@ -81,11 +84,15 @@ class ReceiverImpl : public qpid::messaging::ReceiverImpl
     uint32_t capacity;
     qpid::client::AsyncSession session;
     uint32_t window;
+    std::auto_ptr<qpid::messaging::AdaptiveCredit> adaptive;
 
     void startFlow(const sys::Mutex::ScopedLock&); // Dummy param, call with lock held
+    void resizeFlow(const sys::Mutex::ScopedLock&, uint32_t previous); // Dummy param, call with lock held
     //implementation of public facing methods
     bool fetchImpl(qpid::messaging::Message& message, qpid::messaging::Duration timeout);
+    uint32_t fetchImpl(std::vector<qpid::messaging::Message>& batch, qpid::messaging::Duration timeout);
     bool getImpl(qpid::messaging::Message& message, qpid::messaging::Duration timeout);
+    void decodeContent(qpid::messaging::Message& message);
     void closeImpl();
     void setCapacityImpl(uint32_t);
 
@@ -119,6 +126,17 @@ class ReceiverImpl : public qpid::messaging::ReceiverImpl
         void operator()() { result = impl.fetchImpl(message, timeout); }
     };
 
+    struct FetchBatch : Command
+    {
+        std::vector<qpid::messaging::Message>& batch;
+        qpid::messaging::Duration timeout;
+        uint32_t result;
+
+        FetchBatch(ReceiverImpl& i, std::vector<qpid::messaging::Message>& b, qpid::messaging::Duration t) :
+            Command(i), batch(b), timeout(t), result(0) {}
+        void operator()() { result = impl.fetchImpl(batch, timeout); }
+    };
+
     struct Close : Command
     {
         Close(ReceiverImpl& i) : Command(i) {}
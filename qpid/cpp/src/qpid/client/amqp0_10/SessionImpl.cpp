@@ -169,6 +169,12 @@ void SessionImpl::acknowledge(qpid::messaging::Message& m, bool cumulative)
     execute(ack);
 }
 
+void SessionImpl::acknowledge(std::vector<qpid::messaging::Message>& batch, uint32_t count)
+{
+    Acknowledge3 ack(*this, batch, count);
+    execute(ack);
+}
+
 void SessionImpl::close()
 {
     if (hasError()) {
@@ -252,7 +258,7 @@ Receiver SessionImpl::createReceiverImpl(const qpid::messaging::Address& address
     ScopedLock l(lock);
     std::string name = address.getName();
     getFreeKey(name, receivers);
-    Receiver receiver(new ReceiverImpl(*this, name, address, connection->getAutoDecode()));
+    Receiver receiver(new ReceiverImpl(*this, name, address, connection->getAutoDecode(), connection->createAdaptiveCredit()));
     getImplPtr<Receiver, ReceiverImpl>(receiver)->init(session, resolver);
     receivers[name] = receiver;
     return receiver;
@@ -336,6 +342,37 @@ struct IncomingMessageHandler : IncomingMessages::Handler
     }
 };
 
+/**
+ * Retrieves messages for a given receiver into consecutive slots of
+ * a batch until the batch is full.
+ */
+struct BatchHandler : IncomingMessages::Handler
+{
+    ReceiverImpl& receiver;
+    std::vector<qpid::messaging::Message>& batch;
+    uint32_t next;
+
+    BatchHandler(ReceiverImpl& r, std::vector<qpid::messaging::Message>& b, uint32_t offset) :
+        receiver(r), batch(b), next(offset) {}
+
+    bool accept(IncomingMessages::MessageTransfer& transfer)
+    {
+        if (next < batch.size() && receiver.getName() == transfer.getDestination()) {
+            qpid::messaging::Message& message = batch[next++];
+            transfer.retrieve(&message);
+            receiver.received(message);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    bool isClosed()
+    {
+        return receiver.isClosed();
+    }
+};
+
 }
 
 
@@ -387,6 +424,13 @@ bool SessionImpl::get(ReceiverImpl& receiver, qpid::messaging::Message& message,
     return getIncoming(handler, timeout);
 }
 
+uint32_t SessionImpl::get(ReceiverImpl& receiver, std::vector<qpid::messaging::Message>& batch, uint32_t offset)
+{
+    if (offset >= batch.size()) return 0;
+    BatchHandler handler(receiver, batch, offset);
+    return incoming.drain(handler, batch.size() - offset);
+}
+
 bool SessionImpl::nextReceiver(qpid::messaging::Receiver& receiver, qpid::messaging::Duration timeout)
 {
     while (true) {
@@ -532,6 +576,16 @@ void SessionImpl::acknowledgeImpl(qpid::messaging::Message& m, bool cumulative)
     if (!transactional) incoming.accept(MessageImplAccess::get(m).getInternalId(), cumulative);
 }
 
+void SessionImpl::acknowledgeImpl(std::vector<qpid::messaging::Message>& batch, uint32_t count)
+{
+    if (transactional) return;
+    SequenceSet ids;
+    for (uint32_t i = 0; i < count; ++i) {
+        ids.add(MessageImplAccess::get(batch[i]).getInternalId());
+    }
+    incoming.accept(ids);
+}
+
 void SessionImpl::rejectImpl(qpid::messaging::Message& m)
 {
     SequenceSet set;
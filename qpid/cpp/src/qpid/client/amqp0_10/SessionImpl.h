@@ -65,6 +65,7 @@ class SessionImpl : public qpid::messaging::SessionImpl
     void reject(qpid::messaging::Message&);
     void release(qpid::messaging::Message&);
     void acknowledge(qpid::messaging::Message& msg, bool cumulative);
+    void acknowledge(std::vector<qpid::messaging::Message>& batch, uint32_t count);
     void close();
     void sync(bool block);
     qpid::messaging::Sender createSender(const qpid::messaging::Address& address);
@@ -82,6 +83,7 @@ class SessionImpl : public qpid::messaging::SessionImpl
     bool isTransactional() const;
 
     bool get(ReceiverImpl& receiver, qpid::messaging::Message& message, qpid::messaging::Duration timeout);
+    uint32_t get(ReceiverImpl& receiver, std::vector<qpid::messaging::Message>& batch, uint32_t offset);
 
     void releasePending(const std::string& destination);
     void receiverCancelled(const std::string& name);
@@ -151,6 +153,7 @@ class SessionImpl : public qpid::messaging::SessionImpl
     void rollbackImpl();
     void acknowledgeImpl();
     void acknowledgeImpl(qpid::messaging::Message&, bool cumulative);
+    void acknowledgeImpl(std::vector<qpid::messaging::Message>&, uint32_t count);
     void rejectImpl(qpid::messaging::Message&);
     void releaseImpl(qpid::messaging::Message&);
     void closeImpl();
@@ -224,6 +227,15 @@ class SessionImpl : public qpid::messaging::SessionImpl
         void operator()() { impl.acknowledgeImpl(message, cumulative); }
     };
 
+    struct Acknowledge3 : Command
+    {
+        std::vector<qpid::messaging::Message>& batch;
+        uint32_t count;
+
+        Acknowledge3(SessionImpl& i, std::vector<qpid::messaging::Message>& b, uint32_t c) : Command(i), batch(b), count(c) {}
+        void operator()() { impl.acknowledgeImpl(batch, count); }
+    };
+
     struct CreateSender;
     struct CreateReceiver;
     struct UnsettledAcks;
@@ -87,7 +87,12 @@ bool AMQFrame::decode(Buffer& buffer)
         return false;
     uint32_t pos = buffer.getPosition();
 
-    uint8_t  flags = buffer.getOctet();
+    // The fixed 12 byte header is read as one 64 bit and one 32 bit
+    // word (the latter being reserved2) to avoid a bounds check and
+    // byte shuffle per field on every incoming frame.
+    uint64_t header = buffer.getLongLong();
+    (void) buffer.getLong(); // reserved2
+    uint8_t  flags = uint8_t(header >> 56);
     uint8_t framing_version = (flags & 0xc0) >> 6;
     if (framing_version != 0)
         throw FramingErrorException(QPID_MSG("Framing version unsupported"));
@@ -95,15 +100,14 @@ bool AMQFrame::decode(Buffer& buffer)
     eof = flags & 0x04;
     bos = flags & 0x02;
     eos = flags & 0x01;
-    uint8_t  type = buffer.getOctet();
-    uint16_t frame_size =  buffer.getShort();
+    uint8_t  type = uint8_t(header >> 48);
+    uint16_t frame_size = uint16_t(header >> 32);
     if (frame_size < frameOverhead())
         throw FramingErrorException(QPID_MSG("Frame size too small " << frame_size));    
-    uint8_t  reserved1 = buffer.getOctet();
-    uint8_t  field1 = buffer.getOctet();
+    uint8_t  reserved1 = uint8_t(header >> 24);
+    uint8_t  field1 = uint8_t(header >> 16);
     subchannel = field1 & 0x0f;
-    channel = buffer.getShort();
-    (void) buffer.getLong(); // reserved2
+    channel = uint16_t(header);
     
     // Verify that the protocol header meets current spec
     // TODO: should we check reserved2 against zero as well? - the
@@ -30,6 +30,55 @@ namespace framing {
 
 using std::string;
 
+namespace {
+// Network byte order conversion of integers of up to 8 bytes at an
+// arbitrary (possibly unaligned) address. Written as a fixed-length
+// shift sequence so that the compiler reduces each to a single
+// load or store plus byte swap rather than a byte-at-a-time loop.
+inline uint64_t loadBigEndian(const char* p, int n)
+{
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    switch (n) {
+      case 2:
+        return (uint64_t(b[0]) << 8) | uint64_t(b[1]);
+      case 4:
+        return (uint64_t(b[0]) << 24) | (uint64_t(b[1]) << 16) |
+            (uint64_t(b[2]) << 8) | uint64_t(b[3]);
+      default:
+        return (uint64_t(b[0]) << 56) | (uint64_t(b[1]) << 48) |
+            (uint64_t(b[2]) << 40) | (uint64_t(b[3]) << 32) |
+            (uint64_t(b[4]) << 24) | (uint64_t(b[5]) << 16) |
+            (uint64_t(b[6]) << 8) | uint64_t(b[7]);
+    }
+}
+
+inline void storeBigEndian(char* p, uint64_t i, int n)
+{
+    unsigned char* b = reinterpret_cast<unsigned char*>(p);
+    switch (n) {
+      case 2:
+        b[0] = static_cast<unsigned char>(i >> 8);
+        b[1] = static_cast<unsigned char>(i);
+        break;
+      case 4:
+        b[0] = static_cast<unsigned char>(i >> 24);
+        b[1] = static_cast<unsigned char>(i >> 16);
+        b[2] = static_cast<unsigned char>(i >> 8);
+        b[3] = static_cast<unsigned char>(i);
+        break;
+      default:
+        b[0] = static_cast<unsigned char>(i >> 56);
+        b[1] = static_cast<unsigned char>(i >> 48);
+        b[2] = static_cast<unsigned char>(i >> 40);
+        b[3] = static_cast<unsigned char>(i >> 32);
+        b[4] = static_cast<unsigned char>(i >> 24);
+        b[5] = static_cast<unsigned char>(i >> 16);
+        b[6] = static_cast<unsigned char>(i >> 8);
+        b[7] = static_cast<unsigned char>(i);
+    }
+}
+}
+
 Buffer::Buffer(char* _data, uint32_t _size)
     : size(_size), data(_data), position(0) {
 }
@@ -47,25 +96,20 @@ void Buffer::putOctet(uint8_t i){
 
 void Buffer::putShort(uint16_t i){
     checkAvailable(2);
-    uint16_t b = i;
-    data[position++] = (uint8_t) (0xFF & (b >> 8));
-    data[position++] = (uint8_t) (0xFF & b);
+    storeBigEndian(data + position, i, 2);
+    position += 2;
 }
 
 void Buffer::putLong(uint32_t i){
     checkAvailable(4);
-    uint32_t b = i;
-    data[position++] = (uint8_t) (0xFF & (b >> 24));
-    data[position++] = (uint8_t) (0xFF & (b >> 16));
-    data[position++] = (uint8_t) (0xFF & (b >> 8));
-    data[position++] = (uint8_t) (0xFF & b);
+    storeBigEndian(data + position, i, 4);
+    position += 4;
 }
 
 void Buffer::putLongLong(uint64_t i){
-    uint32_t hi = i >> 32;
-    uint32_t lo = i;
-    putLong(hi);
-    putLong(lo);
+    checkAvailable(8);
+    storeBigEndian(data + position, i, 8);
+    position += 8;
 }
 
 void Buffer::putInt8(int8_t i){
@@ -119,30 +163,23 @@ uint8_t Buffer::getOctet(){
 
 uint16_t Buffer::getShort(){
     checkAvailable(2);
-    uint16_t hi = (unsigned char) data[position++];
-    hi = hi << 8;
-    hi |= (unsigned char) data[position++];
-    return hi;
+    uint16_t i = loadBigEndian(data + position, 2);
+    position += 2;
+    return i;
 }
 
 uint32_t Buffer::getLong(){
     checkAvailable(4);
-    uint32_t a = (unsigned char) data[position++];
-    uint32_t b = (unsigned char) data[position++];
-    uint32_t c = (unsigned char) data[position++];
-    uint32_t d = (unsigned char) data[position++];
-    a = a << 24;
-    a |= b << 16;
-    a |= c << 8;
-    a |= d;
-    return a;
+    uint32_t i = loadBigEndian(data + position, 4);
+    position += 4;
+    return i;
 }
 
 uint64_t Buffer::getLongLong(){
-    uint64_t hi = getLong();
-    uint64_t lo = getLong();
-    hi = hi << 32;
-    return hi | lo;
+    checkAvailable(8);
+    uint64_t i = loadBigEndian(data + position, 8);
+    position += 8;
+    return i;
 }
 
 int8_t Buffer::getInt8(){
@@ -25,7 +25,9 @@
 #include "qpid/Exception.h"
 #include "qpid/framing/reply_exceptions.h"
 #include "qpid/Msg.h"
+#include <algorithm>
 #include <assert.h>
+#include <string.h>
 
 // The locking rationale in the FieldTable seems a little odd, but it
 // maintains the concurrent guarantees and requirements that were in
@@ -40,6 +42,12 @@
 // (In other words the code that required the mutable members in the class
 // definition!)
 //
+// The sorted index over the raw bytes is the exception: it is built
+// when the table is decoded (or copied) and discarded by any write, so
+// it never changes during a read and lookups through it are not locked.
+// Copies share both the raw bytes and the index until one of them is
+// modified, at which point that copy decodes its own value map.
+//
 namespace qpid {
 
 using sys::Mutex;
@@ -60,6 +68,7 @@ FieldTable::FieldTable(const FieldTable& ft)
     cachedBytes = ft.cachedBytes;
     cachedSize = ft.cachedSize;
     newBytes = ft.newBytes;
+    index = ft.index;
 
     // Only copy the values if we have no raw data
     // - copying the map is expensive and we can
@@ -89,6 +98,7 @@ FieldTable::FieldTable(const FieldTable& ft)
         cachedBytes = ft.cachedBytes;
         cachedSize = ft.cachedSize;
         newBytes = true;
+        buildIndex();
     }
 }
 
@@ -99,6 +109,7 @@ FieldTable& FieldTable::operator=(const FieldTable& ft)
     cachedBytes.swap(nft.cachedBytes);
     cachedSize = nft.cachedSize;
     newBytes = nft.newBytes;
+    index.swap(nft.index);
     return (*this);
 }
 
@@ -118,6 +129,7 @@ uint32_t FieldTable::encodedSize() const {
 }
 
 int FieldTable::count() const {
+    if (index) return index->size();
     return values.size();
 }
 
@@ -203,6 +215,8 @@ void FieldTable::setDouble(const std::string& name, const double value){
 
 FieldTable::ValuePtr FieldTable::get(const std::string& name) const
 {
+    if (index)
+        return lookup(name);
     // Ensure we have any values we're trying to read
     realDecode();
     ValuePtr value;
@@ -309,6 +323,118 @@ void FieldTable::decode(Buffer& buffer){
     newBytes = true;
     buffer.setPosition(p);
     buffer.getRawData(&cachedBytes[0], cachedSize);
+    buildIndex();
+}
+
+namespace {
+// Encoded size of a value of the given type (excluding the type
+// octet) starting at p, or -1 if it doesn't fit in the n bytes
+// available. Mirrors the type codes handled by FieldValue::setType().
+int64_t valueSize(uint8_t type, const uint8_t* p, uint32_t n)
+{
+    uint32_t prefix;
+    switch (type) {
+      case 0xA8: case 0xA9: case 0xAA: // Map, List, Array
+        prefix = 4;
+        break;
+      case 0x48:                       // Uuid
+        return 16;
+      default:
+        switch (type >> 4) {
+          case 0: case 1: case 2: case 3: case 4: case 5: case 6: case 7:
+            return 1 << (type >> 4);
+          case 8: prefix = 1; break;
+          case 9: prefix = 2; break;
+          case 0xA: prefix = 4; break;
+          case 0xC: return 5;
+          case 0xD: return 9;
+          case 0xF: return 0;
+          default: return -1;
+        }
+    }
+    if (n < prefix) return -1;
+    uint32_t len = 0;
+    for (uint32_t i = 0; i < prefix; ++i) len = (len << 8) | p[i];
+    return int64_t(prefix) + len;
+}
+
+int compareName(const uint8_t* a, size_t an, const uint8_t* b, size_t bn)
+{
+    int c = ::memcmp(a, b, std::min(an, bn));
+    return c ? c : (an < bn ? -1 : (an > bn ? 1 : 0));
+}
+
+struct IndexOrder
+{
+    const uint8_t* base;
+    IndexOrder(const uint8_t* b) : base(b) {}
+    template <class E> bool operator()(const E& a, const E& b) const {
+        return compareName(base+a.name, a.nameSize, base+b.name, b.nameSize) < 0;
+    }
+};
+}
+
+void FieldTable::buildIndex()
+{
+    index.reset();
+    if (!cachedBytes || cachedSize < 8)
+        return;
+    const uint8_t* base = &cachedBytes[0];
+    uint32_t count = (uint32_t(base[4]) << 24) | (uint32_t(base[5]) << 16) |
+        (uint32_t(base[6]) << 8) | uint32_t(base[7]);
+    // Guard against a bogus count: each entry needs at least 2 bytes
+    if (count > (cachedSize - 8) / 2)
+        return;
+    boost::shared_ptr<Index> entries(new Index);
+    entries->reserve(count);
+    uint32_t p = 8;
+    while (count--) {
+        if (p >= cachedSize) return;
+        IndexEntry e;
+        e.nameSize = base[p++];
+        e.name = p;
+        p += e.nameSize;
+        if (p >= cachedSize) return; // Need at least the type octet
+        e.value = p++;
+        int64_t size = valueSize(base[e.value], base+p, cachedSize-p);
+        if (size < 0 || size > cachedSize - p) return;
+        p += size;
+        entries->push_back(e);
+    }
+    // Duplicate names keep their encoded order so that only the last
+    // one is kept, as happens when decoding into the value map.
+    IndexOrder order(base);
+    std::stable_sort(entries->begin(), entries->end(), order);
+    Index::iterator out = entries->begin();
+    for (Index::iterator i = entries->begin(); i != entries->end(); ++i) {
+        if (i+1 != entries->end() && !order(*i, *(i+1)))
+            continue;           // Superseded by a later entry of the same name
+        *out++ = *i;
+    }
+    entries->erase(out, entries->end());
+    index = entries;
+}
+
+FieldTable::ValuePtr FieldTable::lookup(const std::string& name) const
+{
+    const uint8_t* base = &cachedBytes[0];
+    const uint8_t* key = reinterpret_cast<const uint8_t*>(name.data());
+    Index::const_iterator lo = index->begin(), hi = index->end();
+    while (lo < hi) {
+        Index::const_iterator mid = lo + (hi - lo)/2;
+        if (compareName(base+mid->name, mid->nameSize, key, name.size()) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == index->end() ||
+        compareName(key, name.size(), base+lo->name, lo->nameSize) != 0)
+        return ValuePtr();
+    Buffer buffer(reinterpret_cast<char*>(&cachedBytes[0]), cachedSize);
+    buffer.setPosition(lo->value);
+    ValuePtr value(new FieldValue);
+    value->decode(buffer);
+    return value;
 }
 
 void FieldTable::realDecode() const
@@ -345,6 +471,7 @@ void FieldTable::flushRawCache()
     // Avoid recreating shared array unless we actually have one.
     if (cachedBytes) cachedBytes.reset();
     cachedSize = 0;
+    index.reset();
 }
 
 bool FieldTable::operator==(const FieldTable& x) const {
@@ -30,6 +30,7 @@
 
 #include <iosfwd>
 #include <map>
+#include <vector>
 
 #include "qpid/CommonImportExport.h"
 
@@ -70,7 +71,7 @@ class FieldTable
     QPID_COMMON_EXTERN void decode(Buffer& buffer);
 
     QPID_COMMON_EXTERN int count() const;
-    QPID_COMMON_INLINE_EXTERN size_t size() const { return values.size(); }
+    QPID_COMMON_INLINE_EXTERN size_t size() const { return count(); }
     QPID_COMMON_INLINE_EXTERN bool empty() { return size() == 0; }
     QPID_COMMON_EXTERN void set(const std::string& name, const ValuePtr& value);
     QPID_COMMON_EXTERN ValuePtr get(const std::string& name) const;
@@ -117,14 +118,31 @@ class FieldTable
     QPID_COMMON_EXTERN void clear();
 
   private:
+    /**
+     * Position of one entry in cachedBytes. The index is sorted by
+     * name so that get() can find and decode a single value straight
+     * from the encoded bytes without decoding the whole table.
+     */
+    struct IndexEntry {
+        uint32_t name;
+        uint32_t value;
+        uint8_t nameSize;
+    };
+    typedef std::vector<IndexEntry> Index;
+
     void realDecode() const;
     void flushRawCache();
+    void buildIndex();
+    ValuePtr lookup(const std::string& name) const;
 
     mutable qpid::sys::Mutex lock;
     mutable ValueMap values;
     mutable boost::shared_array<uint8_t> cachedBytes;
     mutable uint32_t cachedSize; // if = 0 then non cached size as 0 is not a legal size
     mutable bool newBytes;
+    // Only set or reset by non-const operations along with
+    // cachedBytes, so readers may use it without taking the lock.
+    boost::shared_ptr<Index> index;
 
     QPID_COMMON_EXTERN friend std::ostream& operator<<(std::ostream& out, const FieldTable& body);
 };
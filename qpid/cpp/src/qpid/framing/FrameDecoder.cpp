@@ -57,6 +57,7 @@ bool FrameDecoder::decode(Buffer& buffer) {
             uint16_t size = AMQFrame::decodeSize(&fragment[0]);
             if (size <= fragment.size())
                 throw FramingErrorException(QPID_MSG("Frame size " << size << " is too small."));
+            fragment.reserve(size); // Grow once rather than per read
             append(fragment, buffer, size-fragment.size());
             Buffer b(&fragment[0], fragment.size());
             if (frame.decode(b)) {
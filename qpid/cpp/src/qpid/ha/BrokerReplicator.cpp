@@ -106,6 +106,8 @@ const string QUEUE("queue");
 const string TYPE("type");
 const string UNBIND("unbind");
 const string CONSUMER_COUNT("consumerCount");
+const string MSG_DEPTH("msgDepth");
+const string BYTE_DEPTH("byteDepth");
 
 const string AGENT_EVENT_BROKER("agent.ind.event.org_apache_qpid_broker.#");
 const string AGENT_EVENT_HA("agent.ind.event.org_apache_qpid_ha.#");
@@ -668,10 +670,21 @@ void BrokerReplicator::doResponseQueue(Variant::Map& values) {
         name, values[DURABLE].asBool(), values[AUTODELETE].asBool(), args,
         getAltExchange(values[ALTEXCHANGE]));
     if (qr) {
+        CatchupScheduler::Backlog backlog;
         Variant::Map::const_iterator i = values.find(CONSUMER_COUNT);
         if (i != values.end() && isIntegerType(i->second.getType())) {
-            if (i->second.asInt64()) qr->setSubscribed();
+            if (i->second.asInt64()) {
+                qr->setSubscribed();
+                backlog.hot = true;
+            }
         }
+        i = values.find(MSG_DEPTH);
+        if (i != values.end() && isIntegerType(i->second.getType()))
+            backlog.messages = i->second.asUint64();
+        i = values.find(BYTE_DEPTH);
+        if (i != values.end() && isIntegerType(i->second.getType()))
+            backlog.bytes = i->second.asUint64();
+        qr->setBacklog(backlog);
     }
 }
 
@@ -0,0 +1,58 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "CatchupCredit.h"
+#include <algorithm>
+
+namespace qpid {
+namespace ha {
+
+namespace {
+const uint64_t MAX_GRANT = 0xFFFFFFFE; // Largest finite 0-10 credit.
+}
+
+CatchupCredit::CatchupCredit() : balance(0), credit(0), messages(0), bytes(0) {}
+
+uint32_t CatchupCredit::tick(uint64_t share) {
+    int64_t s = int64_t(std::min(share, MAX_GRANT));
+    balance = std::min(balance + s, s);
+    if (balance <= 0) return 0;
+    // Until a message has arrived there is no size to go by, send one.
+    uint64_t average = messages ? std::max(uint64_t(1), bytes/messages) : 0;
+    uint64_t want = average ? std::max(uint64_t(1), uint64_t(balance)/average) : 1;
+    if (want <= credit) return 0;
+    uint64_t grant = std::min(want - credit, MAX_GRANT);
+    credit += grant;
+    return uint32_t(grant);
+}
+
+void CatchupCredit::received(uint64_t size) {
+    balance -= int64_t(size);
+    if (credit) --credit;
+    ++messages;
+    bytes += size;
+}
+
+void CatchupCredit::receivedEvent() {
+    if (credit) --credit;
+}
+
+}} // namespace qpid::ha
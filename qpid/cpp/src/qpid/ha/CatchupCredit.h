@@ -0,0 +1,76 @@
+#ifndef QPID_HA_CATCHUPCREDIT_H
+#define QPID_HA_CATCHUPCREDIT_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/sys/IntegerTypes.h"
+
+namespace qpid {
+namespace ha {
+
+/**
+ * Byte balance of a queue catching up at a CatchupScheduler rate.
+ *
+ * Each tick adds the queue's share of the rate to the balance, each
+ * message received is charged against it. The primary sends on message
+ * credit with no byte limit, granted only while the balance is positive,
+ * so a message larger than a tick's share still goes through: it leaves
+ * the balance overdrawn and the following ticks pay it off. Unused
+ * balance is kept for at most one tick, so a queue that had nothing to
+ * send doesn't build up a burst.
+ *
+ * Message credit is granted to cover the balance at the average message
+ * size, less what the primary has left. Every transfer uses one credit,
+ * but HA events are sent without credit and the primary's credit stops
+ * at 0, so the estimate of what it has left stops at 0 too. The estimate
+ * never exceeds the primary's credit, so the queue can't stall on it.
+ *
+ * Not thread safe, the QueueReplicator calls it with its lock held.
+ */
+class CatchupCredit
+{
+  public:
+    CatchupCredit();
+
+    /** Add a tick's share of bytes.
+     *@return the message credit to grant the primary, 0 for none.
+     */
+    uint32_t tick(uint64_t share);
+
+    /** A message of bytes was received. */
+    void received(uint64_t bytes);
+
+    /** An event was received, it used credit but isn't charged. */
+    void receivedEvent();
+
+    /** Bytes the queue may still receive, negative when overdrawn. */
+    int64_t getBalance() const { return balance; }
+
+  private:
+    int64_t balance;
+    uint64_t credit;            // Least message credit the primary has left.
+    uint64_t messages, bytes;   // Received, for the average message size.
+};
+
+}} // namespace qpid::ha
+
+#endif  /*!QPID_HA_CATCHUPCREDIT_H*/
@@ -0,0 +1,237 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "CatchupScheduler.h"
+#include "QueueReplicator.h"
+#include "Settings.h"
+#include "qpid/log/Statement.h"
+#include "qpid/sys/Timer.h"
+#include <algorithm>
+
+namespace qpid {
+namespace ha {
+
+using sys::Mutex;
+using types::Variant;
+
+namespace {
+const sys::Duration TICK = 100*sys::TIME_MSEC;
+const uint32_t MAX_GRANT = 0xFFFFFFFE; // Largest finite 0-10 credit.
+
+class Ticker : public sys::TimerTask {
+  public:
+    Ticker(CatchupScheduler& s, sys::Timer& t)
+        : TimerTask(TICK, "HA catch-up credit"), scheduler(s), timer(t) {}
+
+    void fire() {
+        scheduler.tick();
+        setupNextFire();
+        timer.add(this);
+    }
+
+  private:
+    CatchupScheduler& scheduler;
+    sys::Timer& timer;
+};
+
+double seconds(sys::Duration d) { return double(int64_t(d))/sys::TIME_SEC; }
+}
+
+bool CatchupScheduler::Entry::operator<(const Entry& x) const {
+    if (backlog.hot != x.backlog.hot) return backlog.hot;
+    return backlog.bytes < x.backlog.bytes;
+}
+
+CatchupScheduler::CatchupScheduler(const Settings& s, sys::Timer& t, const LogPrefix& lp)
+    : settings(s), timer(t), logPrefix(lp)
+{
+    if (settings.catchupRate || (settings.catchupQueues && settings.catchupTimeout)) {
+        ticker = new Ticker(*this, timer);
+        timer.add(ticker);
+    }
+}
+
+CatchupScheduler::~CatchupScheduler() {
+    if (ticker) ticker->cancel();
+}
+
+bool CatchupScheduler::add(const boost::shared_ptr<QueueReplicator>& qr,
+                           const std::string& queue, const Backlog& backlog)
+{
+    Mutex::ScopedLock l(lock);
+    // Reconnected, schedule from scratch.
+    if (!erase(active, *qr, l)) erase(waiting, *qr, l);
+    Entry e;
+    e.replicator = qr;
+    e.queue = queue;
+    e.backlog = backlog;
+    if (!settings.catchupQueues || active.size() < settings.catchupQueues) {
+        active.push_back(e);
+        activate(active.back(), l);
+        return true;
+    }
+    // Stable: equal entries keep their arrival order.
+    waiting.insert(std::upper_bound(waiting.begin(), waiting.end(), e), e);
+    QPID_LOG(debug, logPrefix << "Catch-up of " << queue << " waiting, "
+             << waiting.size() << " queues waiting");
+    return false;
+}
+
+void CatchupScheduler::caughtUp(const QueueReplicator& qr) {
+    Replicators starting;
+    {
+        Mutex::ScopedLock l(lock);
+        for (Entries::iterator i = active.begin(); i != active.end(); ++i) {
+            if (i->replicator.get() == &qr) {
+                QPID_LOG(debug, logPrefix << "Caught up " << i->queue << " in "
+                         << seconds(sys::Duration(i->start, sys::now())) << "s");
+                active.erase(i);
+                break;
+            }
+        }
+        admit(starting, l);
+    }
+    start(starting);
+}
+
+void CatchupScheduler::remove(const QueueReplicator& qr) {
+    Replicators starting;
+    {
+        Mutex::ScopedLock l(lock);
+        if (!erase(active, qr, l)) erase(waiting, qr, l);
+        admit(starting, l);
+    }
+    start(starting);
+}
+
+bool CatchupScheduler::erase(Entries& entries, const QueueReplicator& qr, Mutex::ScopedLock&) {
+    for (Entries::iterator i = entries.begin(); i != entries.end(); ++i) {
+        if (i->replicator.get() == &qr) {
+            entries.erase(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Called in tick() with the scheduler lock held.
+bool CatchupScheduler::Entry::timedOut(const sys::AbsTime& now, sys::Duration timeout) {
+    uint64_t bytes = replicator->getReceivedBytes();
+    if (bytes != lastBytes) {
+        lastBytes = bytes;
+        lastProgress = now;
+        return timeout && bytes - startBytes >= backlog.bytes &&
+            sys::Duration(start, now) > timeout;
+    }
+    return timeout && sys::Duration(lastProgress, now) > timeout;
+}
+
+void CatchupScheduler::activate(Entry& e, Mutex::ScopedLock&) {
+    e.start = sys::now();
+    e.lastProgress = e.start;
+    e.startBytes = e.lastBytes = e.replicator->getReceivedBytes();
+    e.startMessages = e.replicator->getReceivedMessages();
+    QPID_LOG(debug, logPrefix << "Catch-up of " << e.queue << " started, backlog "
+             << e.backlog.messages << " messages, " << e.backlog.bytes << " bytes");
+}
+
+// Move waiting entries to active while there is room, return the replicators to start.
+void CatchupScheduler::admit(Replicators& starting, Mutex::ScopedLock& l) {
+    while (!waiting.empty() &&
+           (!settings.catchupQueues || active.size() < settings.catchupQueues))
+    {
+        active.splice(active.end(), waiting, waiting.begin());
+        activate(active.back(), l);
+        starting.push_back(active.back().replicator);
+    }
+}
+
+// Called without the lock held.
+void CatchupScheduler::start(const Replicators& starting) {
+    for (Replicators::const_iterator i = starting.begin(); i != starting.end(); ++i)
+        (*i)->startCatchup();
+}
+
+void CatchupScheduler::tick() {
+    Replicators granted, ended, starting;
+    uint64_t share = 0;
+    {
+        Mutex::ScopedLock l(lock);
+        sys::AbsTime now = sys::now();
+        for (Entries::iterator i = active.begin(); i != active.end();) {
+            if (i->timedOut(now, settings.catchupTimeout)) {
+                QPID_LOG(warning, logPrefix << "No catch-up event for " << i->queue << " after "
+                         << seconds(sys::Duration(i->start, now)) << "s, treating it as caught up");
+                ended.push_back(i->replicator);
+                i = active.erase(i);
+            } else {
+                ++i;
+            }
+        }
+        admit(starting, l);
+        if (settings.catchupRate && !active.empty()) {
+            share = settings.catchupRate * (TICK/sys::TIME_MSEC) / 1000 / active.size();
+            for (Entries::iterator i = active.begin(); i != active.end(); ++i)
+                granted.push_back(i->replicator);
+        }
+    }
+    for (Replicators::iterator i = ended.begin(); i != ended.end(); ++i)
+        (*i)->endCatchup();
+    start(starting);
+    uint32_t bytes = uint32_t(std::max(uint64_t(1), std::min(share, uint64_t(MAX_GRANT))));
+    for (Replicators::iterator i = granted.begin(); i != granted.end(); ++i)
+        (*i)->grantCatchupCredit(bytes);
+}
+
+Variant::Map CatchupScheduler::getStatus() const {
+    Mutex::ScopedLock l(lock);
+    Variant::Map status;
+    sys::AbsTime now = sys::now();
+    for (Entries::const_iterator i = active.begin(); i != active.end(); ++i) {
+        uint64_t bytes = i->replicator->getReceivedBytes() - i->startBytes;
+        uint64_t messages = i->replicator->getReceivedMessages() - i->startMessages;
+        double elapsed = seconds(sys::Duration(i->start, now));
+        double rate = elapsed > 0 ? bytes/elapsed : 0;
+        uint64_t remaining = i->backlog.bytes > bytes ? i->backlog.bytes - bytes : 0;
+        Variant::Map q;
+        q["state"] = "active";
+        q["backlogMessages"] = i->backlog.messages;
+        q["backlogBytes"] = i->backlog.bytes;
+        q["receivedMessages"] = messages;
+        q["receivedBytes"] = bytes;
+        q["rate"] = rate;
+        q["eta"] = remaining == 0 ? 0.0 : rate > 0 ? remaining/rate : -1.0;
+        status[i->queue] = q;
+    }
+    uint64_t position = 0;
+    for (Entries::const_iterator i = waiting.begin(); i != waiting.end(); ++i) {
+        Variant::Map q;
+        q["state"] = "waiting";
+        q["position"] = ++position;
+        q["backlogMessages"] = i->backlog.messages;
+        q["backlogBytes"] = i->backlog.bytes;
+        q["eta"] = -1.0;
+        status[i->queue] = q;
+    }
+    return status;
+}
+
+}} // namespace qpid::ha
@@ -0,0 +1,137 @@
+#ifndef QPID_HA_CATCHUPSCHEDULER_H
+#define QPID_HA_CATCHUPSCHEDULER_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "LogPrefix.h"
+#include "qpid/sys/IntegerTypes.h"
+#include "qpid/sys/Mutex.h"
+#include "qpid/sys/Time.h"
+#include "qpid/types/Variant.h"
+#include <boost/intrusive_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace qpid {
+
+namespace sys {
+class Timer;
+class TimerTask;
+}
+
+namespace ha {
+class QueueReplicator;
+class Settings;
+
+/**
+ * Schedules the catch-up of backup queues when a backup joins a primary.
+ *
+ * At most Settings::catchupQueues replicators catch up at once, the others
+ * wait to subscribe: queues with consumers on the primary go first, then
+ * queues with the smallest backlog. If Settings::catchupRate is set the
+ * replicators that are catching up share that many bytes per second,
+ * added to each one's CatchupCredit every tick.
+ *
+ * A queue has caught up when its ReplicatingSubscription sends a
+ * CaughtUpEvent; the replicator then returns to normal flow control and
+ * the next waiting queue starts. A primary that predates catch-up events
+ * never sends one, so after Settings::catchupTimeout without progress, or
+ * that long after receiving its whole backlog, a queue is treated as
+ * caught up.
+ *
+ * THREAD SAFE: called in connection and timer threads. Only calls
+ * QueueReplicator functions that lock the replicator with the scheduler
+ * lock released, so add() may be called with a replicator lock held.
+ * caughtUp() and remove() start other replicators and must be called
+ * without one.
+ */
+class CatchupScheduler
+{
+  public:
+    /** Size of the primary queue when the backup learned of it. */
+    struct Backlog {
+        uint64_t messages, bytes;
+        bool hot;               // Queue has consumers on the primary.
+        Backlog() : messages(0), bytes(0), hot(false) {}
+    };
+
+    CatchupScheduler(const Settings&, sys::Timer&, const LogPrefix&);
+    ~CatchupScheduler();
+
+    /**
+     * The replicator is connected and ready to subscribe.
+     *@return true if it should start catching up now, otherwise the
+     * scheduler calls QueueReplicator::startCatchup() when its turn comes.
+     */
+    bool add(const boost::shared_ptr<QueueReplicator>&, const std::string& queue, const Backlog&);
+
+    /** The replicator has caught up. */
+    void caughtUp(const QueueReplicator&);
+
+    /** The replicator was disconnected, destroyed or promoted. */
+    void remove(const QueueReplicator&);
+
+    /**
+     * Catch-up progress of each waiting or active queue: state, backlog,
+     * bytes and messages received, rate in bytes per second and eta in
+     * seconds, -1 if not yet known.
+     */
+    types::Variant::Map getStatus() const;
+
+    void tick();                // Called by the timer.
+
+  private:
+    struct Entry {
+        boost::shared_ptr<QueueReplicator> replicator;
+        std::string queue;
+        Backlog backlog;
+        sys::AbsTime start;
+        uint64_t startBytes;    // Received before catch-up started.
+        uint64_t startMessages;
+        uint64_t lastBytes;     // Received at lastProgress.
+        sys::AbsTime lastProgress;
+        Entry() : start(sys::AbsTime::Zero()), startBytes(0), startMessages(0),
+                  lastBytes(0), lastProgress(sys::AbsTime::Zero()) {}
+        bool timedOut(const sys::AbsTime& now, sys::Duration timeout);
+        bool operator<(const Entry&) const; // Scheduling order.
+    };
+    typedef std::list<Entry> Entries;
+    typedef std::vector<boost::shared_ptr<QueueReplicator> > Replicators;
+
+    bool erase(Entries&, const QueueReplicator&, sys::Mutex::ScopedLock&);
+    void activate(Entry&, sys::Mutex::ScopedLock&);
+    void admit(Replicators&, sys::Mutex::ScopedLock&);
+    void start(const Replicators&);
+
+    mutable sys::Mutex lock;
+    const Settings& settings;
+    sys::Timer& timer;
+    const LogPrefix& logPrefix;
+    Entries active, waiting;
+    boost::intrusive_ptr<sys::TimerTask> ticker;
+};
+
+}} // namespace qpid::ha
+
+#endif  /*!QPID_HA_CATCHUPSCHEDULER_H*/
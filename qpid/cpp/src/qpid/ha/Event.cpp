@@ -44,6 +44,7 @@ bool isEventKey(const std::string& key) {
 
 const string DequeueEvent::KEY(QPID_HA+"de");
 const string IdEvent::KEY(QPID_HA+"id");
+const string CaughtUpEvent::KEY(QPID_HA+"cu");
 
 broker::Message makeMessage(
     const string& data, const string& destination, const string& routingKey)
@@ -94,6 +94,16 @@ struct IdEvent : public EventBase<IdEvent> {
     void print(std::ostream& o) const { o << id; }
 };
 
+/** Sent when the subscription has caught up with the queue, see CatchupScheduler */
+struct CaughtUpEvent : public EventBase<CaughtUpEvent> {
+    static const std::string KEY;
+
+    void encode(framing::Buffer&) const {}
+    void decode(framing::Buffer&) {}
+    virtual size_t encodedSize() const { return 0; }
+    void print(std::ostream&) const {}
+};
+
 }} // namespace qpid::ha
 
 #endif  /*!QPID_HA_EVENT_H*/
@@ -43,6 +43,7 @@
 #include "qpid/types/Uuid.h"
 #include "qpid/framing/Uuid.h"
 #include "qmf/org/apache/qpid/ha/Package.h"
+#include "qmf/org/apache/qpid/ha/ArgsHaBrokerCatchupStatus.h"
 #include "qmf/org/apache/qpid/ha/ArgsHaBrokerReplicate.h"
 #include "qmf/org/apache/qpid/ha/ArgsHaBrokerSetBrokersUrl.h"
 #include "qmf/org/apache/qpid/ha/ArgsHaBrokerSetPublicUrl.h"
@@ -90,7 +91,8 @@ HaBroker::HaBroker(broker::Broker& b, const Settings& s)
       observer(new ConnectionObserver(*this, systemId)),
       role(new StandAlone),
       membership(BrokerInfo(systemId, STANDALONE), *this), // Sets logPrefix
-      failoverExchange(new FailoverExchange(*b.GetVhostObject(), b))
+      failoverExchange(new FailoverExchange(*b.GetVhostObject(), b)),
+      catchupScheduler(settings, b.getTimer(), logPrefix)
 {
     // If we are joining a cluster we must start excluding clients now,
     // otherwise there's a window for a client to connect before we get to
@@ -184,6 +186,11 @@ Manageable::status_t HaBroker::ManagementMethod (uint32_t methodId, Args& args,
           broker.getExchanges().registerExchange(qr);
           break;
       }
+      case _qmf::HaBroker::METHOD_CATCHUPSTATUS: {
+          dynamic_cast<_qmf::ArgsHaBrokerCatchupStatus&>(args).o_queues =
+              catchupScheduler.getStatus();
+          break;
+      }
 
       default:
         return Manageable::STATUS_UNKNOWN_METHOD;
@@ -29,6 +29,7 @@
 #include "Settings.h"
 #include "qpid/Url.h"
 #include "FailoverExchange.h"
+#include "CatchupScheduler.h"
 #include "qpid/sys/Mutex.h"
 #include "qmf/org/apache/qpid/ha/HaBroker.h"
 #include "qpid/management/Manageable.h"
@@ -99,6 +100,8 @@ class HaBroker : public management::Manageable
 
     boost::shared_ptr<QueueReplicator> findQueueReplicator(const std::string& queueName);
 
+    CatchupScheduler& getCatchupScheduler() { return catchupScheduler; }
+
     /** Authenticated user ID for queue create/delete */
     std::string getUserId() const { return userId; }
 
@@ -131,6 +134,7 @@ class HaBroker : public management::Manageable
     boost::shared_ptr<Role> role;
     Membership membership;
     boost::shared_ptr<FailoverExchange> failoverExchange;
+    CatchupScheduler catchupScheduler;
 };
 }} // namespace qpid::ha
 
@@ -58,6 +58,24 @@ struct Options : public qpid::Options {
              "Flow control message count limit for replication, 0 means no limit")
             ("ha-flow-bytes", optValue(settings.flowBytes, "N"),
              "Flow control byte limit for replication, 0 means no limit")
+            ("ha-replication-batch", optValue(settings.replicationBatch, "N"),
+             "Maximum number of replicated messages a backup acknowledges together, 0 means acknowledge each message")
+            ("ha-catchup-queues", optValue(settings.catchupQueues, "N"),
+             "Maximum number of queues a joining backup catches up in parallel, 0 means no limit. "
+             "The primary must support catch-up events.")
+            ("ha-catchup-rate", optValue(settings.catchupRate, "BYTES/S"),
+             "Bandwidth shared by queues a joining backup is catching up, 0 means no limit. "
+             "A message larger than a queue's share of 100ms of this rate is sent and "
+             "delays the queue's next messages")
+            ("ha-catchup-timeout", optValue(settings.catchupTimeout, "SECONDS"),
+             "Stop limiting the catch-up of a queue that has received nothing for this long, "
+             "or that has received its whole backlog this long after it started, and start the "
+             "next waiting queue. Covers primaries that don't send catch-up events. "
+             "0 means no timeout.")
+            ("ha-fast-resync", optValue(settings.fastResync, "yes|no"),
+             "When a backup resyncs with a primary, send a compact summary of the messages it "
+             "already has and become ready once the missing messages are replicated. "
+             "The primary must support fast resync.")
             ;
     }
 };
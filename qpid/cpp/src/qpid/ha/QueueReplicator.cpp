@@ -36,6 +36,7 @@
 #include "qpid/broker/QueueRegistry.h"
 #include "qpid/broker/SessionHandler.h"
 #include "qpid/broker/SessionState.h"
+#include "qpid/broker/amqp_0_10/Connection.h"
 #include "qpid/framing/FieldTable.h"
 #include "qpid/framing/FieldValue.h"
 #include "qpid/log/Statement.h"
@@ -155,7 +156,7 @@ QueueReplicator::QueueReplicator(HaBroker& hb,
       logPrefix(hb.logPrefix, "Backup of "+q->getName()+": "),
       subscribed(false),
       settings(hb.getSettings()),
-      nextId(0), maxId(0)
+      nextId(0), maxId(0), catchupCredit(false)
 {
     QPID_LOG(debug, logPrefix << "Created");
     // The QueueReplicator will take over setting replication IDs.
@@ -176,6 +177,8 @@ QueueReplicator::QueueReplicator(HaBroker& hb,
         boost::bind(&QueueReplicator::dequeueEvent, this, _1, _2);
     dispatch[IdEvent::KEY] =
         boost::bind(&QueueReplicator::idEvent, this, _1, _2);
+    dispatch[CaughtUpEvent::KEY] =
+        boost::bind(&QueueReplicator::caughtUpEvent, this, _1, _2);
 }
 
 QueueReplicator::~QueueReplicator() {}
@@ -217,8 +220,12 @@ void QueueReplicator::initialize() {
 }
 
 void QueueReplicator::disconnect() {
-    Mutex::ScopedLock l(lock);
-    sessionHandler = 0;
+    {
+        Mutex::ScopedLock l(lock);
+        sessionHandler = 0;
+        catchupCredit = false;
+    }
+    haBroker.getCatchupScheduler().remove(*this);
 }
 
 // Called from Queue::destroyed()
@@ -231,6 +238,7 @@ void QueueReplicator::destroy() {
         bridge2 = bridge.lock(); // !call close outside the lock.
         destroy(l);
     }
+    haBroker.getCatchupScheduler().remove(*this);
     if (bridge2) bridge2->close(); // Outside of lock, avoid deadlock.
 }
 
@@ -242,9 +250,14 @@ void QueueReplicator::destroy(Mutex::ScopedLock&) {
 }
 
 
+void QueueReplicator::setBacklog(const CatchupScheduler::Backlog& b) {
+    Mutex::ScopedLock l(lock);
+    backlog = b;
+}
+
 // Called in a broker connection thread when the bridge is created.
 // Note: called with the Link lock held.
-void QueueReplicator::initializeBridge(Bridge& bridge, SessionHandler& sessionHandler_) {
+void QueueReplicator::initializeBridge(Bridge&, SessionHandler& sessionHandler_) {
     Mutex::ScopedLock l(lock);
     if (!queue) return;         // Already destroyed
     sessionHandler = &sessionHandler_;
@@ -252,27 +265,104 @@ void QueueReplicator::initializeBridge(Bridge& bridge, SessionHandler& sessionHa
         // Don't overwrite the exchange property set on the primary.
         sessionHandler->getSession()->getMessageBuilder().setCopyExchange(false);
     }
+    if (haBroker.getCatchupScheduler().add(shared_from_this(), queue->getName(), backlog))
+        subscribe(l);
+    // Otherwise the scheduler calls startCatchup() when it is our turn.
+}
+
+// Called in the CatchupScheduler, subscribe in the bridge connection thread.
+void QueueReplicator::startCatchup() {
+    Mutex::ScopedLock l(lock);
+    if (sessionHandler)
+        sessionHandler->getConnection().requestIOProcessing(
+            boost::bind(&QueueReplicator::ioSubscribe, shared_from_this()));
+}
+
+void QueueReplicator::ioSubscribe() {
+    Mutex::ScopedLock l(lock);
+    if (queue && sessionHandler) subscribe(l);
+}
+
+// Called in the CatchupScheduler's timer thread.
+void QueueReplicator::grantCatchupCredit(uint32_t bytes) {
+    Mutex::ScopedLock l(lock);
+    if (catchupCredit && sessionHandler)
+        sessionHandler->getConnection().requestIOProcessing(
+            boost::bind(&QueueReplicator::ioGrantCredit, shared_from_this(), bytes));
+}
+
+void QueueReplicator::ioGrantCredit(uint32_t bytes) {
+    Mutex::ScopedLock l(lock);
+    if (catchupCredit && sessionHandler) {
+        uint32_t messages = catchup.tick(bytes);
+        if (messages) {
+            AMQP_ServerProxy peer(sessionHandler->out);
+            peer.getMessage().flow(getName(), 0, messages);
+        }
+    }
+}
+
+// Called in the CatchupScheduler's timer thread when it gives up waiting
+// for a CaughtUpEvent.
+void QueueReplicator::endCatchup() {
+    Mutex::ScopedLock l(lock);
+    if (catchupCredit && sessionHandler)
+        sessionHandler->getConnection().requestIOProcessing(
+            boost::bind(&QueueReplicator::ioEndCatchup, shared_from_this()));
+}
+
+void QueueReplicator::ioEndCatchup() {
+    Mutex::ScopedLock l(lock);
+    if (catchupCredit && sessionHandler) {
+        catchupCredit = false;
+        setWindow(l);
+    }
+}
+
+// Called in the bridge connection thread.
+void QueueReplicator::setWindow(Mutex::ScopedLock&) {
+    AMQP_ServerProxy peer(sessionHandler->out);
+    peer.getMessage().setFlowMode(getName(), 1); // Window
+    peer.getMessage().flow(getName(), 0, settings.getFlowMessages());
+    peer.getMessage().flow(getName(), 1, settings.getFlowBytes());
+}
+
+// Called in the bridge connection thread.
+void QueueReplicator::subscribe(Mutex::ScopedLock& l) {
     AMQP_ServerProxy peer(sessionHandler->out);
-    const qmf::org::apache::qpid::broker::ArgsLinkBridge& args(bridge.getArgs());
     FieldTable arguments;
     arguments.setString(ReplicatingSubscription::QPID_REPLICATING_SUBSCRIPTION, getType());
-    arguments.setInt(QPID_SYNC_FREQUENCY, 1); // TODO aconway 2012-05-22: optimize?
+    arguments.setInt(QPID_SYNC_FREQUENCY, 1); // For primaries that don't batch.
+    if (settings.replicationBatch)
+        arguments.setInt(ReplicatingSubscription::QPID_BATCH, settings.replicationBatch);
     arguments.setTable(ReplicatingSubscription::QPID_BROKER_INFO, brokerInfo.asFieldTable());
     boost::shared_ptr<QueueSnapshot> qs = queue->getObservers().findType<QueueSnapshot>();
     ReplicationIdSet snapshot;
     if (qs) {
         snapshot = qs->getSnapshot();
-        arguments.set(
-            ReplicatingSubscription::QPID_ID_SET,
-            FieldTable::ValuePtr(new Var32Value(encodeStr(snapshot), TYPE_CODE_VBIN32)));
+        if (settings.fastResync)
+            arguments.set(
+                ReplicatingSubscription::QPID_ID_SUMMARY,
+                FieldTable::ValuePtr(new Var32Value(encodeStr(ReplicationIdSummary(snapshot)),
+                                                    TYPE_CODE_VBIN32)));
+        else
+            arguments.set(
+                ReplicatingSubscription::QPID_ID_SET,
+                FieldTable::ValuePtr(new Var32Value(encodeStr(snapshot), TYPE_CODE_VBIN32)));
     }
     try {
         peer.getMessage().subscribe(
-            args.i_src, args.i_dest, 0/*accept-explicit*/, 1/*not-acquired*/,
+            queue->getName(), getName(), 0/*accept-explicit*/, 1/*not-acquired*/,
             false/*exclusive*/, "", 0, arguments);
-        peer.getMessage().setFlowMode(getName(), 1); // Window
-        peer.getMessage().flow(getName(), 0, settings.getFlowMessages());
-        peer.getMessage().flow(getName(), 1, settings.getFlowBytes());
+        if (settings.catchupRate) {
+            // Message credit comes from the CatchupScheduler till we catch up.
+            catchupCredit = true;
+            catchup = CatchupCredit();
+            peer.getMessage().setFlowMode(getName(), 0); // Credit
+            peer.getMessage().flow(getName(), 1, Settings::NO_LIMIT);
+        } else {
+            setWindow(l);
+        }
     }
     catch(const exception& e) {
         QPID_LOG(error, logPrefix << "Cannot connect to primary: " << e.what());
@@ -298,18 +388,19 @@ void QueueReplicator::dequeueEvent(const string& data, Mutex::ScopedLock&) {
     DequeueEvent e;
     decodeStr(data, e);
     QPID_LOG(trace, logPrefix << "Dequeue " << e.ids);
-    //TODO: should be able to optimise the following
-    for (ReplicationIdSet::iterator i = e.ids.begin(); i != e.ids.end(); ++i) {
-        QueuePosition position;
-        {
-            Mutex::ScopedLock l(lock);
+    // Look up the whole batch with the lock held once.
+    std::vector<QueuePosition> dequeuePositions;
+    {
+        Mutex::ScopedLock l(lock);
+        for (ReplicationIdSet::iterator i = e.ids.begin(); i != e.ids.end(); ++i) {
             PositionMap::iterator j = positions.find(*i);
-            if (j == positions.end()) continue;
-            position = j->second;
+            if (j != positions.end()) dequeuePositions.push_back(j->second);
         }
-        queue->dequeueMessageAt(position); // Outside lock, will call dequeued().
-        // positions will be cleaned up in dequeued()
     }
+    for (std::vector<QueuePosition>::iterator i = dequeuePositions.begin();
+         i != dequeuePositions.end(); ++i)
+        queue->dequeueMessageAt(*i); // Outside lock, will call dequeued().
+    // positions will be cleaned up in dequeued()
 }
 
 // Called in connection thread of the queues bridge to primary.
@@ -322,6 +413,7 @@ void QueueReplicator::route(Deliverable& deliverable)
             if (!queue) return;     // Already destroyed
             string key(message.getRoutingKey());
             if (isEventKey(key)) {
+                if (catchupCredit) catchup.receivedEvent();
                 DispatchMap::iterator i = dispatch.find(key);
                 if (i == dispatch.end()) {
                     QPID_LOG(info, logPrefix << "Ignoring unknown event: " << key);
@@ -330,6 +422,7 @@ void QueueReplicator::route(Deliverable& deliverable)
                 }
                 return;
             }
+            if (catchupCredit) catchup.received(message.getMessageSize());
             ReplicationId id = nextId++;
             message.setReplicationId(id);
             PositionMap::iterator i = positions.find(id);
@@ -338,6 +431,8 @@ void QueueReplicator::route(Deliverable& deliverable)
                 return;
             }
             QPID_LOG(trace, logPrefix << "Received: " << logMessageId(*queue, message));
+            ++receivedMessages;
+            receivedBytes += message.getMessageSize();
         }
         deliver(message);       // Outside lock, will call enqueued()
     }
@@ -371,6 +466,16 @@ void QueueReplicator::idEvent(const string& data, Mutex::ScopedLock&) {
     nextId = decodeStr<IdEvent>(data).id;
 }
 
+void QueueReplicator::caughtUpEvent(const string&, Mutex::ScopedLock& l) {
+    QPID_LOG(debug, logPrefix << "Caught up");
+    if (catchupCredit && sessionHandler) {
+        catchupCredit = false;
+        setWindow(l);
+    }
+    Mutex::ScopedUnlock u(lock); // The scheduler may start other replicators.
+    haBroker.getCatchupScheduler().caughtUp(*this);
+}
+
 bool QueueReplicator::deletedOnPrimary(ErrorCode e, const std::string& msg) {
     if (e == ERROR_CODE_NOT_FOUND || e == ERROR_CODE_RESOURCE_DELETED) {
         // If the queue is destroyed at the same time we are subscribing, we may
@@ -394,6 +499,7 @@ bool QueueReplicator::hasBindings() { return false; }
 std::string QueueReplicator::getType() const { return ReplicatingSubscription::QPID_QUEUE_REPLICATOR; }
 
 void QueueReplicator::promoted() {
+    haBroker.getCatchupScheduler().remove(*this);
     if (queue) {
         // On primary QueueReplicator no longer sets IDs, start an IdSetter.
         QPID_LOG(debug, logPrefix << "Promoted, first replication-id " << maxId+1)
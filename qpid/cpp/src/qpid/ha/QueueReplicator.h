@@ -25,9 +25,12 @@
 
 
 #include "BrokerInfo.h"
+#include "CatchupCredit.h"
+#include "CatchupScheduler.h"
 #include "LogPrefix.h"
 #include "hash.h"
 #include "qpid/broker/Exchange.h"
+#include "qpid/sys/AtomicValue.h"
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/function.hpp>
 #include <iosfwd>
@@ -57,6 +60,10 @@ class Settings;
  * It puts replicated messages on the local replica queue and handles dequeue
  * events by removing local messages.
  *
+ * The HaBroker's CatchupScheduler decides when it subscribes, and while it
+ * is catching up with a rate limit it gets credit from the scheduler
+ * instead of using a flow control window.
+ *
  * THREAD SAFE: Called in different connection threads.
  */
 class QueueReplicator : public broker::Exchange,
@@ -90,6 +97,16 @@ class QueueReplicator : public broker::Exchange,
     // Set if the queue has ever been subscribed to, used for auto-delete cleanup.
     void setSubscribed() { subscribed = true; }
 
+    // Size of the queue on the primary, to schedule catch-up.
+    void setBacklog(const CatchupScheduler::Backlog&);
+
+    // Called by the CatchupScheduler.
+    void startCatchup();
+    void grantCatchupCredit(uint32_t bytes);
+    void endCatchup();
+    uint64_t getReceivedMessages() const { return receivedMessages.get(); }
+    uint64_t getReceivedBytes() const { return receivedBytes.get(); }
+
     boost::shared_ptr<broker::Queue> getQueue() const { return queue; }
 
     // No-op unused Exchange virtual functions.
@@ -130,10 +147,16 @@ class QueueReplicator : public broker::Exchange,
     class QueueObserver;
 
     void initializeBridge(broker::Bridge& bridge, broker::SessionHandler& sessionHandler);
+    void subscribe(sys::Mutex::ScopedLock&);
+    void setWindow(sys::Mutex::ScopedLock&);
+    void ioSubscribe();
+    void ioGrantCredit(uint32_t bytes);
+    void ioEndCatchup();
 
     // Dispatch functions
     void dequeueEvent(const std::string& data, sys::Mutex::ScopedLock&);
     void idEvent(const std::string& data, sys::Mutex::ScopedLock&);
+    void caughtUpEvent(const std::string& data, sys::Mutex::ScopedLock&);
 
     bool deletedOnPrimary(framing::execution::ErrorCode e, const std::string& msg);
 
@@ -146,6 +169,10 @@ class QueueReplicator : public broker::Exchange,
     ReplicationIdSet idSet; // Set of replicationIds on the queue.
     ReplicationId nextId;   // ID for next message to arrive.
     ReplicationId maxId;    // Max ID used so far.
+    CatchupScheduler::Backlog backlog;
+    bool catchupCredit;     // Catching up on credit from the CatchupScheduler.
+    CatchupCredit catchup;
+    sys::AtomicValue<uint64_t> receivedMessages, receivedBytes;
 
   friend class ErrorListener;
 };
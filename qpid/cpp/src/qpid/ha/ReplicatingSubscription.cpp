@@ -22,6 +22,7 @@
 #include "Event.h"
 #include "IdSetter.h"
 #include "QueueGuard.h"
+#include "QueueReplicator.h"
 #include "QueueSnapshot.h"
 #include "ReplicatingSubscription.h"
 #include "Primary.h"
@@ -31,10 +32,13 @@
 #include "qpid/broker/SessionContext.h"
 #include "qpid/broker/amqp_0_10/MessageTransfer.h"
 #include "qpid/framing/AMQFrame.h"
+#include "qpid/framing/AMQP_ClientProxy.h"
+#include "qpid/framing/ExecutionSyncBody.h"
 #include "qpid/framing/MessageTransferBody.h"
 #include "qpid/framing/reply_exceptions.h"
 #include "qpid/log/Statement.h"
 #include "qpid/types/Uuid.h"
+#include <algorithm>
 #include <sstream>
 
 
@@ -50,6 +54,8 @@ namespace { const string QPID_HA(QPID_HA_PREFIX); }
 const string ReplicatingSubscription::QPID_REPLICATING_SUBSCRIPTION(QPID_HA+"repsub");
 const string ReplicatingSubscription::QPID_BROKER_INFO(QPID_HA+"info");
 const string ReplicatingSubscription::QPID_ID_SET(QPID_HA+"ids");
+const string ReplicatingSubscription::QPID_ID_SUMMARY(QPID_HA+"id-summary");
+const string ReplicatingSubscription::QPID_BATCH(QPID_HA+"batch");
 const string ReplicatingSubscription::QPID_QUEUE_REPLICATOR(QPID_HA+"qrep");
 
 /* Called by SemanticState::consume to create a consumer */
@@ -78,6 +84,17 @@ ReplicatingSubscription::Factory::create(
     return rs;
 }
 
+namespace {
+// A batching subscription sends its own syncs, see doDispatch().  The backup
+// still sets a sync frequency for primaries that don't understand QPID_BATCH.
+FieldTable consumerArguments(const FieldTable& arguments) {
+    FieldTable result(arguments);
+    if (arguments.getAsInt(ReplicatingSubscription::QPID_BATCH))
+        result.erase(QueueReplicator::QPID_SYNC_FREQUENCY);
+    return result;
+}
+}
+
 ReplicatingSubscription::ReplicatingSubscription(
     HaBroker& hb,
     SemanticState* parent,
@@ -91,11 +108,13 @@ ReplicatingSubscription::ReplicatingSubscription(
     uint64_t resumeTtl,
     const framing::FieldTable& arguments
 ) : ConsumerImpl(parent, name, queue_, ack, REPLICATOR, exclusive, tag,
-                 resumeId, resumeTtl, arguments),
+                 resumeId, resumeTtl, consumerArguments(arguments)),
     logPrefix(hb.logPrefix),
     position(0), wasStopped(false), ready(false), cancelled(false),
     haBroker(hb),
-    primary(boost::dynamic_pointer_cast<Primary>(haBroker.getRole()))
+    primary(boost::dynamic_pointer_cast<Primary>(haBroker.getRole())),
+    batchSize(std::max(arguments.getAsInt(QPID_BATCH), 0)),
+    batched(0), nextId(0), nextIdKnown(false), caughtUpPending(false), fastResync(false)
 {}
 
 // Called in subscription's connection thread when the subscription is created.
@@ -135,9 +154,15 @@ void ReplicatingSubscription::initialize() {
             throw ResourceDeletedException(logPrefix.get()+"Can't subscribe, queue deleted");
         }
         ReplicationIdSet primaryIds = snapshot->getSnapshot();
-        std::string backupStr = getArguments().getAsString(ReplicatingSubscription::QPID_ID_SET);
         ReplicationIdSet backupIds;
-        if (!backupStr.empty()) backupIds = decodeStr<ReplicationIdSet>(backupStr);
+        std::string backupStr = getArguments().getAsString(ReplicatingSubscription::QPID_ID_SUMMARY);
+        if (!backupStr.empty()) {
+            fastResync = true;
+            backupIds = decodeStr<ReplicationIdSummary>(backupStr).getIds();
+        } else {
+            backupStr = getArguments().getAsString(ReplicatingSubscription::QPID_ID_SET);
+            if (!backupStr.empty()) backupIds = decodeStr<ReplicationIdSet>(backupStr);
+        }
 
         // Initial dequeues are messages on backup but not on primary.
         ReplicationIdSet initDequeues = backupIds - primaryIds;
@@ -147,6 +172,7 @@ void ReplicatingSubscription::initialize() {
             sys::Mutex::ScopedLock l(lock); // Concurrent calls to dequeued()
             dequeues += initDequeues;       // Messages on backup that are not on primary.
             skipEnqueue = backupIds - initDequeues; // Messages already on the backup.
+            if (fastResync) missing = primaryIds - backupIds;
             // Queue front is moving but we know this subscriptions will start at a
             // position >= front so if front is safe then position must be.
             position = front;
@@ -154,7 +180,8 @@ void ReplicatingSubscription::initialize() {
             QPID_LOG(debug, logPrefix << "Subscribed: primary ["
                      << front << "," << back << "]=" << primaryIds
                      << ", guarded " << guard->getFirst()
-                     << ", backup (keep " << skipEnqueue << ", drop " << initDequeues << ")");
+                     << ", backup (keep " << skipEnqueue << ", drop " << initDequeues << ")"
+                     << (fastResync ? ", fast resync" : ""));
             checkReady(l);
         }
 
@@ -188,7 +215,12 @@ void ReplicatingSubscription::stopped() {
 // True if the next position for the ReplicatingSubscription is a guarded position.
 bool ReplicatingSubscription::isGuarded(sys::Mutex::ScopedLock&) {
     // See comment in stopped()
-    return wasStopped || (position+1 >= guard->getFirst());
+    //
+    // In fast resync every unguarded message is either already on the backup or
+    // in missing, so once missing is replicated the rest of the unguarded
+    // messages only need to be skipped, we need not wait to reach the guard.
+    return wasStopped || (position+1 >= guard->getFirst()) ||
+        (fastResync && missing.empty());
 }
 
 // Message is delivered in the subscription's connection thread.
@@ -210,8 +242,15 @@ bool ReplicatingSubscription::deliver(
         else {
             QPID_LOG(trace, logPrefix << "Replicated " << logMessageId(*getQueue(), m));
             if (!ready && !isGuarded(l)) unready += id;
-            sendIdEvent(id, l);
+            missing -= id;
+            // The backup numbers messages consecutively from the last IdEvent.
+            if (!nextIdKnown || id != nextId) {
+                sendIdEvent(id, l);
+                nextIdKnown = true;
+            }
+            nextId = id + 1;
             result = ConsumerImpl::deliver(c, m);
+            ++batched;
         }
         checkReady(l);
         return result;
@@ -225,7 +264,9 @@ bool ReplicatingSubscription::deliver(
 void ReplicatingSubscription::checkReady(sys::Mutex::ScopedLock& l) {
     if (!ready && isGuarded(l) && unready.empty()) {
         ready = true;
+        caughtUpPending = true;
         sys::Mutex::ScopedUnlock u(lock);
+        notify();               // Send the CaughtUpEvent from doDispatch.
         // Notify Primary that a subscription is ready.
         if (position+1 >= guard->getFirst()) {
             QPID_LOG(debug, logPrefix << "Caught up at " << position);
@@ -270,10 +311,11 @@ void ReplicatingSubscription::acknowledged(const broker::DeliveryRecord& r) {
 // Called with lock held. Called in subscription's connection thread.
 void ReplicatingSubscription::sendDequeueEvent(Mutex::ScopedLock& l)
 {
-    ReplicationIdSet oldDequeues = dequeues;
     if (dequeues.empty()) return;
     QPID_LOG(trace, logPrefix << "Sending dequeues " << dequeues);
-    sendEvent(DequeueEvent(dequeues), l);
+    DequeueEvent event(dequeues);
+    dequeues.clear();
+    sendEvent(event, l);
 }
 
 // Called after the message has been removed
@@ -286,6 +328,7 @@ void ReplicatingSubscription::dequeued(const broker::Message& m)
     {
         Mutex::ScopedLock l(lock);
         dequeues.add(id);
+        missing -= id;          // Will never be replicated.
     }
     notify();                   // Ensure a call to doDispatch
 }
@@ -306,15 +349,38 @@ void ReplicatingSubscription::sendEvent(const Event& event, Mutex::ScopedLock&)
     ConsumerImpl::deliver(QueueCursor(), event.message(), boost::shared_ptr<Consumer>());
 }
 
+// Called with lock held. Called in subscription's connection thread.
+// Ask the backup to accept and complete everything sent so far.
+void ReplicatingSubscription::sendSync(Mutex::ScopedLock&)
+{
+    batched = 0;
+    Mutex::ScopedUnlock u(lock);
+    ExecutionSyncBody sync;
+    sync.setSync(true);       // Reply even if all prior commands are complete.
+    getParent().getSession().getProxy().send(sync);
+}
+
 // Called in subscription's connection thread.
 bool ReplicatingSubscription::doDispatch()
 {
     {
         Mutex::ScopedLock l(lock);
         if (!dequeues.empty()) sendDequeueEvent(l);
+        if (caughtUpPending) {
+            caughtUpPending = false;
+            sendEvent(CaughtUpEvent(), l);
+        }
     }
     try {
-        return ConsumerImpl::doDispatch();
+        bool dispatched = ConsumerImpl::doDispatch();
+        if (batchSize) {
+            // End the batch when it is full or we run out of messages or
+            // credit: credit is only restored when the backup completes it.
+            Mutex::ScopedLock l(lock);
+            if (batched && (!dispatched || batched >= batchSize || !getCredit()))
+                sendSync(l);
+        }
+        return dispatched;
     }
     catch (const std::exception& e) {
         QPID_LOG(warning, logPrefix << " exception in dispatch: " << e.what());
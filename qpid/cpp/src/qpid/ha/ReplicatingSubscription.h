@@ -56,11 +56,26 @@ class Primary;
  * messages till the backup has acknowledged, informs backup of locally dequeued
  * messages.
  *
+ * If the backup sets QPID_BATCH the subscription pipelines replication: it
+ * does not ask for each message to be acknowledged, instead it sends an
+ * execution.sync after at most QPID_BATCH messages or when it runs out of
+ * messages or credit, and the backup accepts the whole batch as a range.
+ * IdEvents are only sent when the next ID is not the one the backup expects.
+ *
+ * When it becomes ready the subscription sends a CaughtUpEvent so the
+ * backup's CatchupScheduler can start the next queue.
+ *
  * A ReplicatingSubscription is "ready" when all the messages on the queue have
  * either been acknowledged by the backup, or are protected by the queue guard.
  * On a primary broker the ReplicatingSubscription calls Primary::readyReplica
  * when it is ready.
  *
+ * If the backup sends its messages as a QPID_ID_SUMMARY (fast resync) rather
+ * than a QPID_ID_SET, the subscription is ready as soon as the messages missing
+ * from the backup have been acknowledged; the messages the backup already has
+ * are skipped afterwards. Readiness then depends on the difference between
+ * the queues, not the depth of the queue.
+ *
  * THREAD SAFE: Called in subscription's connection thread but also in arbitrary
  * connection threads via dequeued.
  *
@@ -95,6 +110,8 @@ class ReplicatingSubscription :
     static const std::string QPID_REPLICATING_SUBSCRIPTION;
     static const std::string QPID_BROKER_INFO;
     static const std::string QPID_ID_SET;
+    static const std::string QPID_ID_SUMMARY;
+    static const std::string QPID_BATCH;
     // Replicator types: argument values for QPID_REPLICATING_SUBSCRIPTION argument.
     static const std::string QPID_QUEUE_REPLICATOR;
 
@@ -146,6 +163,7 @@ class ReplicatingSubscription :
     ReplicationIdSet dequeues;  // Dequeues to be sent in next dequeue event.
     ReplicationIdSet skipEnqueue; // Enqueues to skip: messages already on backup.
     ReplicationIdSet unready;   // Unguarded, replicated and un-acknowledged.
+    ReplicationIdSet missing;   // Fast resync: on primary, not on backup, not yet replicated.
     bool wasStopped;
     bool ready;
     bool cancelled;
@@ -153,12 +171,19 @@ class ReplicatingSubscription :
     boost::shared_ptr<QueueGuard> guard;
     HaBroker& haBroker;
     boost::shared_ptr<Primary> primary;
+    const uint32_t batchSize;   // Max messages per acknowledged batch, 0 for no batching.
+    uint32_t batched;           // Messages sent since the last sync.
+    ReplicationId nextId;       // ID the backup will give the next message it receives.
+    bool nextIdKnown;           // False until the first IdEvent is sent.
+    bool caughtUpPending;       // Send a CaughtUpEvent in next doDispatch.
+    bool fastResync;            // Backup sent a ReplicationIdSummary.
 
     bool isGuarded(sys::Mutex::ScopedLock&);
     void dequeued(ReplicationId);
     void sendDequeueEvent(sys::Mutex::ScopedLock&);
     void sendIdEvent(ReplicationId, sys::Mutex::ScopedLock&);
     void sendEvent(const Event&, sys::Mutex::ScopedLock&);
+    void sendSync(sys::Mutex::ScopedLock&);
     void checkReady(sys::Mutex::ScopedLock&);
   friend class Factory;
 };
@@ -38,7 +38,9 @@ class Settings
   public:
     Settings() : cluster(false), queueReplication(false),
                  replicateDefault(NONE), backupTimeout(10*sys::TIME_SEC),
-                 flowMessages(1000), flowBytes(0)
+                 flowMessages(1000), flowBytes(0), replicationBatch(100),
+                 catchupQueues(0), catchupRate(0), catchupTimeout(30*sys::TIME_SEC),
+                 fastResync(false)
     {}
 
     bool cluster;               // True if we are a cluster member.
@@ -50,6 +52,11 @@ class Settings
     sys::Duration backupTimeout;
 
     uint32_t flowMessages, flowBytes;
+    uint32_t replicationBatch;  // Messages acknowledged together, 0 acknowledges each.
+    uint32_t catchupQueues;     // Queues caught up in parallel, 0 for no limit.
+    uint64_t catchupRate;       // Catch-up bytes per second, 0 for no limit.
+    sys::Duration catchupTimeout; // Give up a stalled catch-up, 0 to wait forever.
+    bool fastResync;            // Send replication IDs as a ReplicationIdSummary.
 
     static const uint32_t NO_LIMIT=0xFFFFFFFF;
     static uint32_t flowValue(uint32_t n) { return n ? n : NO_LIMIT; }
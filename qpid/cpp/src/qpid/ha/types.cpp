@@ -23,6 +23,7 @@
 #include "qpid/Msg.h"
 #include "qpid/broker/Message.h"
 #include "qpid/broker/Queue.h"
+#include "qpid/framing/Buffer.h"
 #include "qpid/Exception.h"
 #include <algorithm>
 #include <iostream>
@@ -134,5 +135,117 @@ size_t UuidSet::encodedSize() const {
     return sizeof(uint32_t) + size()*16;
 }
 
+namespace {
+const uint8_t SUMMARY_EMPTY = 0;
+const uint8_t SUMMARY_RANGES = 'r'; // count first size (gap size)*
+const uint8_t SUMMARY_BITMAP = 'b'; // first span bits
+
+// Unsigned integers as 7 bits per octet, low order first, top bit set on
+// all but the last octet.
+size_t varSize(uint32_t i) {
+    size_t n = 1;
+    while (i >>= 7) ++n;
+    return n;
+}
+
+void putVar(framing::Buffer& b, uint32_t i) {
+    for ( ; i >= 0x80; i >>= 7) b.putOctet(uint8_t(i | 0x80));
+    b.putOctet(uint8_t(i));
+}
+
+uint32_t getVar(framing::Buffer& b) {
+    uint32_t i = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t o = b.getOctet();
+        i |= uint32_t(o & 0x7f) << shift;
+        if (!(o & 0x80)) return i;
+    }
+    throw Exception("Invalid replication ID summary");
+}
+}
+
+size_t ReplicationIdSummary::rangesSize() const {
+    size_t size = 1 + varSize(ids.rangesSize()) + sizeof(uint32_t);
+    uint32_t end = 0;
+    for (ReplicationIdSet::RangeIterator i = ids.rangesBegin(); i != ids.rangesEnd(); ++i) {
+        if (i != ids.rangesBegin()) size += varSize(i->begin().getValue() - end);
+        size += varSize(i->size() - 1);
+        end = i->end().getValue();
+    }
+    return size;
+}
+
+size_t ReplicationIdSummary::bitmapSize() const {
+    uint64_t span = uint64_t(ids.span()) + 1;
+    return 1 + 2*sizeof(uint32_t) + (span + 7)/8;
+}
+
+size_t ReplicationIdSummary::encodedSize() const {
+    if (ids.empty()) return 1;
+    return std::min(rangesSize(), bitmapSize());
+}
+
+void ReplicationIdSummary::encode(framing::Buffer& b) const {
+    if (ids.empty()) {
+        b.putOctet(SUMMARY_EMPTY);
+        return;
+    }
+    uint32_t first = ids.front().getValue();
+    if (bitmapSize() < rangesSize()) {
+        uint32_t span = ids.span() + 1;
+        std::string bits((span + 7)/8, '\0');
+        for (ReplicationIdSet::RangeIterator i = ids.rangesBegin(); i != ids.rangesEnd(); ++i) {
+            uint32_t offset = i->begin().getValue() - first;
+            for (size_t n = 0; n < i->size(); ++n, ++offset)
+                bits[offset/8] |= char(1 << offset%8);
+        }
+        b.putOctet(SUMMARY_BITMAP);
+        b.putLong(first);
+        b.putLong(span);
+        b.putRawData(bits);
+    } else {
+        b.putOctet(SUMMARY_RANGES);
+        putVar(b, ids.rangesSize());
+        b.putLong(first);
+        uint32_t end = first;
+        for (ReplicationIdSet::RangeIterator i = ids.rangesBegin(); i != ids.rangesEnd(); ++i) {
+            if (i != ids.rangesBegin()) putVar(b, i->begin().getValue() - end);
+            putVar(b, i->size() - 1);
+            end = i->end().getValue();
+        }
+    }
+}
+
+void ReplicationIdSummary::decode(framing::Buffer& b) {
+    ids.clear();
+    uint8_t type = b.getOctet();
+    if (type == SUMMARY_EMPTY) return;
+    if (type == SUMMARY_BITMAP) {
+        uint32_t first = b.getLong();
+        uint32_t span = b.getLong();
+        if ((uint64_t(span) + 7)/8 > b.available())
+            throw Exception("Invalid replication ID summary");
+        std::string bits;
+        b.getRawData(bits, (span + 7)/8);
+        uint32_t offset = 0;
+        while (offset < span) {
+            if (!(bits[offset/8] & (1 << offset%8))) { ++offset; continue; }
+            uint32_t start = offset;
+            while (offset < span && (bits[offset/8] & (1 << offset%8))) ++offset;
+            ids.add(ReplicationId(first + start), ReplicationId(first + offset - 1));
+        }
+    } else if (type == SUMMARY_RANGES) {
+        uint32_t count = getVar(b);
+        uint32_t begin = b.getLong();
+        for (uint32_t n = 0; n < count; ++n) {
+            if (n) begin += getVar(b);
+            uint32_t last = begin + getVar(b);
+            ids.add(ReplicationId(begin), ReplicationId(last));
+            begin = last + 1;
+        }
+    } else {
+        throw Exception("Invalid replication ID summary");
+    }
+}
 
 }} // namespace qpid::ha
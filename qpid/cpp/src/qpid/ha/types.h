@@ -132,6 +132,29 @@ typedef framing::SequenceNumber ReplicationId;
 typedef framing::SequenceSet QueuePositionSet;
 typedef framing::SequenceSet ReplicationIdSet;
 
+/**
+ * Compact encoding of a ReplicationIdSet, sent by a backup that resyncs
+ * with a primary in fast resync mode. The set is encoded either as its
+ * ranges, with the gaps and sizes as variable length integers, or as a
+ * bitmap over its span when it is fragmented into many small ranges,
+ * whichever is smaller.
+ */
+class ReplicationIdSummary {
+  public:
+    ReplicationIdSummary() {}
+    ReplicationIdSummary(const ReplicationIdSet& s) : ids(s) {}
+    const ReplicationIdSet& getIds() const { return ids; }
+
+    void encode(framing::Buffer&) const;
+    void decode(framing::Buffer&);
+    size_t encodedSize() const;
+
+  private:
+    ReplicationIdSet ids;
+    size_t rangesSize() const;
+    size_t bitmapSize() const;
+};
+
 /** Helpers for logging message ID  */
 std::string logMessageId(const std::string& q, QueuePosition pos, ReplicationId id);
 std::string logMessageId(const std::string& q, ReplicationId id);
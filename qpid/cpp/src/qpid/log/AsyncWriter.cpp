@@ -0,0 +1,337 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/log/AsyncWriter.h"
+#include "qpid/log/Logger.h"
+#include "qpid/Exception.h"
+#include "qpid/Msg.h"
+#include "qpid/sys/SystemInfo.h"
+#include "qpid/sys/Time.h"
+#include <boost/scoped_array.hpp>
+#include <algorithm>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace qpid {
+namespace log {
+
+namespace {
+const size_t CACHE_LINE_SIZE = 64;
+const size_t MIN_RINGS = 4;
+const sys::Duration IDLE_WAIT = 100*sys::TIME_MSEC;
+const sys::Duration BLOCK_WAIT = 10*sys::TIME_MSEC;
+
+// Threads are numbered from 1 on first use to pick their ring.
+sys::AtomicValue<uint32_t> threadCount;
+QPID_TSS uint32_t threadIndex = 0;
+// Set on the background thread: anything it logs is written directly.
+QPID_TSS bool isWriterThread = false;
+
+// Set in a forked child, whose copy of the writer has no thread. Only
+// written while the child has a single thread.
+bool forked = false;
+
+#ifndef _WIN32
+void markForked() { forked = true; }
+#endif
+
+void registerForkHandler() {
+#ifndef _WIN32
+    static int registered = ::pthread_atfork(0, 0, &markForked);
+    (void) registered;
+#endif
+}
+
+int64_t timestamp() {
+    return sys::Duration(sys::AbsTime::Zero(), sys::AbsTime::now());
+}
+
+size_t roundUpPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+}
+
+/**
+ * Bounded multi-producer, single-consumer ring (after Dmitry Vyukov's
+ * bounded queue). Each cell's sequence number says whose turn it is:
+ * equal to the producer position when the cell is free, one past it once
+ * the message is published, and a lap ahead again once consumed.
+ */
+struct AsyncWriter::Ring : private boost::noncopyable {
+    struct Cell {
+        sys::AtomicValue<size_t> sequence;
+        int64_t order;
+        Statement statement;
+        std::string text;
+    };
+
+    sys::AtomicValue<size_t> tail;        // Next producer position.
+    sys::AtomicValue<uint32_t> sleeping;  // Set while the writer waits for messages.
+    char pad[CACHE_LINE_SIZE];            // Keep producers off the consumer's line.
+    size_t head;                          // Next consumer position, writer thread only.
+    sys::AtomicValue<size_t> written;     // Messages passed to the outputs, for flush().
+    const size_t mask;
+    boost::scoped_array<Cell> cells;
+
+    Ring(size_t capacity) : tail(0), sleeping(0), head(0), written(0), mask(capacity-1), cells(new Cell[capacity]) {
+        for (size_t i = 0; i < capacity; ++i) cells[i].sequence = i;
+    }
+
+    bool push(const Statement& s, std::string& text, int64_t order) {
+        size_t pos = tail.get();
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            intptr_t diff = intptr_t(cell->sequence.get()) - intptr_t(pos);
+            if (diff == 0) {
+                if (tail.boolCompareAndSwap(pos, pos+1)) break;
+                pos = tail.get();
+            } else if (diff < 0) {
+                return false;   // Full: the cell still holds the previous lap.
+            } else {
+                pos = tail.get();
+            }
+        }
+        cell->order = order;
+        cell->statement = s;
+        cell->text.swap(text);
+        cell->sequence.fetchAndAdd(1); // Publish.
+        return true;
+    }
+
+    bool ready() {
+        return cells[head & mask].sequence.get() == head+1;
+    }
+
+    bool pop(Entry& e) {
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.get() != head+1) return false;
+        e.order = cell.order;
+        e.statement = cell.statement;
+        e.text.swap(cell.text);
+        cell.sequence.fetchAndAdd(mask); // Free for the next lap: head+capacity.
+        ++head;
+        return true;
+    }
+};
+
+AsyncWriter::Overflow AsyncWriter::overflow(const std::string& name) {
+    if (name == "drop") return DROP;
+    if (name == "count") return COUNT;
+    if (name == "block") return BLOCK;
+    throw Exception(QPID_MSG("Invalid log overflow policy '" << name
+                             << "', expected one of: drop count block"));
+}
+
+AsyncWriter::AsyncWriter(Logger& l, size_t c, Overflow o)
+    : logger(l), policy(o), capacity(c), pid(0), running(false), stopping(false), blocked(0)
+{
+    registerForkHandler();
+    size_t n = std::max(MIN_RINGS, size_t(std::max(sys::SystemInfo::concurrency(), 1L)));
+    size_t size = roundUpPow2(std::max(capacity, size_t(2)));
+    for (size_t i = 0; i < n; ++i) {
+        rings.push_back(new Ring(size));
+        rings.back().sleeping = 1; // Not started: the first push starts it.
+    }
+}
+
+AsyncWriter::~AsyncWriter() {
+    stop();
+}
+
+void AsyncWriter::stop() {
+    bool join;
+    {
+        sys::Monitor::ScopedLock l(monitor);
+        stopping = true;
+        join = running && pid == sys::SystemInfo::getProcessId();
+        running = false;
+        monitor.notifyAll();
+    }
+    if (join) thread.join();
+    // Producers wake the writer again, which starts it after start().
+    for (boost::ptr_vector<Ring>::iterator r = rings.begin(); r != rings.end(); ++r)
+        r->sleeping = 1;
+    // Write anything left, including messages pushed as the thread exited.
+    std::vector<Entry> batch;
+    while (drain(batch))
+        write(batch);
+}
+
+void AsyncWriter::start() {
+    sys::Monitor::ScopedLock l(monitor);
+    stopping = false;
+    // Stragglers pushed while stopped are written once the thread starts.
+    checkRunning();
+}
+
+bool AsyncWriter::matches(size_t c, Overflow o) const {
+    return capacity == c && policy == o;
+}
+
+AsyncWriter::Ring& AsyncWriter::ring() {
+    if (!threadIndex) threadIndex = ++threadCount;
+    return rings[(threadIndex-1) % rings.size()];
+}
+
+bool AsyncWriter::push(const Statement& s, std::string& text) {
+    if (isWriterThread) return false;
+    Ring& r = ring();
+    int64_t order = timestamp();
+    if (!r.push(s, text, order)) {
+        if (forked) wakeWriter();
+        switch (policy) {
+          case DROP:
+            return true;
+          case COUNT:
+            ++dropped;
+            return true;
+          case BLOCK: {
+              sys::Monitor::ScopedLock l(monitor);
+              if (stopping) return false;
+              ++blocked;
+              while (!r.push(s, text, order)) {
+                  if (stopping) {
+                      --blocked;
+                      return false;
+                  }
+                  monitor.notifyAll();
+                  monitor.wait(sys::AbsTime(sys::now(), BLOCK_WAIT));
+              }
+              --blocked;
+          }
+        }
+    }
+    // The publishing fetchAndAdd above orders this read against the
+    // writer setting the ring's sleeping flag before its final check of
+    // the rings. After a fork the writer must be restarted even if its
+    // thread was busy, not asleep, in the parent.
+    if (r.sleeping.get() || forked) wakeWriter();
+    return true;
+}
+
+void AsyncWriter::wakeWriter() {
+    sys::Monitor::ScopedLock l(monitor);
+    checkRunning();
+    monitor.notifyAll();
+}
+
+// Called with monitor locked.
+void AsyncWriter::checkRunning() {
+    uint32_t self = sys::SystemInfo::getProcessId();
+    if ((running && pid == self) || stopping) return;
+    // Not started yet, or the thread was lost in a fork.
+    pid = self;
+    running = true;
+    forked = false;
+    for (boost::ptr_vector<Ring>::iterator r = rings.begin(); r != rings.end(); ++r)
+        r->sleeping = 0;
+    thread = sys::Thread(*this);
+}
+
+bool AsyncWriter::flushed(const std::vector<size_t>& targets) {
+    for (size_t i = 0; i < rings.size(); ++i)
+        if (rings[i].written.get() < targets[i]) return false;
+    return true;
+}
+
+void AsyncWriter::flush() {
+    if (isWriterThread) return;
+    std::vector<size_t> targets;
+    for (boost::ptr_vector<Ring>::iterator r = rings.begin(); r != rings.end(); ++r)
+        targets.push_back(r->tail.get());
+    sys::Monitor::ScopedLock l(monitor);
+    if (flushed(targets)) return;
+    if (stopping) return;       // stop() wrote everything out.
+    checkRunning();
+    ++blocked;
+    while (!flushed(targets)) {
+        monitor.notifyAll();
+        monitor.wait(sys::AbsTime(sys::now(), BLOCK_WAIT));
+    }
+    --blocked;
+}
+
+bool AsyncWriter::drain(std::vector<Entry>& batch) {
+    for (boost::ptr_vector<Ring>::iterator r = rings.begin(); r != rings.end(); ++r) {
+        // At most one lap per ring so a busy ring cannot starve the others.
+        for (size_t i = 0; i <= r->mask; ++i) {
+            batch.push_back(Entry());
+            if (!r->pop(batch.back())) {
+                batch.pop_back();
+                break;
+            }
+        }
+    }
+    return !batch.empty();
+}
+
+void AsyncWriter::write(std::vector<Entry>& batch) {
+    // Rings are drained one after another, restore logging order.
+    std::stable_sort(batch.begin(), batch.end());
+    for (std::vector<Entry>::iterator i = batch.begin(); i != batch.end(); ++i)
+        logger.write(i->statement, i->text);
+    if (policy == COUNT) reportDropped();
+    for (boost::ptr_vector<Ring>::iterator r = rings.begin(); r != rings.end(); ++r) {
+        size_t n = r->head - r->written.get();
+        if (n) r->written += n;
+    }
+    batch.clear();
+}
+
+void AsyncWriter::reportDropped() {
+    uint64_t n = dropped.get();
+    if (n) {
+        dropped -= n;
+        // Logged from the writer thread, so written directly.
+        Statement s = QPID_LOG_STATEMENT_INIT_CAT(warning, system);
+        logger.log(s, QPID_MSG("Asynchronous log buffer overflow, " << n << " log messages dropped"));
+    }
+}
+
+void AsyncWriter::run() {
+    isWriterThread = true;
+    std::vector<Entry> batch;
+    for (;;) {
+        if (drain(batch)) {
+            write(batch);
+            sys::Monitor::ScopedLock l(monitor);
+            if (blocked) monitor.notifyAll();
+            continue;
+        }
+        if (policy == COUNT) reportDropped();
+        sys::Monitor::ScopedLock l(monitor);
+        if (stopping) break;
+        for (boost::ptr_vector<Ring>::iterator r = rings.begin(); r != rings.end(); ++r)
+            ++r->sleeping;
+        bool ready = false;
+        for (boost::ptr_vector<Ring>::iterator r = rings.begin(); !ready && r != rings.end(); ++r)
+            ready = r->ready();
+        if (!ready) monitor.wait(sys::AbsTime(sys::now(), IDLE_WAIT));
+        for (boost::ptr_vector<Ring>::iterator r = rings.begin(); r != rings.end(); ++r)
+            --r->sleeping;
+    }
+}
+
+}} // namespace qpid::log
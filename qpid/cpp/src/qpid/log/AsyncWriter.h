@@ -0,0 +1,128 @@
+#ifndef QPID_LOG_ASYNCWRITER_H
+#define QPID_LOG_ASYNCWRITER_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/log/Statement.h"
+#include "qpid/sys/AtomicValue.h"
+#include "qpid/sys/Monitor.h"
+#include "qpid/sys/Runnable.h"
+#include "qpid/sys/Thread.h"
+#include <boost/noncopyable.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <string>
+#include <vector>
+
+namespace qpid {
+namespace log {
+
+class Logger;
+
+/**
+ * Moves the writing of formatted log messages off the logging thread.
+ *
+ * Logging threads push messages into bounded lock-free rings; a
+ * background thread drains the rings, restores the order in which the
+ * messages were logged and passes them to the Logger's Outputs. Each logging thread is
+ * assigned one ring, so with no more threads than rings a ring has a
+ * single producer.
+ *
+ * When a ring is full the Overflow policy decides whether the message
+ * is dropped silently, dropped and counted (the writer reports the count
+ * as a warning) or whether the logging thread waits for space.
+ *
+ * The background thread is started on first use, and restarted if the
+ * process has forked since, so a Logger configured before daemonizing
+ * still works in the child.
+ *
+ * Messages are put back in order by the monotonic time at which they
+ * were logged, so producers share no counter. An AsyncWriter that has
+ * been stopped may still receive a message from a thread that read the
+ * Logger's writer just before it was replaced; such stragglers are
+ * written when the writer is restarted or destroyed.
+ */
+class AsyncWriter : public sys::Runnable, private boost::noncopyable {
+  public:
+    enum Overflow { DROP, COUNT, BLOCK };
+
+    /** Parse an overflow policy name: drop, count or block. */
+    static Overflow overflow(const std::string& name);
+
+    AsyncWriter(Logger& logger, size_t capacity, Overflow overflow);
+
+    /** Stops the background thread once all pushed messages are written. */
+    ~AsyncWriter();
+
+    /**
+     * Queue a formatted message, taking the contents of text.
+     *@return false if the caller must write the message itself: this is
+     * the case for messages logged by the background thread.
+     */
+    bool push(const Statement& s, std::string& text);
+
+    /** Wait until every message pushed so far has been written. */
+    void flush();
+
+    /** Write out everything pushed so far and stop the background thread. */
+    void stop();
+
+    /** Allow a stopped writer to be used again. */
+    void start();
+
+    /** True if this writer was created with the given settings. */
+    bool matches(size_t capacity, Overflow overflow) const;
+
+    void run();
+
+  private:
+    struct Ring;
+    struct Entry {
+        int64_t order;
+        Statement statement;
+        std::string text;
+        bool operator<(const Entry& e) const { return order < e.order; }
+    };
+
+    Ring& ring();
+    bool drain(std::vector<Entry>& batch);
+    void wakeWriter();
+    void checkRunning();
+    void write(std::vector<Entry>& batch);
+    void reportDropped();
+    bool flushed(const std::vector<size_t>& targets);
+
+    Logger& logger;
+    const Overflow policy;
+    const size_t capacity;
+    boost::ptr_vector<Ring> rings;
+    sys::AtomicValue<uint64_t> dropped;
+    sys::Monitor monitor;
+    sys::Thread thread;
+    uint32_t pid;
+    bool running;
+    bool stopping;
+    uint32_t blocked;
+};
+
+}} // namespace qpid::log
+
+#endif  /*!QPID_LOG_ASYNCWRITER_H*/
@@ -0,0 +1,262 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/log/BinaryTrace.h"
+#include "qpid/Exception.h"
+#include "qpid/sys/AtomicValue.h"
+#include "qpid/sys/Thread.h"
+#include "qpid/sys/Time.h"
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <fstream>
+#include <map>
+#include <string.h>
+
+namespace qpid {
+namespace log {
+
+namespace {
+const size_t BUFFER_SIZE = 256*1024;
+const size_t BATCH_SIZE = 64*1024; // Thread buffer size that triggers a write.
+
+void put8(std::string& b, uint8_t i) { b += char(i); }
+
+void put32(std::string& b, uint32_t i) {
+    char c[4] = { char(i >> 24), char(i >> 16), char(i >> 8), char(i) };
+    b.append(c, sizeof(c));
+}
+
+void put64(std::string& b, uint64_t i) {
+    put32(b, uint32_t(i >> 32));
+    put32(b, uint32_t(i));
+}
+
+void put(std::string& b, const char* data, size_t size) {
+    put32(b, uint32_t(size));
+    b.append(data, size);
+}
+}
+
+/** Records encoded by one thread and not yet written to the file. */
+struct BinaryTrace::Buffer {
+    sys::Mutex lock;
+    std::string data;
+    std::map<const TracePoint*, uint32_t> ids; // Statements defined in the current file.
+    bool open;
+
+    Buffer(bool o) : open(o) {}
+};
+
+namespace {
+/**
+ * Lock order: buffersLock, then a thread's Buffer::lock, then lock.
+ */
+struct TraceFile {
+    sys::Mutex lock;            // Guards out, generation, nextId and TracePoint ids.
+    std::ofstream out;
+    char buffer[BUFFER_SIZE];
+    uint32_t generation;
+    uint32_t nextId;
+    sys::AtomicValue<uint32_t> open;
+    sys::Mutex buffersLock;     // Guards buffers and changes to open.
+    boost::ptr_vector<BinaryTrace::Buffer> buffers;
+
+    TraceFile() : generation(0), nextId(0) {}
+    ~TraceFile() { stop(); }
+
+    // Called with the caller's Buffer::lock held.
+    uint32_t define(TracePoint& p) {
+        sys::Mutex::ScopedLock l(lock);
+        if (p.id && p.generation == generation) return p.id;
+        p.id = ++nextId;
+        p.generation = generation;
+        const Statement& s = *p.statement;
+        std::string b;
+        put8(b, 'D');
+        put32(b, p.id);
+        put8(b, uint8_t(s.level));
+        put8(b, uint8_t(s.category));
+        put(b, s.file, s.file ? ::strlen(s.file) : 0);
+        put32(b, uint32_t(s.line));
+        put(b, s.function, s.function ? ::strlen(s.function) : 0);
+        put(b, p.format, ::strlen(p.format));
+        out.write(b.data(), b.size());
+        return p.id;
+    }
+
+    // Called with the Buffer::lock for data held.
+    void write(std::string& data) {
+        sys::Mutex::ScopedLock l(lock);
+        out.write(data.data(), data.size());
+        data.clear();
+    }
+
+    // Called with buffersLock held.
+    void writeBuffers(bool close) {
+        for (boost::ptr_vector<BinaryTrace::Buffer>::iterator i = buffers.begin(); i != buffers.end(); ++i) {
+            sys::Mutex::ScopedLock l(i->lock);
+            if (!i->data.empty()) write(i->data);
+            if (close) {
+                i->ids.clear();
+                i->open = false;
+            }
+        }
+    }
+
+    void stop() {
+        sys::Mutex::ScopedLock l(buffersLock);
+        if (open.get()) --open;
+        writeBuffers(true);
+        sys::Mutex::ScopedLock f(lock);
+        if (out.is_open()) out.close();
+    }
+
+    BinaryTrace::Buffer& threadBuffer();
+};
+
+TraceFile& traceFile() {
+    static TraceFile file;
+    return file;
+}
+
+QPID_TSS BinaryTrace::Buffer* currentBuffer = 0;
+
+// Buffers are kept until exit, a thread's unwritten records are written
+// by the next flush() or close().
+BinaryTrace::Buffer& TraceFile::threadBuffer() {
+    if (!currentBuffer) {
+        sys::Mutex::ScopedLock l(buffersLock);
+        buffers.push_back(new BinaryTrace::Buffer(open.get()));
+        currentBuffer = &buffers.back();
+    }
+    return *currentBuffer;
+}
+}
+
+void BinaryTrace::open(const std::string& name) {
+    TraceFile& f = traceFile();
+    f.stop();
+    sys::Mutex::ScopedLock b(f.buffersLock);
+    {
+        sys::Mutex::ScopedLock l(f.lock);
+        f.out.clear();
+        f.out.rdbuf()->pubsetbuf(f.buffer, BUFFER_SIZE);
+        f.out.open(name.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!f.out.good())
+            throw Exception("Can't open binary trace file: " + name);
+        // Statement ids from an earlier file are not defined in this one.
+        ++f.generation;
+        f.nextId = 0;
+        f.out.write("QPIDTRC", 7);
+        f.out.put(VERSION);
+        // Nothing buffered to be written twice if the process forks.
+        f.out.flush();
+    }
+    for (boost::ptr_vector<Buffer>::iterator i = f.buffers.begin(); i != f.buffers.end(); ++i) {
+        sys::Mutex::ScopedLock l(i->lock);
+        i->open = true;
+    }
+    ++f.open;
+}
+
+void BinaryTrace::close() {
+    traceFile().stop();
+}
+
+bool BinaryTrace::isOpen() {
+    return traceFile().open.get();
+}
+
+void BinaryTrace::flush() {
+    TraceFile& f = traceFile();
+    sys::Mutex::ScopedLock b(f.buffersLock);
+    f.writeBuffers(false);
+    sys::Mutex::ScopedLock l(f.lock);
+    if (f.out.is_open()) f.out.flush();
+}
+
+BinaryTrace::Record::Record(TracePoint& p)
+    : buffer(traceFile().threadBuffer()), lock(buffer.lock), active(buffer.open)
+{
+    if (!active) return;        // Closed since the caller checked.
+    std::map<const TracePoint*, uint32_t>::const_iterator i = buffer.ids.find(&p);
+    uint32_t id = i == buffer.ids.end() ? buffer.ids[&p] = traceFile().define(p) : i->second;
+    put8(buffer.data, 'R');
+    put32(buffer.data, id);
+    put64(buffer.data, uint64_t(int64_t(sys::Duration::FromEpoch())));
+    put64(buffer.data, sys::Thread::logId());
+}
+
+BinaryTrace::Record::~Record() {
+    if (!active) return;
+    put8(buffer.data, END);
+    if (buffer.data.size() >= BATCH_SIZE)
+        traceFile().write(buffer.data);
+}
+
+BinaryTrace::Record& BinaryTrace::Record::operator<<(int64_t i) {
+    if (active) {
+        put8(buffer.data, INT64);
+        put64(buffer.data, uint64_t(i));
+    }
+    return *this;
+}
+
+BinaryTrace::Record& BinaryTrace::Record::operator<<(uint64_t i) {
+    if (active) {
+        put8(buffer.data, UINT64);
+        put64(buffer.data, i);
+    }
+    return *this;
+}
+
+BinaryTrace::Record& BinaryTrace::Record::operator<<(const std::string& s) {
+    if (active) {
+        put8(buffer.data, STRING);
+        put(buffer.data, s.data(), s.size());
+    }
+    return *this;
+}
+
+BinaryTrace::Record& BinaryTrace::Record::operator<<(const char* s) {
+    if (active) {
+        put8(buffer.data, STRING);
+        put(buffer.data, s, ::strlen(s));
+    }
+    return *this;
+}
+
+BinaryTrace::Record& BinaryTrace::Record::operator<<(const Frames& frames) {
+    if (active) {
+        put8(buffer.data, FRAMES_0_10);
+        put(buffer.data, frames.data, frames.size);
+    }
+    return *this;
+}
+
+BinaryTrace::Record& BinaryTrace::Record::operator<<(const Amqp& bytes) {
+    if (active) {
+        put8(buffer.data, AMQP_1_0);
+        put(buffer.data, bytes.data, bytes.size);
+    }
+    return *this;
+}
+
+}} // namespace qpid::log
@@ -0,0 +1,164 @@
+#ifndef QPID_LOG_BINARYTRACE_H
+#define QPID_LOG_BINARYTRACE_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/log/Statement.h"
+#include "qpid/sys/IntegerTypes.h"
+#include "qpid/sys/Mutex.h"
+#include "qpid/CommonImportExport.h"
+#include <string>
+
+namespace qpid {
+namespace log {
+
+/** Call site of a binary trace statement, see QPID_LOG_BINARY. */
+struct TracePoint {
+    Statement* statement;
+    const char* format;
+    uint32_t id;                // Assigned when first written to a trace file.
+    uint32_t generation;        // Trace file the id belongs to.
+};
+
+/**
+ * Binary trace file for high rate trace logging.
+ *
+ * Text logging formats every argument at the call site, which for
+ * protocol traces costs far more than the work being traced. A binary
+ * trace record holds only the statement id, timestamp, thread and the
+ * raw arguments; frames are copied as encoded on the wire. Each
+ * statement's source location and format are written once, the first
+ * time it is used. qpid-trace-decode turns a trace file back into text.
+ *
+ * File layout, integers in network byte order:
+ *@code
+ * file:       "QPIDTRC" VERSION record*
+ * record:     'D' id:u32 level:u8 category:u8 file:str line:u32 function:str format:str
+ *           | 'R' id:u32 time:u64 thread:u64 argument* END
+ * argument:   INT64 i64 | UINT64 u64 | STRING str | FRAMES_0_10 bin | AMQP_1_0 bin
+ * str, bin:   length:u32 bytes
+ *@endcode
+ * time is nanoseconds since the epoch. In the format each "{}" stands
+ * for the next argument.
+ *
+ * Each thread encodes its records into its own buffer, which is written
+ * to the file when it fills up and on flush() or close(). Records from
+ * one thread are in order but those of different threads are written a
+ * batch at a time, sort on time to interleave them.
+ */
+class BinaryTrace {
+  public:
+    static const char VERSION = 1;
+    enum Tag { END=0, INT64='i', UINT64='u', STRING='s', FRAMES_0_10='f', AMQP_1_0='a' };
+
+    /** Encoded AMQP 0-10 frames, decoded and printed by qpid-trace-decode. */
+    struct Frames {
+        const char* data; size_t size;
+        Frames(const char* d, size_t s) : data(d), size(s) {}
+    };
+
+    /** Raw AMQP 1.0 protocol bytes. */
+    struct Amqp {
+        const char* data; size_t size;
+        Amqp(const char* d, size_t s) : data(d), size(s) {}
+    };
+
+    struct Buffer;
+
+    /**
+     * Writes one trace record, holding the calling thread's buffer lock
+     * from construction to destruction so arguments should be plain values.
+     */
+    class Record {
+      public:
+        QPID_COMMON_EXTERN Record(TracePoint&);
+        QPID_COMMON_EXTERN ~Record();
+        QPID_COMMON_EXTERN Record& operator<<(int64_t);
+        QPID_COMMON_EXTERN Record& operator<<(uint64_t);
+        Record& operator<<(int32_t i) { return *this << int64_t(i); }
+        Record& operator<<(uint32_t i) { return *this << uint64_t(i); }
+        QPID_COMMON_EXTERN Record& operator<<(const std::string&);
+        QPID_COMMON_EXTERN Record& operator<<(const char*);
+        QPID_COMMON_EXTERN Record& operator<<(const Frames&);
+        QPID_COMMON_EXTERN Record& operator<<(const Amqp&);
+      private:
+        Buffer& buffer;
+        sys::Mutex::ScopedLock lock;
+        bool active;
+    };
+
+    /** Start writing binary trace records to file, replacing any current file. */
+    QPID_COMMON_EXTERN static void open(const std::string& file);
+    QPID_COMMON_EXTERN static void close();
+    QPID_COMMON_EXTERN static bool isOpen();
+    /** Write out the records buffered by all threads. */
+    QPID_COMMON_EXTERN static void flush();
+};
+
+/**
+ * Like QPID_LOG but, when a binary trace file is open, writes a binary
+ * record of ARGS instead of formatting MESSAGE. E.g.
+ *@code
+ * QPID_LOG_BINARY(trace, "RECV [{}]: {}",
+ *                 << id << BinaryTrace::Frames(data, size),
+ *                 "RECV [" << id << "]: " << frame);
+ *@endcode
+ * Records are only written for statements enabled by the log selectors.
+ *@param FORMAT string literal describing the record, "{}" per argument.
+ *@param ARGS arguments each preceded by <<, see BinaryTrace::Record.
+ *@param MESSAGE text message as for QPID_LOG.
+ */
+#define QPID_LOG_BINARY(LEVEL, FORMAT, ARGS, MESSAGE)                   \
+    do {                                                                \
+        using ::qpid::log::Statement;                                   \
+        static Statement stmt_= QPID_LOG_STATEMENT_INIT(LEVEL);         \
+        static Statement::Initializer init_(stmt_);                     \
+        static ::qpid::log::TracePoint point_ = { &stmt_, FORMAT, 0, 0 }; \
+        if (stmt_.enabled) {                                            \
+            if (::qpid::log::BinaryTrace::isOpen()) {                   \
+                ::qpid::log::BinaryTrace::Record record_(point_);       \
+                record_ ARGS;                                           \
+            } else {                                                    \
+                stmt_.log(::qpid::Msg() << MESSAGE);                    \
+            }                                                           \
+        }                                                               \
+    } while(0)
+
+/**
+ * Like QPID_LOG_BINARY for statements that have no text form: nothing
+ * is logged unless a binary trace file is open.
+ */
+#define QPID_TRACE_BINARY(LEVEL, FORMAT, ARGS)                          \
+    do {                                                                \
+        using ::qpid::log::Statement;                                   \
+        static Statement stmt_= QPID_LOG_STATEMENT_INIT(LEVEL);         \
+        static Statement::Initializer init_(stmt_);                     \
+        static ::qpid::log::TracePoint point_ = { &stmt_, FORMAT, 0, 0 }; \
+        if (stmt_.enabled && ::qpid::log::BinaryTrace::isOpen()) {      \
+            ::qpid::log::BinaryTrace::Record record_(point_);           \
+            record_ ARGS;                                               \
+        }                                                               \
+    } while(0)
+
+}} // namespace qpid::log
+
+#endif  /*!QPID_LOG_BINARYTRACE_H*/
@@ -17,6 +17,8 @@
  */
 
 #include "qpid/log/Logger.h"
+#include "qpid/log/AsyncWriter.h"
+#include "qpid/log/BinaryTrace.h"
 #include "qpid/log/Options.h"
 #include "qpid/log/SinkOptions.h"
 #include "qpid/memory.h"
@@ -59,7 +61,7 @@ Logger& Logger::instance() {
 #endif
 }
 
-Logger::Logger() : flags(0) {
+Logger::Logger() : flags(0), writer(0) {
     // Disable automatic logging in Exception constructors to avoid
     // re-entrant use of logger singleton if there is an error in
     // option parsing.
@@ -112,11 +114,16 @@ void Logger::log(const Statement& s, const std::string& msg) {
         os << " ";
     os << msg << endl;
     std::string formatted=os.str();
-    {
-        ScopedLock l(lock);
-        std::for_each(outputs.begin(), outputs.end(),
-                      boost::bind(&Output::log, _1, s, formatted));
-    }
+    AsyncWriter* w = writer;
+    if (w && w->push(s, formatted))
+        return;
+    write(s, formatted);
+}
+
+void Logger::write(const Statement& s, const std::string& formatted) {
+    ScopedLock l(lock);
+    std::for_each(outputs.begin(), outputs.end(),
+                  boost::bind(&Output::log, _1, s, formatted));
 }
 
 void Logger::output(std::auto_ptr<Output> out) {
@@ -125,12 +132,25 @@ void Logger::output(std::auto_ptr<Output> out) {
 }
 
 void Logger::clear() {
+    AsyncWriter* w;
+    {
+        ScopedLock l(lock);
+        w = writer;
+        writer = 0;
+    }
+    if (w) w->stop();           // Writes out anything still queued.
     select(Selector());         // locked
     format(0);                  // locked
     ScopedLock l(lock);
     outputs.clear();
 }
 
+void Logger::flush() {
+    AsyncWriter* w = writer;
+    if (w) w->flush();
+    if (BinaryTrace::isOpen()) BinaryTrace::flush();
+}
+
 void Logger::format(int formatFlags) {
     ScopedLock l(lock);
     flags=formatFlags;
@@ -160,6 +180,7 @@ void Logger::add(Statement& s) {
 }
 
 void Logger::configure(const Options& opts) {
+    AsyncWriter::Overflow overflow = AsyncWriter::overflow(opts.asyncOverflow);
     clear();
     Options o(opts);
     if (o.trace)
@@ -169,6 +190,23 @@ void Logger::configure(const Options& opts) {
     options = opts;
     setPrefix(opts.prefix);
     options.sinkOptions->setup(this);
+    if (opts.binaryTrace.empty())
+        BinaryTrace::close();
+    else
+        BinaryTrace::open(opts.binaryTrace);
+    if (opts.async) {
+        ScopedLock l(lock);
+        AsyncWriter* w = 0;
+        for (boost::ptr_vector<AsyncWriter>::iterator i = writers.begin(); !w && i != writers.end(); ++i)
+            if (i->matches(opts.asyncBuffer, overflow)) w = &*i;
+        if (w) {
+            w->start();
+        } else {
+            writers.push_back(new AsyncWriter(*this, opts.asyncBuffer, overflow));
+            w = &writers.back();
+        }
+        writer = w;
+    }
 }
 
 void Logger::reconfigure(const std::vector<std::string>& selectors) {
@@ -23,6 +23,8 @@
 namespace qpid {
 namespace log {
 
+class AsyncWriter;
+
 /**
  * Central logging agent.
  *
@@ -32,6 +34,10 @@ namespace log {
  * formatting logging output. The actual outputting of log records
  * is handled by Logger::Output-derived classes instantiated by the
  * platform's sink-related options.
+ *
+ * With the log-async option the Outputs are called from a background
+ * thread: log() formats the message and queues it without taking the
+ * Logger lock.
  */
 class QPID_COMMON_CLASS_EXTERN Logger : private boost::noncopyable {
   public:
@@ -92,6 +98,10 @@ class QPID_COMMON_CLASS_EXTERN Logger : private boost::noncopyable {
     /** Reset the logger. */
     QPID_COMMON_EXTERN void clear();
 
+    /** Wait until all messages logged so far have been passed to the outputs
+     * and the binary trace file. */
+    QPID_COMMON_EXTERN void flush();
+
     /** Get the options used to configure the logger. */
     QPID_COMMON_INLINE_EXTERN const Options& getOptions() const { return options; }
 
@@ -105,8 +115,11 @@ class QPID_COMMON_CLASS_EXTERN Logger : private boost::noncopyable {
     typedef boost::ptr_vector<Output> Outputs;
     typedef std::set<Statement*> Statements;
 
+    friend class AsyncWriter;
+
     sys::Mutex lock;
     inline void enable_unlocked(Statement* s);
+    void write(const Statement&, const std::string&);
 
     Statements statements;
     Outputs outputs;
@@ -114,6 +127,10 @@ class QPID_COMMON_CLASS_EXTERN Logger : private boost::noncopyable {
     int flags;
     std::string prefix;
     Options options;
+    // Writers are kept until the Logger is destroyed so a thread that read
+    // writer just before clear() never pushes to a deleted one.
+    boost::ptr_vector<AsyncWriter> writers;
+    AsyncWriter* writer;
 };
 
 }} // namespace qpid::log
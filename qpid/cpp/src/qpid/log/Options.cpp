@@ -39,6 +39,9 @@ Options::Options(const std::string& argv0_, const std::string& name_) :
     hiresTs(false),
     category(true),
     trace(false),
+    async(false),
+    asyncBuffer(4096),
+    asyncOverflow("count"),
     sinkOptions (SinkOptions::create(argv0_))
 {
     selectors.push_back("notice+");
@@ -83,6 +86,16 @@ Options::Options(const std::string& argv0_, const std::string& name_) :
         ("log-hires-timestamp", optValue(hiresTs,"yes|no"), "Use hi-resolution timestamps in log messages")
         ("log-category", optValue(category,"yes|no"), "Include category in log messages")
         ("log-prefix", optValue(prefix,"STRING"), "Prefix to prepend to all log messages")
+        ("log-async", optValue(async,"yes|no"),
+         "Write log messages from a background thread so that logging threads do not wait for the output")
+        ("log-async-buffer", optValue(asyncBuffer,"N"),
+         "Number of messages each asynchronous logging ring buffer can hold")
+        ("log-async-overflow", optValue(asyncOverflow,"drop|count|block"),
+         "When an asynchronous logging buffer is full: drop the message, drop it and report how many "
+         "were dropped, or block until there is room")
+        ("log-binary-trace", optValue(binaryTrace,"FILE"),
+         "Write enabled protocol trace statements to FILE in binary form instead of formatting them "
+         "as text. Use qpid-trace-decode to read FILE")
         ;
     add(*sinkOptions);
 }
@@ -102,6 +115,10 @@ Options::Options(const Options &o) :
     category(o.category),
     trace(o.trace),
     prefix(o.prefix),
+    async(o.async),
+    asyncBuffer(o.asyncBuffer),
+    asyncOverflow(o.asyncOverflow),
+    binaryTrace(o.binaryTrace),
     sinkOptions (SinkOptions::create(o.argv0))
 {
     *sinkOptions = *o.sinkOptions;
@@ -122,6 +139,10 @@ Options& Options::operator=(const Options& x) {
         category = x.category;
         trace = x.trace;
         prefix = x.prefix;
+        async = x.async;
+        asyncBuffer = x.asyncBuffer;
+        asyncOverflow = x.asyncOverflow;
+        binaryTrace = x.binaryTrace;
         *sinkOptions = *x.sinkOptions;
     }
     return *this;
@@ -43,6 +43,10 @@ struct Options : public qpid::Options {
     bool time, level, thread, source, function, hiresTs, category;
     bool trace;
     std::string prefix;
+    bool async;
+    size_t asyncBuffer;
+    std::string asyncOverflow;
+    std::string binaryTrace;
     std::auto_ptr<SinkOptions> sinkOptions;
 };
 
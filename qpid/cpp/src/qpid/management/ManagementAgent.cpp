@@ -205,6 +205,10 @@ ManagementAgent::~ManagementAgent ()
 
         remoteAgents.clear();
     }
+    // Objects may outlive the agent, stop them reporting changes to it
+    sys::Mutex::ScopedLock lock(objectLock);
+    for (ManagementObjectMap::iterator i = managementObjects.begin(); i != managementObjects.end(); ++i)
+        i->second->setListener(0);
 }
 
 void ManagementAgent::configure(const string& _dataDir, bool _publish, uint16_t _interval,
@@ -699,6 +703,42 @@ void ManagementAgent::moveNewObjects()
                 managementObjects.erase(destIter);
             }
             managementObjects[oid] = object;
+            // Newly added objects are always published, after which
+            // they report their own changes.
+            object->setChangeQueued();
+            object->setListener(this);
+            sys::Mutex::ScopedLock l(changeLock);
+            changedObjects.insert(oid);
+        }
+    }
+}
+
+/** Called when a managed object changes for the first time since it
+ * was last published.  May be called on any thread.
+ */
+void ManagementAgent::objectChanged(ManagementObject& object)
+{
+    sys::Mutex::ScopedLock l(changeLock);
+    changedObjects.insert(object.getObjectId());
+}
+
+/** Collect the objects that have changed since they were last
+ * published.  Clearing their queued flag before they are encoded means
+ * any change made from now on queues them again for the next cycle.
+ */
+void ManagementAgent::takeChangedObjects(ManagementObjectVector& changed)
+{
+    std::set<ObjectId> ids;
+    sys::Mutex::ScopedLock objLock(objectLock);
+    {
+        sys::Mutex::ScopedLock l(changeLock);
+        ids.swap(changedObjects);
+        for (std::set<ObjectId>::const_iterator i = ids.begin(); i != ids.end(); ++i) {
+            ManagementObjectMap::iterator j = managementObjects.find(*i);
+            if (j != managementObjects.end()) {
+                j->second->clearChangeQueued();
+                changed.push_back(j->second);
+            }
         }
     }
 }
@@ -723,10 +763,14 @@ void ManagementAgent::periodicProcessing (void)
     }
 
     //
-    //  Use a copy of the management object map to avoid holding the objectLock
+    //  Only objects that have changed since the last cycle need to be
+    //  published, unless a new client needs to be sent everything.  Use
+    //  a copy of the objects to avoid holding the objectLock.
     //
     ManagementObjectVector localManagementObjects;
-    {
+    takeChangedObjects(localManagementObjects);
+    if (clientWasAdded) {
+        localManagementObjects.clear();
         sys::Mutex::ScopedLock objLock(objectLock);
         std::transform(managementObjects.begin(), managementObjects.end(),
                        std::back_inserter(localManagementObjects),
@@ -754,7 +798,7 @@ void ManagementAgent::periodicProcessing (void)
     // if we sent the active update first, _then_ the delete update, clients
     // would incorrectly think the object was deleted.  See QPID-2997
     //
-    bool objectsDeleted = moveDeletedObjects();
+    bool objectsDeleted = moveDeletedObjects(localManagementObjects);
     PendingDeletedObjsMap localPendingDeletedObjs;
     {
         sys::Mutex::ScopedLock objLock(objectLock);
@@ -1097,6 +1141,7 @@ void ManagementAgent::deleteObjectNow(const ObjectId& oid)
         if (!object->isDeleted())
             return;
         managementObjects.erase(oid);
+        object->setListener(0);
     }
 
 #define DNOW_BUFSIZE 2048
@@ -2764,34 +2809,39 @@ ManagementAgent::DeletedObject::DeletedObject(ManagementObject::shared_ptr src,
     }
 }
 
-// Remove Deleted objects, and save for later publishing...
-bool ManagementAgent::moveDeletedObjects() {
-    typedef vector<pair<ObjectId, ManagementObject::shared_ptr> > DeleteList;
-
+// Remove Deleted objects, and save for later publishing...  Objects
+// report being deleted as a change, so only changed objects need to be
+// checked.
+bool ManagementAgent::moveDeletedObjects(const ManagementObjectVector& candidates) {
     sys::Mutex::ScopedLock lock (objectLock);
 
-    DeleteList deleteList;
-    for (ManagementObjectMap::iterator iter = managementObjects.begin();
-         iter != managementObjects.end();
+    ManagementObjectVector deleteList;
+    for (ManagementObjectVector::const_iterator iter = candidates.begin();
+         iter != candidates.end();
          ++iter)
     {
-        ManagementObject::shared_ptr object = iter->second;
-        if (object->isDeleted()) deleteList.push_back(*iter);
+        if ((*iter)->isDeleted()) deleteList.push_back(*iter);
     }
 
     // Iterate in reverse over deleted object list
-    for (DeleteList::reverse_iterator iter = deleteList.rbegin();
+    bool removed = false;
+    for (ManagementObjectVector::reverse_iterator iter = deleteList.rbegin();
          iter != deleteList.rend();
          iter++)
     {
-        ManagementObject::shared_ptr delObj = iter->second;
+        ManagementObject::shared_ptr delObj = *iter;
         assert(delObj->isDeleted());
+        ManagementObjectMap::iterator i = managementObjects.find(delObj->getObjectId());
+        // Skip if it was already removed or replaced by a new object with the same id
+        if (i == managementObjects.end() || i->second != delObj) continue;
         DeletedObject::shared_ptr dptr(new DeletedObject(delObj, qmf1Support, qmf2Support));
 
         pendingDeletedObjs[dptr->getKey()].push_back(dptr);
-        managementObjects.erase(iter->first);
+        managementObjects.erase(i);
+        delObj->setListener(0);
+        removed = true;
     }
-    return !deleteList.empty();
+    return removed;
 }
 
 ManagementAgent::EventQueue::Batch::const_iterator ManagementAgent::sendEvents(
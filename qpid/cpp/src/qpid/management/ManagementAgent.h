@@ -40,6 +40,7 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <set>
 
 namespace qpid {
 namespace broker {
@@ -51,7 +52,7 @@ class Timer;
 }
 namespace management {
 
-class ManagementAgent
+class ManagementAgent : public ManagementObjectListener
 {
 private:
 
@@ -239,14 +240,22 @@ private:
     //
     ManagementObjectVector       newManagementObjects;
 
+    //
+    // Objects in managementObjects that have changed since they were
+    // last published.  Protected by changeLock.
+    //
+    std::set<ObjectId>           changedObjects;
+
     framing::Uuid                uuid;
 
     //
-    // Lock ordering:  userLock -> addLock -> objectLock
+    // Lock ordering:  userLock -> addLock -> objectLock ->
+    //                 ManagementObject::listenerLock() -> changeLock
     //
     sys::Mutex userLock;
     sys::Mutex addLock;
     sys::Mutex objectLock;
+    sys::Mutex changeLock;
 
     qpid::broker::Exchange::shared_ptr mExchange;
     qpid::broker::Exchange::shared_ptr dExchange;
@@ -331,7 +340,9 @@ private:
                     const std::string& routingKey,
                     uint64_t ttl_msec = 0);
     void moveNewObjects();
-    bool moveDeletedObjects();
+    bool moveDeletedObjects(const ManagementObjectVector& candidates);
+    void takeChangedObjects(ManagementObjectVector& changed);
+    void objectChanged(ManagementObject&);
 
     bool authorizeAgentMessage(qpid::broker::Message& msg);
     void dispatchAgentCommand(qpid::broker::Message& msg, bool viaLocal=false);
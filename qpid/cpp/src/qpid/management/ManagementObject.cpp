@@ -29,6 +29,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include <stdlib.h>
+#include <cmath>
 
 using namespace std;
 using namespace qpid;
@@ -245,11 +246,39 @@ ostream& operator<<(ostream& out, const ObjectId& i)
 
 }}
 
+const size_t Histogram::BUCKETS;
+
+uint64_t Histogram::percentile(const uint64_t* buckets, uint64_t count,
+                               uint64_t max, double fraction)
+{
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * count));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS - 1; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = uint64_t(1) << (i + 10);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+types::Variant::List Histogram::list(const uint64_t* buckets)
+{
+    types::Variant::List result;
+    for (size_t i = 0; i < BUCKETS; ++i)
+        result.push_back(buckets[i]);
+    return result;
+}
+
 ManagementObject::ManagementObject(Manageable* _core) :
     createTime(qpid::sys::Duration::FromEpoch()),
     destroyTime(0), updateTime(createTime), configChanged(true),
     instChanged(true), deleted(false),
-    coreObject(_core), flags(0), forcePublish(false) {}
+    coreObject(_core), flags(0), forcePublish(false),
+    changeQueued(0), listener(0) {}
 
 void ManagementObject::setUpdateTime()
 {
@@ -261,6 +290,48 @@ void ManagementObject::resourceDestroy()
     QPID_LOG(trace, "Management object marked deleted: " << getObjectId().getV2Key());
     destroyTime = sys::Duration::FromEpoch();
     deleted     = true;
+    queueChange();  // Not notifyChange(): a deletion must never be missed
+}
+
+void* ManagementObject::allocateThreadStats(size_t size)
+{
+    // Over-allocate so the block can be aligned, and keep the address
+    // actually allocated just in front of it for freeThreadStats().
+    size = (size + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+    char* raw = new char[size + CACHE_LINE_SIZE + sizeof(char*)];
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw + sizeof(char*));
+    char* aligned = reinterpret_cast<char*>((start + CACHE_LINE_SIZE - 1) & ~uintptr_t(CACHE_LINE_SIZE - 1));
+    reinterpret_cast<char**>(aligned)[-1] = raw;
+    return aligned;
+}
+
+void ManagementObject::freeThreadStats(void* stats)
+{
+    if (stats) delete [] reinterpret_cast<char**>(stats)[-1];
+}
+
+namespace {
+// Striped so that objects changing on different threads rarely contend.
+const size_t LISTENER_LOCKS = 64;
+Mutex listenerLocks[LISTENER_LOCKS];
+}
+
+Mutex& ManagementObject::listenerLock()
+{
+    return listenerLocks[(reinterpret_cast<uintptr_t>(this) / sizeof(void*)) % LISTENER_LOCKS];
+}
+
+void ManagementObject::setListener(ManagementObjectListener* l)
+{
+    Mutex::ScopedLock lock(listenerLock());
+    listener = l;
+}
+
+void ManagementObject::queueChange()
+{
+    // Hold the lock while calling so setListener(0) waits for us.
+    Mutex::ScopedLock lock(listenerLock());
+    if (listener) listener->objectChanged(*this);
 }
 
 int ManagementObject::maxThreads = 1;
@@ -24,6 +24,7 @@
 #include "qpid/CommonImportExport.h"
 
 #include "qpid/management/Mutex.h"
+#include "qpid/sys/AtomicValue.h"
 #include "qpid/types/Variant.h"
 #include <map>
 #include <vector>
@@ -134,6 +135,46 @@ public:
     virtual ~ManagementItem() {}
 };
 
+/**
+ * Support for "hist" style statistics: log-bucketed histograms of
+ * values in nanoseconds. Bucket 0 counts values below 2^10 (about a
+ * microsecond), bucket n counts values in [2^(n+9), 2^(n+10)) and the
+ * last bucket also counts everything larger (about 18.3 minutes and up).
+ */
+class Histogram {
+public:
+    static const size_t BUCKETS = 32;
+
+    static size_t bucket(uint64_t value) {
+        // floor(log2(value)) without a loop over every bit
+        size_t n = 0;
+        if (value >> 32) { value >>= 32; n += 32; }
+        if (value >> 16) { value >>= 16; n += 16; }
+        if (value >> 8)  { value >>= 8;  n += 8; }
+        if (value >> 4)  { value >>= 4;  n += 4; }
+        if (value >> 2)  { value >>= 2;  n += 2; }
+        if (value >> 1)  { n += 1; }
+        if (n < 10) return 0;
+        return n - 9 < BUCKETS ? n - 9 : BUCKETS - 1;
+    }
+
+    /** Upper bound of the bucket holding the given fraction (e.g. 0.99) of count values, capped at max */
+    QPID_COMMON_EXTERN static uint64_t percentile(const uint64_t* buckets, uint64_t count,
+                                                  uint64_t max, double fraction);
+    QPID_COMMON_EXTERN static types::Variant::List list(const uint64_t* buckets);
+};
+
+/**
+ * Told about a ManagementObject the first time it changes after it was
+ * last published, so that publishing need not scan every object.
+ */
+class ManagementObjectListener
+{
+  public:
+    virtual ~ManagementObjectListener() {}
+    virtual void objectChanged(ManagementObject&) = 0;
+};
+
 class QPID_COMMON_CLASS_EXTERN ManagementObject : public ManagementItem
 {
 protected:
@@ -151,11 +192,37 @@ protected:
 
     static int nextThreadIndex;
     bool             forcePublish;
+    // Non-zero while the object is in its listener's changed set.
+    // Cleared by the listener before the object is published, so any
+    // change from then on queues it again.
+    sys::AtomicValue<uint32_t> changeQueued;
+    // Guarded by listenerLock(): an object can outlive its listener.
+    ManagementObjectListener* listener;
 
     QPID_COMMON_EXTERN int  getThreadIndex();
     QPID_COMMON_EXTERN void writeTimestamps(std::string& buf) const;
     QPID_COMMON_EXTERN void readTimestamps(const std::string& buf);
     QPID_COMMON_EXTERN uint32_t writeTimestampsSize() const;
+    QPID_COMMON_EXTERN void queueChange();
+    QPID_COMMON_EXTERN Mutex& listenerLock();
+
+    /**
+     * Per-thread statistics blocks are allocated on cache line
+     * boundaries and padded to a whole number of lines, so that threads
+     * updating their own counters never share a line with another.
+     */
+    static const size_t CACHE_LINE_SIZE = 64;
+    QPID_COMMON_EXTERN static void* allocateThreadStats(size_t size);
+    QPID_COMMON_EXTERN static void freeThreadStats(void* stats);
+
+    /**
+     * Called after setting configChanged or instChanged. Most calls find
+     * the object already queued, so check with a plain read before the
+     * locked compare-and-swap.
+     */
+    inline void notifyChange() {
+        if (!changeQueued.peek() && changeQueued.boolCompareAndSwap(0, 1)) queueChange();
+    }
 
   public:
 #ifdef _IN_QPID_BROKER
@@ -212,6 +279,11 @@ protected:
     QPID_COMMON_EXTERN void setUpdateTime();
     QPID_COMMON_EXTERN void resourceDestroy();
     inline bool isDeleted() { return deleted; }
+    QPID_COMMON_EXTERN void setListener(ManagementObjectListener* l);
+    /** Mark the object queued, @return false if it already was. */
+    inline bool setChangeQueued() { return changeQueued.boolCompareAndSwap(0, 1); }
+    inline void clearChangeQueued() { changeQueued.boolCompareAndSwap(1, 0); }
+    inline bool getChangeQueued() { return changeQueued.get() != 0; }
     inline void setFlags(uint32_t f) { flags = f; }
     inline uint32_t getFlags() { return flags; }
     bool isSameClass(ManagementObject& other) {
@@ -0,0 +1,86 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+#include "qpid/messaging/AdaptiveCredit.h"
+#include <algorithm>
+
+namespace qpid {
+namespace messaging {
+
+namespace {
+// Waits shorter than this were satisfied from messages already
+// prefetched and say nothing about the round trip.
+const qpid::sys::Duration MIN_STALL = 50 * qpid::sys::TIME_USEC;
+// Cap a single wait so an idle producer does not inflate the estimate.
+const double MAX_DELAY = 1.0;
+// Without stalls the delay estimate decays, probing for a smaller window.
+const double DECAY = 0.875;
+// Window is sized at this multiple of the bandwidth-delay product.
+const double HEADROOM = 2.0;
+}
+
+AdaptiveCredit::AdaptiveCredit(uint32_t min_, uint32_t max_) :
+    min(std::max(min_, 1u)), max(std::max(max_, std::max(min_, 1u))),
+    count(0), stalled(false), rate(0), delay(0), start(qpid::sys::AbsTime::now()) {}
+
+uint32_t AdaptiveCredit::bound(uint32_t window) const
+{
+    return std::min(max, std::max(min, window));
+}
+
+void AdaptiveCredit::waited(qpid::sys::Duration d)
+{
+    if (d < MIN_STALL) return;
+    double sample = std::min(MAX_DELAY, double(int64_t(d)) / qpid::sys::TIME_SEC);
+    delay = stalled ? std::max(delay, sample) : (delay ? (3*delay + sample)/4 : sample);
+    stalled = true;
+}
+
+bool AdaptiveCredit::consumed(uint32_t& window)
+{
+    // Re-evaluate once per half window, the same cadence at which
+    // credit is replenished.
+    if (++count < std::max(window/2, 1u)) return false;
+
+    qpid::sys::AbsTime now = qpid::sys::AbsTime::now();
+    double elapsed = double(int64_t(qpid::sys::Duration(start, now))) / qpid::sys::TIME_SEC;
+    if (elapsed > 0) {
+        double sample = count / elapsed;
+        rate = rate ? (rate + sample)/2 : sample;
+    }
+    start = now;
+    count = 0;
+    if (!stalled) delay *= DECAY;
+    stalled = false;
+    // Until a stall has been measured there is no round trip to size the
+    // window from, keep the one the application asked for.
+    if (!delay) return false;
+
+    uint32_t target = bound(uint32_t(std::min(rate * delay * HEADROOM, double(max))));
+    uint32_t difference = target > window ? target - window : window - target;
+    if (difference && difference >= std::max(window/4, 1u)) {
+        window = target;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+}} // namespace qpid::messaging
@@ -0,0 +1,71 @@
+#ifndef QPID_MESSAGING_ADAPTIVECREDIT_H
+#define QPID_MESSAGING_ADAPTIVECREDIT_H
+
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+#include "qpid/messaging/ImportExport.h"
+#include "qpid/sys/IntegerTypes.h"
+#include "qpid/sys/Time.h"
+
+namespace qpid {
+namespace messaging {
+
+/**
+ * Sizes the prefetch window of a receiver from the rate at which the
+ * application consumes messages and the time it spends waiting for
+ * deliveries once the window runs dry, which approximates the round
+ * trip needed to replenish credit. The window is always kept within
+ * the configured bounds, and is left as it is until the first stall
+ * has been measured.
+ *
+ * Not thread safe; callers must serialise access.
+ */
+class AdaptiveCredit
+{
+  public:
+    QPID_MESSAGING_EXTERN AdaptiveCredit(uint32_t min, uint32_t max);
+    /**
+     * Records that the application has consumed a message. Returns
+     * true if the window should be resized, in which case window is
+     * updated to the new size.
+     */
+    QPID_MESSAGING_EXTERN bool consumed(uint32_t& window);
+    /**
+     * Records that the application waited for the specified time for
+     * a message to be delivered.
+     */
+    QPID_MESSAGING_EXTERN void waited(qpid::sys::Duration);
+    /**
+     * Returns the specified window adjusted to lie within bounds.
+     */
+    QPID_MESSAGING_EXTERN uint32_t bound(uint32_t window) const;
+  private:
+    const uint32_t min;
+    const uint32_t max;
+    uint32_t count;
+    bool stalled;
+    double rate;  // messages consumed per second
+    double delay; // seconds waited when the window ran dry
+    qpid::sys::AbsTime start;
+};
+}} // namespace qpid::messaging
+
+#endif  /*!QPID_MESSAGING_ADAPTIVECREDIT_H*/
@@ -52,7 +52,8 @@ void merge(const qpid::types::Variant::List& from, std::vector<std::string>& to)
 
 ConnectionOptions::ConnectionOptions(const std::map<std::string, qpid::types::Variant>& options)
     : replaceUrls(false), reconnect(false), timeout(FOREVER), limit(-1), minReconnectInterval(0.001), maxReconnectInterval(2),
-      retries(0), reconnectOnLimitExceeded(true), nestAnnotations(false), setToOnSend(false)
+      retries(0), reconnectOnLimitExceeded(true), nestAnnotations(false), setToOnSend(false),
+      adaptiveCapacity(false), adaptiveCapacityMin(1), adaptiveCapacityMax(65535)
 {
     // By default we want the sasl service name to be "amqp" for 1.0
     // this will be overridden by a parsed "sasl-service" option
@@ -125,6 +126,12 @@ void ConnectionOptions::set(const std::string& name, const qpid::types::Variant&
         nestAnnotations = value;
     } else if (name == "set-to-on-send" || name == "set_to_on_send") {
         setToOnSend = value;
+    } else if (name == "adaptive-capacity" || name == "adaptive_capacity") {
+        adaptiveCapacity = value;
+    } else if (name == "adaptive-capacity-min" || name == "adaptive_capacity_min") {
+        adaptiveCapacityMin = value;
+    } else if (name == "adaptive-capacity-max" || name == "adaptive_capacity_max") {
+        adaptiveCapacityMax = value;
     } else if (name == "properties" || name == "client-properties" || name == "client_properties") {
         properties = value.asMap();
     } else {
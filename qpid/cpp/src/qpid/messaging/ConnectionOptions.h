@@ -47,6 +47,9 @@ struct ConnectionOptions : qpid::client::ConnectionSettings
     std::string identifier;
     bool nestAnnotations;
     bool setToOnSend;
+    bool adaptiveCapacity;
+    uint32_t adaptiveCapacityMin;
+    uint32_t adaptiveCapacityMax;
     std::map<std::string, qpid::types::Variant> properties;
 
     QPID_MESSAGING_EXTERN ConnectionOptions(const std::map<std::string, qpid::types::Variant>&);
@@ -50,6 +50,13 @@ bool Receiver::fetch(Message& message, Duration timeout)
     return impl->fetch(message, timeout);
 }
 Message Receiver::fetch(Duration timeout) { return impl->fetch(timeout); }
+uint32_t Receiver::fetch(std::vector<Message>& batch, Duration timeout)
+{
+    for (std::vector<Message>::iterator i = batch.begin(); i != batch.end(); ++i) {
+        MessageImplAccess::get(*i).clear();
+    }
+    return impl->fetch(batch, timeout);
+}
 void Receiver::setCapacity(uint32_t c) { impl->setCapacity(c); }
 uint32_t Receiver::getCapacity() { return impl->getCapacity(); }
 uint32_t Receiver::getAvailable() { return impl->getAvailable(); }
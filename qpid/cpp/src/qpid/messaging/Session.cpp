@@ -44,6 +44,12 @@ void Session::rollback() { impl->rollback(); }
 void Session::acknowledge(bool sync) { impl->acknowledge(sync); }
 void Session::acknowledge(Message& m, bool s) { impl->acknowledge(m, false); sync(s); }
 void Session::acknowledgeUpTo(Message& m, bool s) { impl->acknowledge(m, true); sync(s); }
+void Session::acknowledge(std::vector<Message>& batch, uint32_t count, bool s)
+{
+    if (count > batch.size()) count = batch.size();
+    if (count) impl->acknowledge(batch, count);
+    sync(s);
+}
 void Session::reject(Message& m) { impl->reject(m); }
 void Session::release(Message& m) { impl->release(m); }
 void Session::close() { impl->close(); }
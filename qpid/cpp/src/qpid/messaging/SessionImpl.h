@@ -23,6 +23,7 @@
  */
 #include "qpid/RefCounted.h"
 #include <string>
+#include <vector>
 #include "qpid/messaging/Duration.h"
 
 namespace qpid {
@@ -42,6 +43,7 @@ class SessionImpl : public virtual qpid::RefCounted
     virtual void rollback() = 0;
     virtual void acknowledge(bool sync) = 0;
     virtual void acknowledge(Message&, bool cumulative) = 0;
+    virtual void acknowledge(std::vector<Message>& batch, uint32_t count) = 0;
     virtual void reject(Message&) = 0;
     virtual void release(Message&) = 0;
     virtual void close() = 0;
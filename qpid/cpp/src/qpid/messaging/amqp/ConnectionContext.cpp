@@ -266,6 +266,42 @@ bool ConnectionContext::fetch(boost::shared_ptr<SessionContext> ssn, boost::shar
     }
 }
 
+/**
+ * Batch form of fetch(): credit for the whole batch is issued up front
+ * when the receiver has no capacity of its own, the first message is
+ * waited for as in fetch(), and the remainder are then taken from the
+ * link under a single acquisition of the lock.
+ */
+uint32_t ConnectionContext::fetch(boost::shared_ptr<SessionContext> ssn, boost::shared_ptr<ReceiverContext> lnk, std::vector<qpid::messaging::Message>& batch, qpid::messaging::Duration timeout)
+{
+    if (batch.empty()) return 0;
+    qpid::sys::AtomicCount::ScopedIncrement track(lnk->fetching);
+    {
+        sys::Monitor::ScopedLock l(lock);
+        checkClosed(ssn, lnk);
+        if (!lnk->capacity) {
+            pn_link_flow(lnk->receiver, batch.size());
+            wakeupDriver();
+        }
+    }
+    uint32_t count = get(ssn, lnk, batch[0], timeout) ? 1 : 0;
+    sys::Monitor::ScopedLock l(lock);
+    checkClosed(ssn, lnk);
+    if (!count || !lnk->capacity) {
+        pn_link_drain(lnk->receiver, 0);
+        wakeupDriver();
+        while (pn_link_draining(lnk->receiver) && pn_link_credit(lnk->receiver) > pn_link_queued(lnk->receiver)) {
+            QPID_LOG(debug, "Waiting for messages or for credit to be drained: credit=" << pn_link_credit(lnk->receiver) << ", queued=" << pn_link_queued(lnk->receiver));
+            wait(ssn, lnk);
+        }
+        if (lnk->capacity && pn_link_queued(lnk->receiver) == 0) {
+            pn_link_flow(lnk->receiver, lnk->capacity);
+        }
+    }
+    while (count < batch.size() && getLH(ssn, lnk, batch[count], l)) ++count;
+    return count;
+}
+
 qpid::sys::AbsTime convert(qpid::messaging::Duration timeout)
 {
     qpid::sys::AbsTime until;
@@ -280,35 +316,21 @@ qpid::sys::AbsTime convert(qpid::messaging::Duration timeout)
 bool ConnectionContext::get(boost::shared_ptr<SessionContext> ssn, boost::shared_ptr<ReceiverContext> lnk, qpid::messaging::Message& message, qpid::messaging::Duration timeout)
 {
     qpid::sys::AbsTime until(convert(timeout));
+    qpid::sys::AbsTime start;
+    bool waited = false;
     while (true) {
         sys::Monitor::ScopedLock l(lock);
         checkClosed(ssn, lnk);
-        pn_delivery_t* current = pn_link_current((pn_link_t*) lnk->receiver);
-        QPID_LOG(debug, "In ConnectionContext::get(), current=" << current);
-        if (current && !pn_delivery_partial(current)) {
-            qpid::messaging::MessageImpl& impl = MessageImplAccess::get(message);
-            boost::shared_ptr<EncodedMessage> encoded(new EncodedMessage(pn_delivery_pending(current)));
-            encoded->setNestAnnotationsOption(nestAnnotations);
-            ssize_t read = pn_link_recv(lnk->receiver, encoded->getData(), encoded->getSize());
-            if (read < 0) throw qpid::messaging::MessagingException("Failed to read message");
-            encoded->trim((size_t) read);
-            QPID_LOG(debug, "Received message of " << encoded->getSize() << " bytes: ");
-            encoded->init(impl);
-            impl.setEncoded(encoded);
-            impl.setInternalId(ssn->record(current));
-            if (lnk->capacity) {
-                pn_link_flow(lnk->receiver, 1);
-                if (lnk->wakeupToIssueCredit()) {
-                    wakeupDriver();
-                } else {
-                    haveOutput = true;
-                }
+        if (getLH(ssn, lnk, message, l)) {
+            if (waited && lnk->adaptive.get()) {
+                lnk->adaptive->waited(qpid::sys::Duration(start, qpid::sys::now()));
             }
-            // Automatically ack messages if we are in a transaction.
-            if (ssn->transaction)
-                acknowledgeLH(ssn, &message, false, l);
             return true;
         } else if (until > qpid::sys::now()) {
+            if (!waited) {
+                start = qpid::sys::now();
+                waited = true;
+            }
             waitUntil(ssn, lnk, until);
         } else {
             return false;
@@ -317,6 +339,39 @@ bool ConnectionContext::get(boost::shared_ptr<SessionContext> ssn, boost::shared
     return false;
 }
 
+bool ConnectionContext::getLH(boost::shared_ptr<SessionContext> ssn, boost::shared_ptr<ReceiverContext> lnk, qpid::messaging::Message& message, sys::Monitor::ScopedLock& l)
+{
+    pn_delivery_t* current = pn_link_current((pn_link_t*) lnk->receiver);
+    QPID_LOG(debug, "In ConnectionContext::get(), current=" << current);
+    if (current && !pn_delivery_partial(current)) {
+        qpid::messaging::MessageImpl& impl = MessageImplAccess::get(message);
+        boost::shared_ptr<EncodedMessage> encoded(new EncodedMessage(pn_delivery_pending(current)));
+        encoded->setNestAnnotationsOption(nestAnnotations);
+        ssize_t read = pn_link_recv(lnk->receiver, encoded->getData(), encoded->getSize());
+        if (read < 0) throw qpid::messaging::MessagingException("Failed to read message");
+        encoded->trim((size_t) read);
+        QPID_LOG(debug, "Received message of " << encoded->getSize() << " bytes: ");
+        encoded->init(impl);
+        impl.setEncoded(encoded);
+        impl.setInternalId(ssn->record(current));
+        if (lnk->capacity) {
+            uint32_t credit = lnk->consumed();
+            if (credit) pn_link_flow(lnk->receiver, credit);
+            if (lnk->wakeupToIssueCredit()) {
+                wakeupDriver();
+            } else {
+                haveOutput = true;
+            }
+        }
+        // Automatically ack messages if we are in a transaction.
+        if (ssn->transaction)
+            acknowledgeLH(ssn, &message, false, l);
+        return true;
+    } else {
+        return false;
+    }
+}
+
 boost::shared_ptr<ReceiverContext> ConnectionContext::nextReceiver(boost::shared_ptr<SessionContext> ssn, qpid::messaging::Duration timeout)
 {
     qpid::sys::AbsTime until(convert(timeout));
@@ -339,6 +394,16 @@ void ConnectionContext::acknowledge(boost::shared_ptr<SessionContext> ssn, qpid:
     acknowledgeLH(ssn, message, cumulative, l);
 }
 
+void ConnectionContext::acknowledge(boost::shared_ptr<SessionContext> ssn, std::vector<qpid::messaging::Message>& batch, uint32_t count)
+{
+    sys::Monitor::ScopedLock l(lock);
+    checkClosed(ssn);
+    for (uint32_t i = 0; i < count; ++i) {
+        ssn->acknowledge(MessageImplAccess::get(batch[i]).getInternalId(), false);
+    }
+    wakeupDriver();
+}
+
 void ConnectionContext::acknowledgeLH(boost::shared_ptr<SessionContext> ssn, qpid::messaging::Message* message, bool cumulative, sys::Monitor::ScopedLock&)
 {
     checkClosed(ssn);
@@ -451,6 +516,9 @@ boost::shared_ptr<ReceiverContext> ConnectionContext::createReceiver(boost::shar
 {
     sys::Monitor::ScopedLock l(lock);
     boost::shared_ptr<ReceiverContext> receiver = session->createReceiver(address);
+    if (adaptiveCapacity) {
+        receiver->adaptive.reset(new AdaptiveCredit(adaptiveCapacityMin, adaptiveCapacityMax));
+    }
     try {
         attach(session, receiver);
         return receiver;
@@ -25,6 +25,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include "qpid/Url.h"
@@ -92,10 +93,12 @@ class ConnectionContext : public qpid::sys::ConnectionCodec, public qpid::messag
               SenderContext::Delivery** delivery);
 
     bool fetch(boost::shared_ptr<SessionContext> ssn, boost::shared_ptr<ReceiverContext> lnk, qpid::messaging::Message& message, qpid::messaging::Duration timeout);
+    uint32_t fetch(boost::shared_ptr<SessionContext> ssn, boost::shared_ptr<ReceiverContext> lnk, std::vector<qpid::messaging::Message>& batch, qpid::messaging::Duration timeout);
     bool get(boost::shared_ptr<SessionContext> ssn, boost::shared_ptr<ReceiverContext> lnk, qpid::messaging::Message& message, qpid::messaging::Duration timeout);
 
     // Session operations
     void acknowledge(boost::shared_ptr<SessionContext> ssn, qpid::messaging::Message* message, bool cumulative);
+    void acknowledge(boost::shared_ptr<SessionContext> ssn, std::vector<qpid::messaging::Message>& batch, uint32_t count);
     void commit(boost::shared_ptr<SessionContext> ssn);
     void rollback(boost::shared_ptr<SessionContext> ssn);
 
@@ -226,6 +229,7 @@ class ConnectionContext : public qpid::sys::ConnectionCodec, public qpid::messag
                 const qpid::messaging::Message& message, bool sync,
                 SenderContext::Delivery** delivery, sys::Monitor::ScopedLock&);
     void acknowledgeLH(boost::shared_ptr<SessionContext> ssn, qpid::messaging::Message* message, bool cumulative, sys::Monitor::ScopedLock&);
+    bool getLH(boost::shared_ptr<SessionContext> ssn, boost::shared_ptr<ReceiverContext> lnk, qpid::messaging::Message& message, sys::Monitor::ScopedLock&);
 };
 
 }}} // namespace qpid::messaging::amqp
@@ -36,7 +36,7 @@ ReceiverContext::ReceiverContext(pn_session_t* session, const std::string& n, co
     address(a),
     helper(address),
     receiver(pn_receiver(session, name.c_str())),
-    capacity(0), used(0) {}
+    capacity(0), used(0), deficit(0) {}
 
 ReceiverContext::~ReceiverContext()
 {
@@ -45,9 +45,11 @@ ReceiverContext::~ReceiverContext()
 
 void ReceiverContext::setCapacity(uint32_t c)
 {
+    if (c && adaptive.get()) c = adaptive->bound(c);
     if (c != capacity) {
         //stop
         capacity = c;
+        deficit = 0;
         //reissue credit
     }
 }
@@ -137,4 +139,28 @@ bool ReceiverContext::wakeupToIssueCredit()
     }
 }
 
+/**
+ * Returns the credit to issue on consumption of a message. This is
+ * normally one, keeping the window full, but differs while an
+ * adaptive window is being resized: growth is issued at once, while
+ * shrinkage is applied by withholding credit for subsequent messages.
+ */
+uint32_t ReceiverContext::consumed()
+{
+    int64_t credit = 1 - int64_t(deficit);
+    uint32_t window = capacity;
+    if (adaptive.get() && adaptive->consumed(window)) {
+        QPID_LOG(debug, "Adaptive capacity for " << name << " now " << window);
+        credit += int64_t(window) - int64_t(capacity);
+        capacity = window;
+    }
+    if (credit > 0) {
+        deficit = 0;
+        return uint32_t(credit);
+    } else {
+        deficit = uint32_t(-credit);
+        return 0;
+    }
+}
+
 }}} // namespace qpid::messaging::amqp
@@ -21,8 +21,10 @@
  * under the License.
  *
  */
+#include "qpid/messaging/AdaptiveCredit.h"
 #include "qpid/messaging/Address.h"
 #include "qpid/messaging/amqp/AddressHelper.h"
+#include <memory>
 #include <string>
 #include "qpid/sys/AtomicCount.h"
 #include "qpid/sys/IntegerTypes.h"
@@ -68,9 +70,12 @@ class ReceiverContext
     pn_link_t* receiver;
     uint32_t capacity;
     uint32_t used;
+    uint32_t deficit;
+    std::auto_ptr<AdaptiveCredit> adaptive;
     qpid::sys::AtomicCount fetching;
     void configure(pn_terminus_t*);
     bool wakeupToIssueCredit();
+    uint32_t consumed();
 };
 }}} // namespace qpid::messaging::amqp
 
@@ -62,6 +62,11 @@ qpid::messaging::Message ReceiverHandle::fetch(qpid::messaging::Duration timeout
     return result;
 }
 
+uint32_t ReceiverHandle::fetch(std::vector<qpid::messaging::Message>& batch, qpid::messaging::Duration timeout)
+{
+    return connection->fetch(session, receiver, batch, timeout);
+}
+
 void ReceiverHandle::setCapacity(uint32_t capacity)
 {
     connection->setCapacity(receiver, capacity);
@@ -45,6 +45,7 @@ class ReceiverHandle : public qpid::messaging::ReceiverImpl
     qpid::messaging::Message get(qpid::messaging::Duration timeout);
     bool fetch(Message& message, qpid::messaging::Duration timeout);
     qpid::messaging::Message fetch(qpid::messaging::Duration timeout);
+    uint32_t fetch(std::vector<Message>& batch, qpid::messaging::Duration timeout);
     void setCapacity(uint32_t);
     uint32_t getCapacity();
     uint32_t getAvailable();
@@ -60,6 +60,11 @@ void SessionHandle::acknowledge(qpid::messaging::Message& msg, bool cumulative)
     connection->acknowledge(session, &msg, cumulative);
 }
 
+void SessionHandle::acknowledge(std::vector<qpid::messaging::Message>& batch, uint32_t count)
+{
+    connection->acknowledge(session, batch, count);
+}
+
 void SessionHandle::reject(qpid::messaging::Message& msg)
 {
     connection->nack(session, msg, true);
@@ -41,6 +41,7 @@ class SessionHandle : public qpid::messaging::SessionImpl
     void rollback();
     void acknowledge(bool sync);
     void acknowledge(Message&, bool);
+    void acknowledge(std::vector<Message>&, uint32_t);
     void reject(Message&);
     void release(Message&);
     void close();
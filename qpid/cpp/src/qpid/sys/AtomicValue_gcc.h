@@ -62,6 +62,9 @@ class AtomicValue
 
     T get() const { return const_cast<AtomicValue<T>*>(this)->fetchAndAdd(static_cast<T>(0)); }
 
+    /** Plain read with no barrier, may be stale. Only use as a hint before an atomic op. */
+    T peek() const { return *const_cast<const volatile T*>(&value); }
+
   private:
     T value;
 };
@@ -71,6 +71,9 @@ class AtomicValue
     }
 
     T get() const { Lock l(lock); return value; }
+
+    /** As get(), there is no cheaper read here. */
+    T peek() const { return get(); }
         
   private:
     typedef Mutex::ScopedLock Lock;
@@ -53,9 +53,12 @@ public:
     /** Bind to a port and start listening.
      *@param port 0 means choose an available port.
      *@param backlog maximum number of pending connections.
+     *@param sharePort allow other sockets that also set sharePort to
+     * listen on the same port; the kernel spreads incoming connections
+     * across them.
      *@return The bound port.
      */
-    virtual int listen(const SocketAddress&, int backlog = 10) const = 0;
+    virtual int listen(const SocketAddress&, int backlog = 10, bool sharePort = false) const = 0;
 
     /**
      * Returns an address (host and port) for the remote end of the
@@ -131,7 +131,8 @@ void SocketAcceptor::addListener(Socket* socket)
     listeners.push_back(socket);
 }
 
-uint16_t SocketAcceptor::listen(const std::vector<std::string>& interfaces, uint16_t port, int backlog, const SocketFactory& factory)
+uint16_t SocketAcceptor::listen(const std::vector<std::string>& interfaces, uint16_t port, int backlog, const SocketFactory& factory,
+                                unsigned sockets)
 {
     std::vector<std::string> addresses = expandInterfaces(interfaces);
     std::string sport(boost::lexical_cast<std::string>(port));
@@ -158,11 +159,21 @@ uint16_t SocketAcceptor::listen(const std::vector<std::string>& interfaces, uint
 
             QPID_LOG(info, "Listening to: " << sa.asString());
             std::auto_ptr<Socket> s(factory());
-            uint16_t lport = s->listen(sa, backlog);
+            uint16_t lport = s->listen(sa, backlog, sockets > 1);
             QPID_LOG(debug, "Listened to: " << lport);
             addListener(s.release());
-
             if (listeningPort==0) listeningPort = lport;
+
+            // Further sockets sharing the (possibly chosen) port, each of
+            // which can be accepting in a different IO thread.
+            if (sockets > 1) {
+                SocketAddress shareAddress(addresses[i], boost::lexical_cast<std::string>(lport));
+                for (unsigned j = 1; j < sockets; ++j) {
+                    std::auto_ptr<Socket> shared(factory());
+                    shared->listen(port ? sa : shareAddress, backlog, true);
+                    addListener(shared.release());
+                }
+            }
         } catch (std::exception& e) {
             QPID_LOG(warning, "Couldn't listen to: " << sa.asString() << ": " << e.what());
         }
@@ -62,8 +62,10 @@ public:
     SocketAcceptor(bool tcpNoDelay, bool nodict, uint32_t maxNegotiateTime, Timer& timer);
     SocketAcceptor(bool tcpNoDelay, bool nodict, uint32_t maxNegotiateTime, Timer& timer, const EstablishedCallback& established);
 
-    // Create sockets from list of interfaces and listen to them
-    uint16_t listen(const std::vector<std::string>& interfaces, uint16_t port, int backlog, const SocketFactory& factory);
+    // Create sockets from list of interfaces and listen to them, with
+    // sockets sharing each port (if more than one) to accept in parallel
+    uint16_t listen(const std::vector<std::string>& interfaces, uint16_t port, int backlog, const SocketFactory& factory,
+                    unsigned sockets = 1);
 
     // Import sockets that are already being listened to
     void addListener(Socket* socket);
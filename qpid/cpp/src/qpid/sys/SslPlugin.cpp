@@ -123,7 +123,8 @@ static struct SslPlugin : public Plugin {
                     port = sa->listen(broker->getListenInterfaces(), options.port, broker->getConnectionBacklog(),
                                         multiplex ?
                                             boost::bind(&createServerSSLMuxSocket, options) :
-                                            boost::bind(&createServerSSLSocket, options));
+                                            boost::bind(&createServerSSLSocket, options),
+                                        broker->getAcceptSockets());
                 if ( port!=0 ) {
                     ta.reset(sa);
                     QPID_LOG(notice, "Listening for " <<
@@ -45,7 +45,8 @@ static class TCPIOPlugin : public Plugin {
             if (broker->shouldListen("tcp")) {
                 SocketAcceptor* aa = new SocketAcceptor(broker->getTcpNoDelay(), false, broker->getMaxNegotiateTime(), broker->getTimer());
                 ta.reset(aa);
-                port = aa->listen(broker->getListenInterfaces(), port, broker->getConnectionBacklog(), &createSocket);
+                port = aa->listen(broker->getListenInterfaces(), port, broker->getConnectionBacklog(), &createSocket,
+                                  broker->getAcceptSockets());
                 if ( port!=0 ) {
                     QPID_LOG(notice, "Listening on TCP/TCP6 port " << port);
                 }
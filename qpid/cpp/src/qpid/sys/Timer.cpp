@@ -22,7 +22,8 @@
 #include "qpid/sys/Mutex.h"
 #include "qpid/log/Statement.h"
 
-#include <numeric>
+#include <algorithm>
+#include <limits>
 
 using boost::intrusive_ptr;
 using std::max;
@@ -30,12 +31,27 @@ using std::max;
 namespace qpid {
 namespace sys {
 
+namespace {
+// Index of the lowest set bit, bits must not be 0.
+inline uint64_t lowestBit(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    uint64_t n = 0;
+    while (!(bits & 1)) { bits >>= 1; ++n; }
+    return n;
+#endif
+}
+}
+
 TimerTask::TimerTask(Duration timeout, const std::string&  n) :
     name(n),
     sortTime(AbsTime::FarFuture()),
     period(timeout),
     nextFireTime(AbsTime::now(), timeout),
-    state(WAITING)
+    state(WAITING),
+    timer(0), level(0), slot(0), index(0)
 {}
 
 TimerTask::TimerTask(AbsTime time, const std::string&  n) :
@@ -43,7 +59,8 @@ TimerTask::TimerTask(AbsTime time, const std::string&  n) :
     sortTime(AbsTime::FarFuture()),
     period(0),
     nextFireTime(time),
-    state(WAITING)
+    state(WAITING),
+    timer(0), level(0), slot(0), index(0)
 {}
 
 TimerTask::~TimerTask() {}
@@ -52,6 +69,11 @@ bool TimerTask::readyToFire() const {
     return !(nextFireTime > AbsTime::now());
 }
 
+bool TimerTask::isCancelled() {
+    Monitor::ScopedLock l(stateMonitor);
+    return state == CANCELLED;
+}
+
 bool TimerTask::prepareToFire() {
     Monitor::ScopedLock l(stateMonitor);
     if (state != CANCELLED) {
@@ -89,27 +111,51 @@ void TimerTask::restart() {
 }
 
 void TimerTask::cancel() {
-    Monitor::ScopedLock l(stateMonitor);
-    while (state == CALLING) {
-        stateMonitor.wait();
+    Timer* t;
+    {
+        Monitor::ScopedLock l(stateMonitor);
+        while (state == CALLING) {
+            stateMonitor.wait();
+        }
+        state = CANCELLED;
+        // The Timer's lock is taken before ours, so it can't be taken
+        // here. Pin the Timer instead so it isn't destroyed before the
+        // task is unlinked: it unlinks all tasks before waiting for pins.
+        t = timer;
+        if (t) ++t->pins;
     }
-    state = CANCELLED;
+    if (t) t->unlink(*this);
 }
 
 // TODO AStitcher 21/08/09 The threshholds for emitting warnings are a little arbitrary
 Timer::Timer() :
+    base(AbsTime::now()),
+    currentTick(0),
+    waitingFor(0),
     active(false),
     late(50 * TIME_MSEC),
     overran(2 * TIME_MSEC),
     lateCancel(500 * TIME_MSEC),
     warn(60 * TIME_SEC)
 {
+    for (int level = 0; level < LEVELS; ++level) {
+        wheelSize[level] = 0;
+        for (uint64_t word = 0; word < WORDS; ++word) occupied[level][word] = 0;
+    }
     start();
 }
 
 Timer::~Timer()
 {
     stop();
+    Monitor::ScopedLock l(monitor);
+    for (int level = 0; level < LEVELS; ++level) {
+        for (uint64_t slot = 0; slot < SLOTS; ++slot) {
+            Slot tasks;
+            take(tasks, level, slot);
+        }
+    }
+    while (pins.get()) monitor.wait();
 }
 
 class TimerTaskCallbackScope {
@@ -132,58 +178,71 @@ void Timer::run()
 {
     Monitor::ScopedLock l(monitor);
     while (active) {
-        if (tasks.empty()) {
+        uint64_t next;
+        if (!nextTick(next)) {
+            waitingFor = std::numeric_limits<uint64_t>::max();
             monitor.wait();
+        } else if (timeOf(next) > AbsTime::now()) {
+            waitingFor = next;
+            monitor.wait(timeOf(next));
         } else {
-            intrusive_ptr<TimerTask> t = tasks.top();
-            tasks.pop();
-            assert(!(t->nextFireTime < t->sortTime));
+            // Nothing is due on the ticks in between, so skip straight to next
+            if (next > currentTick) {
+                currentTick = next - 1;
+                advance();
+            }
+            Slot due;
+            take(due, 0, currentTick & SLOT_MASK);
+            std::stable_sort(due.begin(), due.end(), &Timer::earlier);
+            // Move on before firing so tasks added meanwhile land in a later slot
+            advance();
+            fireDue(due);
+        }
+        waitingFor = 0;
+    }
+}
+
+// Requires monitor to be held, releases it around each callback.
+void Timer::fireDue(Slot& due)
+{
+    for (Slot::iterator i = due.begin(); i != due.end() && active; ++i) {
+        intrusive_ptr<TimerTask> t = *i;
 
-            // warn on extreme lateness
-            AbsTime start(AbsTime::now());
-            Duration delay(t->sortTime, start);
+        // warn on extreme lateness
+        AbsTime start(AbsTime::now());
+        Duration delay(t->sortTime, start);
+        TimerTaskCallbackScope s(*t);
+        if (s) {
+            if (delay > lateCancel) {
+                QPID_LOG(debug, t->name << " cancelled timer woken up " <<
+                         delay / TIME_MSEC << "ms late");
+            }
+        } else if (Duration(t->nextFireTime, start) >= 0) {
             {
-            TimerTaskCallbackScope s(*t);
-            if (s) {
-                if (delay > lateCancel) {
-                    QPID_LOG(debug, t->name << " cancelled timer woken up " <<
-                             delay / TIME_MSEC << "ms late");
-                }
-                continue;
-            } else if(Duration(t->nextFireTime, start) >= 0) {
-                {
-                    Monitor::ScopedUnlock u(monitor);
-                    fire(t);
-                }
-                // Warn if callback overran next timer's start.
-                AbsTime end(AbsTime::now());
-                Duration overrun (0);
-                if (!tasks.empty()) {
-                    overrun = Duration(tasks.top()->nextFireTime, end);
-                }
-                bool warningsEnabled;                  // TimerWarning enabled
-                QPID_LOG_TEST(debug, warningsEnabled); // TimerWarning emitted at debug level
-                if (warningsEnabled) {
-                    if (overrun > overran) {
-                        if (delay > overran) // if delay is significant to an overrun.
-                            warn.lateAndOverran(t->name, delay, overrun, Duration(start, end));
-                        else
-                            warn.overran(t->name, overrun, Duration(start, end));
-                    }
-                    else if (delay > late)
-                        warn.late(t->name, delay);
-                }
-                continue;
-            } else {
-                // If the timer was adjusted into the future it might no longer
-                // be the next event, so push and then get top to make sure
-                // You can only push events into the future
-                t->sortTime = t->nextFireTime;
-                tasks.push(t);
+                Monitor::ScopedUnlock u(monitor);
+                fire(t);
+            }
+            // Warn if callback overran the next task due in this slot.
+            AbsTime end(AbsTime::now());
+            Duration overrun (0);
+            if (i + 1 != due.end()) {
+                overrun = Duration((*(i + 1))->nextFireTime, end);
             }
+            bool warningsEnabled;                  // TimerWarning enabled
+            QPID_LOG_TEST(debug, warningsEnabled); // TimerWarning emitted at debug level
+            if (warningsEnabled) {
+                if (overrun > overran) {
+                    if (delay > overran) // if delay is significant to an overrun.
+                        warn.lateAndOverran(t->name, delay, overrun, Duration(start, end));
+                    else
+                        warn.overran(t->name, overrun, Duration(start, end));
+                }
+                else if (delay > late)
+                    warn.late(t->name, delay);
             }
-            assert(!tasks.empty());
-            monitor.wait(tasks.top()->sortTime);
+        } else {
+            // The task was restarted into the future, file it under its new time
+            insert(t);
         }
     }
 }
@@ -191,9 +250,154 @@ void Timer::run()
 void Timer::add(intrusive_ptr<TimerTask> task)
 {
     Monitor::ScopedLock l(monitor);
+    // Only wake the runner if it is waiting for a later tick
+    if (insert(task) < waitingFor) monitor.notify();
+}
+
+// The tick at or after time, so a task is never fired early.
+uint64_t Timer::tickFor(const AbsTime& time) const
+{
+    int64_t offset = Duration(base, time);
+    return offset > 0 ? (offset + TICK - 1) / TICK : 0;
+}
+
+AbsTime Timer::timeOf(uint64_t tick) const
+{
+    return AbsTime(base, Duration(tick * TICK));
+}
+
+// Requires monitor to be held. Returns the tick the task will next be
+// looked at.
+uint64_t Timer::insert(intrusive_ptr<TimerTask> task)
+{
+    {
+        Monitor::ScopedLock l(task->stateMonitor);
+        task->timer = this;
+    }
     task->sortTime = task->nextFireTime;
-    tasks.push(task);
-    monitor.notify();
+    uint64_t tick = std::max(tickFor(task->nextFireTime), currentTick);
+    uint64_t delta = tick - currentTick;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >> (SLOT_BITS * (level + 1))) ++level;
+    if (delta >> (SLOT_BITS * LEVELS)) {
+        // Beyond the last wheel: park it in the furthest slot, it will be
+        // cascaded and filed again when that slot is reached.
+        tick = currentTick + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    }
+    uint64_t slot = (tick >> (SLOT_BITS * level)) & SLOT_MASK;
+    Slot& tasks = wheels[level][slot];
+    if (tasks.empty()) occupied[level][slot / 64] |= uint64_t(1) << (slot % 64);
+    task->level = level;
+    task->slot = slot;
+    task->index = tasks.size();
+    tasks.push_back(task);
+    ++wheelSize[level];
+    return level ? (tick >> (SLOT_BITS * level)) << (SLOT_BITS * level) : tick;
+}
+
+// Move on to the next tick, cascading the coarser wheels down whenever
+// the finer one below them wraps.
+void Timer::advance()
+{
+    ++currentTick;
+    for (int level = 1; level < LEVELS; ++level) {
+        if (currentTick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) break;
+        cascade(level);
+    }
+}
+
+bool Timer::earlier(const intrusive_ptr<TimerTask>& a, const intrusive_ptr<TimerTask>& b)
+{
+    return a->sortTime < b->sortTime;
+}
+
+// Requires monitor to be held. Empty a slot, leaving its tasks unlinked.
+void Timer::take(Slot& tasks, int level, uint64_t slot)
+{
+    tasks.swap(wheels[level][slot]);
+    wheelSize[level] -= tasks.size();
+    occupied[level][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    for (Slot::iterator i = tasks.begin(); i != tasks.end(); ++i) {
+        Monitor::ScopedLock l((*i)->stateMonitor);
+        (*i)->timer = 0;
+    }
+}
+
+// Remove a cancelled task from its slot, called with the Timer pinned.
+void Timer::unlink(TimerTask& task)
+{
+    Monitor::ScopedLock l(monitor);
+    {
+        // Keep the task alive until its lock is released, the slot
+        // may hold the last reference to it.
+        intrusive_ptr<TimerTask> keep(&task);
+        Monitor::ScopedLock sl(task.stateMonitor);
+        // The task may have been taken to fire or filed again since
+        // it was pinned, so check where it is now.
+        if (task.timer == this) {
+            Slot& tasks = wheels[task.level][task.slot];
+            if (task.index != tasks.size() - 1) {
+                tasks[task.index].swap(tasks.back());
+                tasks[task.index]->index = task.index;
+            }
+            tasks.pop_back();
+            --wheelSize[task.level];
+            if (tasks.empty())
+                occupied[task.level][task.slot / 64] &= ~(uint64_t(1) << (task.slot % 64));
+            task.timer = 0;
+        }
+    }
+    if (--pins == 0 && !active) monitor.notifyAll();
+}
+
+void Timer::cascade(int level)
+{
+    Slot tasks;
+    take(tasks, level, (currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    for (Slot::iterator i = tasks.begin(); i != tasks.end(); ++i) {
+        if (!(*i)->isCancelled()) insert(*i);
+    }
+}
+
+// Find the earliest tick that has tasks to fire or cascade. A coarser
+// wheel may need cascading before the next task in the finest one is due,
+// so every level must be checked.
+bool Timer::nextTick(uint64_t& tick) const
+{
+    bool found = false;
+    if (wheelSize[0]) {
+        tick = currentTick + firstOccupied(0, currentTick);
+        found = true;
+    }
+    for (int level = 1; level < LEVELS; ++level) {
+        if (!wheelSize[level]) continue;
+        int shift = SLOT_BITS * level;
+        // The current slot of a coarser wheel has already been cascaded,
+        // anything filed there is a whole revolution away.
+        uint64_t first = (currentTick >> shift) + 1;
+        uint64_t slot = first + firstOccupied(level, first);
+        if (!found || slot << shift < tick) tick = slot << shift;
+        found = true;
+    }
+    return found;
+}
+
+// Distance from start, wrapping round, to the first occupied slot of a
+// wheel, or SLOTS if the wheel is empty.
+uint64_t Timer::firstOccupied(int level, uint64_t start) const
+{
+    start &= SLOT_MASK;
+    uint64_t bit = start % 64;
+    // Look at the word holding start twice: first from start up, last
+    // (after wrapping round) below start.
+    for (uint64_t i = 0; i <= WORDS; ++i) {
+        uint64_t word = (start / 64 + i) % WORDS;
+        uint64_t bits = occupied[level][word];
+        if (i == 0) bits &= ~uint64_t(0) << bit;
+        else if (i == WORDS) bits &= (uint64_t(1) << bit) - 1;
+        if (bits) return (word * 64 + lowestBit(bits) - start) & SLOT_MASK;
+    }
+    return SLOTS;
 }
 
 void Timer::start()
@@ -225,11 +429,4 @@ void Timer::fire(boost::intrusive_ptr<TimerTask> t) {
     }
 }
 
-bool operator<(const intrusive_ptr<TimerTask>& a,
-                       const intrusive_ptr<TimerTask>& b)
-{
-    // Lower priority if time is later
-    return a.get() && b.get() && a->sortTime > b->sortTime;
-}
-
 }}
@@ -26,10 +26,11 @@
 #include "qpid/sys/Mutex.h"
 #include "qpid/sys/Thread.h"
 #include "qpid/sys/Runnable.h"
+#include "qpid/sys/AtomicValue.h"
 #include "qpid/RefCounted.h"
 #include "qpid/CommonImportExport.h"
 #include <memory>
-#include <queue>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 
@@ -41,8 +42,6 @@ class Timer;
 class TimerTask : public RefCounted {
   friend class Timer;
   friend class TimerTaskCallbackScope;
-  friend bool operator<(const boost::intrusive_ptr<TimerTask>&,
-                        const boost::intrusive_ptr<TimerTask>&);
 
     std::string name;
     AbsTime sortTime;
@@ -51,9 +50,18 @@ class TimerTask : public RefCounted {
     qpid::sys::Monitor stateMonitor;
     enum {WAITING, CALLING, CANCELLED} state;
 
+    // Where the task is filed in its Timer's wheels, timer is 0 when it
+    // is in none. timer is changed with both the Timer's lock and
+    // stateMonitor held, the others are protected by the Timer's lock.
+    Timer* timer;
+    int level;
+    uint64_t slot;
+    size_t index;
+
     bool prepareToFire();
     void finishFiring();
     bool readyToFire() const;
+    bool isCancelled();
     void fireTask();
 
   public:
@@ -99,7 +107,8 @@ class TimerTask : public RefCounted {
      * After cancelling the only thing you can do nothing further
      * with a TimerTask.
      *
-     * The Timer will delete the cancelled TimerTask.
+     * The task is removed from its Timer at once, so the Timer
+     * drops its reference to it.
      */
     QPID_COMMON_EXTERN void cancel();
 
@@ -110,19 +119,56 @@ class TimerTask : public RefCounted {
     virtual void fire() = 0;
 };
 
-// For the priority_queue order
-bool operator<(const boost::intrusive_ptr<TimerTask>& a,
-               const boost::intrusive_ptr<TimerTask>& b);
-
+/**
+ * Runs TimerTasks on a single thread.
+ *
+ * Tasks are kept in a hierarchical timing wheel: LEVELS wheels of
+ * SLOTS slots each, the finest with one slot per TICK and each
+ * coarser wheel spanning a whole revolution of the one below. Adding
+ * a task and moving it on when it has been restart()ed are O(1);
+ * tasks in a coarse wheel cascade down as the finer wheel wraps.
+ * Each wheel keeps a bitmap of its occupied slots so the next due tick
+ * is found without visiting empty ones. TimerTask::cancel() removes
+ * the task from its slot. Tasks due in the same tick fire in order of
+ * their due time.
+ */
 class Timer : private Runnable {
+  friend class TimerTask;
+    typedef std::vector<boost::intrusive_ptr<TimerTask> > Slot;
+
+    static const int SLOT_BITS = 8;
+    static const int LEVELS = 4;
+    static const uint64_t SLOTS = 1 << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+    static const int64_t TICK = 1000 * 1000;   // One millisecond, in nanoseconds
+    static const uint64_t WORDS = SLOTS / 64;  // Words in a wheel's bitmap
+
     qpid::sys::Monitor monitor;
-    std::priority_queue<boost::intrusive_ptr<TimerTask> > tasks;
+    Slot wheels[LEVELS][SLOTS];
+    size_t wheelSize[LEVELS];
+    uint64_t occupied[LEVELS][WORDS];   // Bit set for each non-empty slot
+    AtomicValue<uint32_t> pins; // Cancels in progress, see TimerTask::cancel()
+    AbsTime base;           // Time of tick 0
+    uint64_t currentTick;   // Next tick to be processed
+    uint64_t waitingFor;    // Tick the runner is waiting for, 0 if not waiting
     qpid::sys::Thread runner;
     bool active;
 
     // Runnable interface
     void run();
 
+    uint64_t tickFor(const AbsTime&) const;
+    AbsTime timeOf(uint64_t tick) const;
+    uint64_t insert(boost::intrusive_ptr<TimerTask>);
+    void take(Slot& tasks, int level, uint64_t slot);
+    void unlink(TimerTask&);
+    uint64_t firstOccupied(int level, uint64_t start) const;
+    static bool earlier(const boost::intrusive_ptr<TimerTask>&, const boost::intrusive_ptr<TimerTask>&);
+    void advance();
+    void cascade(int level);
+    bool nextTick(uint64_t& tick) const;
+    void fireDue(Slot& due);
+
   public:
     QPID_COMMON_EXTERN Timer();
     QPID_COMMON_EXTERN virtual ~Timer();
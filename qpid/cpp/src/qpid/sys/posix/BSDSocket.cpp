@@ -188,13 +188,20 @@ BSDSocket::close() const
     *handle = IOHandle();
 }
 
-int BSDSocket::listen(const SocketAddress& sa, int backlog) const
+int BSDSocket::listen(const SocketAddress& sa, int backlog, bool sharePort) const
 {
     createSocket(sa);
 
     const int& socket = fd;
     int yes=1;
     QPID_POSIX_CHECK(::setsockopt(socket,SOL_SOCKET,SO_REUSEADDR,&yes,sizeof(yes)));
+    if (sharePort) {
+#ifdef SO_REUSEPORT
+        QPID_POSIX_CHECK(::setsockopt(socket,SOL_SOCKET,SO_REUSEPORT,&yes,sizeof(yes)));
+#else
+        throw Exception(QPID_MSG("Can't share port of " << sa.asString() << ": not supported"));
+#endif
+    }
 
     if (::bind(socket, getAddrInfo(sa).ai_addr, getAddrInfo(sa).ai_addrlen) < 0)
         throw Exception(QPID_MSG("Can't bind to port " << sa.asString() << ": " << strError(errno)));
@@ -64,7 +64,7 @@ public:
 
     QPID_COMMON_EXTERN virtual void connect(const SocketAddress&) const;
     QPID_COMMON_EXTERN virtual void finishConnect(const SocketAddress&) const;
-    QPID_COMMON_EXTERN virtual int listen(const SocketAddress&, int backlog = 10) const;
+    QPID_COMMON_EXTERN virtual int listen(const SocketAddress&, int backlog = 10, bool sharePort = false) const;
     QPID_COMMON_EXTERN virtual Socket* accept() const;
     QPID_COMMON_EXTERN virtual int read(void *buf, size_t count) const;
     QPID_COMMON_EXTERN virtual int write(const void *buf, size_t count) const;
@@ -44,6 +44,7 @@
 #include <nss.h>
 #include <pk11pub.h>
 #include <ssl.h>
+#include <sslproto.h>
 #include <key.h>
 #include <sslerr.h>
 
@@ -56,6 +57,7 @@ const std::string DOMAIN_SEPARATOR("@");
 const std::string DC_SEPARATOR(".");
 const std::string DC("DC");
 const std::string DN_DELIMS(" ,=");
+const std::string SPACE(" ");
 
 std::string getDomainFromSubject(std::string subject)
 {
@@ -130,6 +132,29 @@ SslSocket::SslSocket(const std::string& certName, bool clientAuth) :
     }
 }
 
+namespace {
+/**
+ * NSS records when a cached session expires but the server resumes it
+ * from the session ID cache regardless, so renegotiate a handshake that
+ * resumed an expired session: that removes it from the cache and gives
+ * the connection a new one. TLS 1.3 sessions are only resumed with
+ * tickets, whose lifetime NSS fixes, and can't be renegotiated.
+ */
+void expireResumedSession(PRFileDesc* fd, void* /*arg*/)
+{
+    SSLChannelInfo info;
+    if (SSL_GetChannelInfo(fd, &info, sizeof(info)) == SECSuccess && info.resumed &&
+        info.protocolVersion < SSL_LIBRARY_VERSION_TLS_1_3 &&
+        PRUint32(PR_Now() / PR_USEC_PER_SEC) >= info.expirationTime)
+    {
+        QPID_LOG(debug, "Renegotiating expired TLS session");
+        if (SSL_ReHandshake(fd, PR_TRUE) != SECSuccess) {
+            QPID_LOG(warning, "Failed to renegotiate expired TLS session: " << getErrorString(PR_GetError()));
+        }
+    }
+}
+}
+
 /**
  * This form of the constructor is used with the server-side sockets
  * returned from accept. Because we use posix accept rather than
@@ -139,6 +164,7 @@ SslSocket::SslSocket(int fd, PRFileDesc* model) : BSDSocket(fd), nssSocket(0), p
 {
     nssSocket = SSL_ImportFD(model, PR_ImportTCPSocket(fd));
     NSS_CHECK(SSL_ResetHandshake(nssSocket, PR_TRUE));
+    NSS_CHECK(SSL_HandshakeCallback(nssSocket, expireResumedSession, 0));
 }
 
 void SslSocket::ignoreHostnameVerificationFailure()
@@ -202,6 +228,13 @@ void SslSocket::finishConnect(const SocketAddress& addr) const
     }
     NSS_CHECK(SSL_GetClientAuthDataHook(nssSocket, NSS_GetClientAuthData, arg));
 
+    // NSS offers a cached session to resume when one matches the peer
+    // ID, so include the client certificate: a session must not be
+    // resumed under a different identity.
+    std::string peerId(addr.asString());
+    if (arg) peerId += SPACE + static_cast<const char*>(arg);
+    NSS_CHECK(SSL_SetSockPeerID(nssSocket, peerId.c_str()));
+
     url = addr.getHost();
     if (!hostnameVerification) {
         NSS_CHECK(SSL_BadCertHook(nssSocket, bad_certificate, const_cast<char*>(url.data())));
@@ -210,6 +243,11 @@ void SslSocket::finishConnect(const SocketAddress& addr) const
 
     NSS_CHECK(SSL_ResetHandshake(nssSocket, PR_FALSE));
     NSS_CHECK(SSL_ForceHandshake(nssSocket));
+
+    SSLChannelInfo info;
+    if (SSL_GetChannelInfo(nssSocket, &info, sizeof(info)) == SECSuccess && info.resumed) {
+        QPID_LOG(debug, "Resumed TLS session with " << peerId);
+    }
 }
 
 void SslSocket::close() const
@@ -224,7 +262,7 @@ void SslSocket::close() const
     }
 }
 
-int SslSocket::listen(const SocketAddress& sa, int backlog) const
+int SslSocket::listen(const SocketAddress& sa, int backlog, bool sharePort) const
 {
     //get certificate and key (is this the correct way?)
     std::string cName( (certname == "") ? "localhost.localdomain" : certname);
@@ -236,7 +274,7 @@ int SslSocket::listen(const SocketAddress& sa, int backlog) const
     SECKEY_DestroyPrivateKey(key);
     CERT_DestroyCertificate(cert);
 
-    return BSDSocket::listen(sa, backlog);
+    return BSDSocket::listen(sa, backlog, sharePort);
 }
 
 Socket* SslSocket::accept() const
@@ -60,7 +60,7 @@ public:
 
     void connect(const SocketAddress&) const;
     void finishConnect(const SocketAddress&) const;
-    int listen(const SocketAddress&, int backlog = 10) const;
+    int listen(const SocketAddress&, int backlog = 10, bool sharePort = false) const;
     virtual Socket* accept() const;
     int read(void *buf, size_t count) const;
     int write(const void *buf, size_t count) const;
@@ -50,13 +50,22 @@ std::string defaultCertName()
 
 SslOptions::SslOptions() : qpid::Options("SSL Settings"), 
                            certName(defaultCertName()),
-                           exportPolicy(false)
+                           exportPolicy(false),
+                           sessionCacheSize(0),
+                           sessionTimeout(0),
+                           sessionTickets(true)
 {
     addOptions()
         ("ssl-use-export-policy", optValue(exportPolicy), "Use NSS export policy")
         ("ssl-cert-password-file", optValue(certPasswordFile, "PATH"), "File containing password to use for accessing certificate database")
         ("ssl-cert-db", optValue(certDbPath, "PATH"), "Path to directory containing certificate database")
-        ("ssl-cert-name", optValue(certName, "NAME"), "Name of the certificate to use");
+        ("ssl-cert-name", optValue(certName, "NAME"), "Name of the certificate to use")
+        ("ssl-session-cache-size", optValue(sessionCacheSize, "N"),
+         "Number of TLS sessions a server keeps for resumption by reconnecting clients (0 for the NSS default)")
+        ("ssl-session-timeout", optValue(sessionTimeout, "SECONDS"),
+         "Time for which a server resumes a TLS session from its session ID cache (0 for the NSS default). Sessions resumed with session tickets, as all TLS 1.3 sessions are, are not limited")
+        ("ssl-session-tickets", optValue(sessionTickets, "yes|no"),
+         "Resume TLS sessions with session tickets as well as session IDs (a broker without tickets cannot resume TLS 1.3 sessions)");
 }
 
 SslOptions& SslOptions::operator=(const SslOptions& o) 
@@ -65,6 +74,9 @@ SslOptions& SslOptions::operator=(const SslOptions& o)
     certName = o.certName;
     certPasswordFile = o.certPasswordFile;
     exportPolicy = o.exportPolicy;
+    sessionCacheSize = o.sessionCacheSize;
+    sessionTimeout = o.sessionTimeout;
+    sessionTickets = o.sessionTickets;
     return *this;
 }
 
@@ -104,9 +116,11 @@ void initNSS(const SslOptions& options, bool server)
         NSS_CHECK(NSS_SetDomesticPolicy());
     }
     if (server) {
-        //use defaults for all args, TODO: may want to make this configurable
-        SSL_ConfigServerSessionIDCache(0, 0, 0, 0);
+        // Cache sessions so reconnecting clients can skip the full handshake.
+        // Zero cache size or timeout selects the NSS default.
+        NSS_CHECK(SSL_ConfigServerSessionIDCache(options.sessionCacheSize, 0, options.sessionTimeout, 0));
     }
+    NSS_CHECK(SSL_OptionSetDefault(SSL_ENABLE_SESSION_TICKETS, options.sessionTickets ? PR_TRUE : PR_FALSE));
 
     // disable SSLv2 and SSLv3 versions of the protocol - they are
     // no longer considered secure
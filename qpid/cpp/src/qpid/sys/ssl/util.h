@@ -23,6 +23,7 @@
  */
 
 #include "qpid/Options.h"
+#include "qpid/sys/IntegerTypes.h"
 #include <string>
 
 namespace qpid {
@@ -37,6 +38,9 @@ struct SslOptions : qpid::Options
     std::string certName;
     std::string certPasswordFile;
     bool exportPolicy;
+    uint32_t sessionCacheSize;
+    uint32_t sessionTimeout;
+    bool sessionTickets;
 
     SslOptions();
     SslOptions& operator=(const SslOptions&);
@@ -197,8 +197,10 @@ int WinSocket::read(void *buf, size_t count) const
     return received;
 }
 
-int WinSocket::listen(const SocketAddress& addr, int backlog) const
+int WinSocket::listen(const SocketAddress& addr, int backlog, bool sharePort) const
 {
+    if (sharePort)
+        throw Exception(QPID_MSG("Can't share port of " << addr.asString() << ": not supported"));
     createSocket(addr);
 
     const SOCKET& socket = handle->fd;
@@ -68,7 +68,7 @@ public:
     /** Bind to a port and start listening.
      *@return The bound port number
      */
-    QPID_COMMON_EXTERN virtual int listen(const SocketAddress&, int backlog = 10) const;
+    QPID_COMMON_EXTERN virtual int listen(const SocketAddress&, int backlog = 10, bool sharePort = false) const;
 
     /**
      * Returns an address (host and port) for the remote end of the
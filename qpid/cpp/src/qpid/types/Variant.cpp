@@ -56,6 +56,7 @@ class VariantImpl
     void set(float);
     void set(double);
     void set(const std::string&, const std::string& encoding=std::string());
+    void set(const char*);
     void set(const Variant::Map&);
     void set(const Variant::List&);
     void set(const Uuid&);
@@ -95,7 +96,16 @@ class VariantImpl
     Variant::List descriptors;         // Optional descriptors for described value.
 
   private:
+    template <size_t A, size_t B> struct Max { static const size_t value = A > B ? A : B; };
+    static const size_t STORAGE_SIZE =
+        Max<Max<sizeof(std::string), sizeof(Variant::Map)>::value,
+            Max<sizeof(Variant::List), sizeof(Uuid)>::value>::value;
+
     VariantType type;
+    // Strings, maps, lists and uuids are constructed in place in
+    // value.storage rather than separately allocated, so a short
+    // string or an empty container costs no allocation beyond the
+    // VariantImpl itself.
     union {
         bool b;
         uint8_t ui8;
@@ -108,16 +118,22 @@ class VariantImpl
         int64_t i64;
         float f;
         double d;
-        Uuid* uuid;
-        Variant::Map* map;
-        Variant::List* list;
-        std::string* string;
+        char storage[STORAGE_SIZE];
     } value;
     std::string encoding;       // Optional encoding for variable length data.
 
+    std::string& string() { return *reinterpret_cast<std::string*>(value.storage); }
+    const std::string& string() const { return *reinterpret_cast<const std::string*>(value.storage); }
+    Variant::Map& map() { return *reinterpret_cast<Variant::Map*>(value.storage); }
+    const Variant::Map& map() const { return *reinterpret_cast<const Variant::Map*>(value.storage); }
+    Variant::List& list() { return *reinterpret_cast<Variant::List*>(value.storage); }
+    const Variant::List& list() const { return *reinterpret_cast<const Variant::List*>(value.storage); }
+    Uuid& uuid() { return *reinterpret_cast<Uuid*>(value.storage); }
+    const Uuid& uuid() const { return *reinterpret_cast<const Uuid*>(value.storage); }
+
   template<class T> T convertFromString() const
     {
-        const std::string& s = *value.string;
+        const std::string& s = string();
 
         try {
             // Extra shenanigans to work around negative zero
@@ -152,33 +168,87 @@ void VariantImpl::set(int32_t i) { reset(); type = VAR_INT32; value.i32 = i; }
 void VariantImpl::set(int64_t i) { reset(); type = VAR_INT64; value.i64 = i; }
 void VariantImpl::set(float f) { reset(); type = VAR_FLOAT; value.f = f; }
 void VariantImpl::set(double d) { reset(); type = VAR_DOUBLE; value.d = d; }
-void VariantImpl::set(const std::string& s, const std::string& e) { reset();  type = VAR_STRING; encoding = e; value.string = new std::string(s); }
+// The encoding is set after the value, which may be a reference to it.
+void VariantImpl::set(const std::string& s, const std::string& e)
+{
+    if (type == VAR_STRING) {
+        string() = s;           // Reuses the existing buffer, safe if s aliases it
+    } else if (type == VAR_MAP || type == VAR_LIST) {
+        std::string tmp(s);     // s may be inside the container being replaced
+        reset();
+        new (value.storage) std::string();
+        string().swap(tmp);
+        type = VAR_STRING;
+    } else {
+        reset();
+        new (value.storage) std::string(s);
+        type = VAR_STRING;
+    }
+    encoding = e;
+}
+
+void VariantImpl::set(const char* s)
+{
+    if (type == VAR_STRING) {
+        string() = s;           // Safe if s points into the string itself
+        encoding.clear();
+        return;
+    }
+    std::string tmp(s);         // s may point into the value being replaced
+    reset();
+    new (value.storage) std::string();
+    string().swap(tmp);
+    type = VAR_STRING;
+    encoding.clear();
+}
 
-void VariantImpl::set(const Variant::Map& m) {
+void VariantImpl::set(const Variant::Map& m)
+{
+    Variant::Map tmp(m);        // m may be inside the container being replaced
+    if (type == VAR_MAP) {
+        map().swap(tmp);
+        return;
+    }
     reset();
+    new (value.storage) Variant::Map();
+    map().swap(tmp);
     type = VAR_MAP;
-    value.map = new Variant::Map(m);
 }
 
-void VariantImpl::set(const Variant::List& l) { reset(); type = VAR_LIST; value.list = new Variant::List(l); }
+void VariantImpl::set(const Variant::List& l)
+{
+    Variant::List tmp(l);
+    if (type == VAR_LIST) {
+        list().swap(tmp);
+        return;
+    }
+    reset();
+    new (value.storage) Variant::List();
+    list().swap(tmp);
+    type = VAR_LIST;
+}
 
-void VariantImpl::set(const Uuid& u) { reset(); type = VAR_UUID; value.uuid = new Uuid(u); }
+void VariantImpl::set(const Uuid& u) { reset(); new (value.storage) Uuid(u); type = VAR_UUID; }
 
 VariantImpl::~VariantImpl() { reset(); }
 
+namespace {
+template <class T> void destroy(T& t) { t.~T(); }
+}
+
 void VariantImpl::reset() {
     switch (type) {
       case VAR_STRING:
-        delete value.string;
+        destroy(string());
         break;
       case VAR_MAP:
-        delete value.map;
+        destroy(map());
         break;
       case VAR_LIST:
-        delete value.list;
+        destroy(list());
         break;
       case VAR_UUID:
-        delete value.uuid;
+        destroy(uuid());
         break;
       default:
         break;
@@ -238,7 +308,7 @@ bool VariantImpl::asBool() const
       case VAR_INT16: return value.i16;
       case VAR_INT32: return value.i32;
       case VAR_INT64: return value.i64;
-      case VAR_STRING: return toBool(*value.string);
+      case VAR_STRING: return toBool(string());
       default: throw InvalidConversion(QPID_MSG("Cannot convert from " << getTypeName(type) << " to " << getTypeName(VAR_BOOL)));
     }
 }
@@ -517,8 +587,8 @@ std::string VariantImpl::asString() const
       case VAR_INT64: return boost::lexical_cast<std::string>(value.i64);
       case VAR_DOUBLE: return boost::lexical_cast<std::string>(value.d);
       case VAR_FLOAT: return boost::lexical_cast<std::string>(value.f);
-      case VAR_STRING: return *value.string;
-      case VAR_UUID: return value.uuid->str();
+      case VAR_STRING: return string();
+      case VAR_UUID: return uuid().str();
       case VAR_LIST: return toString(asList());
       case VAR_MAP: return toString(asMap());
       default: throw InvalidConversion(QPID_MSG("Cannot convert from " << getTypeName(type) << " to " << getTypeName(VAR_STRING)));
@@ -527,7 +597,7 @@ std::string VariantImpl::asString() const
 Uuid VariantImpl::asUuid() const
 {
     switch(type) {
-      case VAR_UUID: return *value.uuid;
+      case VAR_UUID: return uuid();
       default: throw InvalidConversion(QPID_MSG("Cannot convert from " << getTypeName(type) << " to " << getTypeName(VAR_UUID)));
     }
 }
@@ -548,8 +618,8 @@ bool VariantImpl::isEqualTo(VariantImpl& other) const
           case VAR_INT64: return value.i64 == other.value.i64;
           case VAR_DOUBLE: return value.d == other.value.d;
           case VAR_FLOAT: return value.f == other.value.f;
-          case VAR_STRING: return *value.string == *other.value.string;
-          case VAR_UUID: return *value.uuid == *other.value.uuid;
+          case VAR_STRING: return string() == other.string();
+          case VAR_UUID: return uuid() == other.uuid();
           case VAR_LIST: return equal(asList(), other.asList());
           case VAR_MAP: return equal(asMap(), other.asMap());
         }
@@ -560,7 +630,7 @@ bool VariantImpl::isEqualTo(VariantImpl& other) const
 const Variant::Map& VariantImpl::asMap() const
 {
     switch(type) {
-      case VAR_MAP: return *value.map;
+      case VAR_MAP: return map();
       default: throw InvalidConversion(QPID_MSG("Cannot convert from " << getTypeName(type) << " to " << getTypeName(VAR_MAP)));
     }
 }
@@ -568,7 +638,7 @@ const Variant::Map& VariantImpl::asMap() const
 Variant::Map& VariantImpl::asMap()
 {
     switch(type) {
-      case VAR_MAP: return *value.map;
+      case VAR_MAP: return map();
       default: throw InvalidConversion(QPID_MSG("Cannot convert from " << getTypeName(type) << " to " << getTypeName(VAR_MAP)));
     }
 }
@@ -576,7 +646,7 @@ Variant::Map& VariantImpl::asMap()
 const Variant::List& VariantImpl::asList() const
 {
     switch(type) {
-      case VAR_LIST: return *value.list;
+      case VAR_LIST: return list();
       default: throw InvalidConversion(QPID_MSG("Cannot convert from " << getTypeName(type) << " to " << getTypeName(VAR_LIST)));
     }
 }
@@ -584,7 +654,7 @@ const Variant::List& VariantImpl::asList() const
 Variant::List& VariantImpl::asList()
 {
     switch(type) {
-      case VAR_LIST: return *value.list;
+      case VAR_LIST: return list();
       default: throw InvalidConversion(QPID_MSG("Cannot convert from " << getTypeName(type) << " to " << getTypeName(VAR_LIST)));
     }
 }
@@ -592,7 +662,7 @@ Variant::List& VariantImpl::asList()
 std::string& VariantImpl::getString()
 {
     switch(type) {
-      case VAR_STRING: return *value.string;
+      case VAR_STRING: return string();
       default: throw InvalidConversion(QPID_MSG("Variant is not a string; use asString() if conversion is required."));
     }
 }
@@ -600,7 +670,7 @@ std::string& VariantImpl::getString()
 const std::string& VariantImpl::getString() const
 {
     switch(type) {
-      case VAR_STRING: return *value.string;
+      case VAR_STRING: return string();
       default: throw InvalidConversion(QPID_MSG("Variant is not a string; use asString() if conversion is required."));
     }
 }
@@ -651,6 +721,10 @@ bool isIntegerType(VariantType type)
 
 void VariantImpl::set(const Variant& v)
 {
+    // v may be held in this variant's own map or list, so take its
+    // encoding and descriptors before the old value is released.
+    std::string e(v.getEncoding());
+    Variant::List d(v.getDescriptors());
     switch (v.getType()) {
       case VAR_BOOL: set(v.asBool()); break;
       case VAR_UINT8: set(v.asUint8()); break;
@@ -663,14 +737,14 @@ void VariantImpl::set(const Variant& v)
       case VAR_INT64: set(v.asInt64()); break;
       case VAR_FLOAT: set(v.asFloat()); break;
       case VAR_DOUBLE: set(v.asDouble()); break;
-      case VAR_STRING: set(v.asString(), v.getEncoding()); break;
+      case VAR_STRING: set(v.getString(), e); break;
       case VAR_MAP: set(v.asMap()); break;
       case VAR_LIST: set(v.asList()); break;
       case VAR_UUID: set(v.asUuid()); break;
       default: reset();
     }
-    encoding = v.getEncoding();
-    descriptors = v.getDescriptors();
+    encoding.swap(e);
+    descriptors.swap(d);
 }
 
 Variant::Variant() : impl(0) {}
@@ -687,11 +761,11 @@ Variant::Variant(float f) : impl(new VariantImpl()) { impl->set(f); }
 Variant::Variant(double d) : impl(new VariantImpl()) { impl->set(d); }
 Variant::Variant(const std::string& s) : impl(new VariantImpl()) { impl->set(s); }
 Variant::Variant(const std::string& s, const std::string& encoding) : impl(new VariantImpl()) { impl->set(s, encoding); }
-Variant::Variant(const char* s) : impl(new VariantImpl()) { impl->set(std::string(s)); }
+Variant::Variant(const char* s) : impl(new VariantImpl()) { impl->set(s); }
 Variant::Variant(const char* s, const char* encoding) : impl(new VariantImpl()) { impl->set(std::string(s), std::string(encoding)); }
 Variant::Variant(const Map& m) : impl(new VariantImpl()) { impl->set(m); }
 Variant::Variant(const List& l) : impl(new VariantImpl()) { impl->set(l); }
-Variant::Variant(const Variant& v) : impl(new VariantImpl()) { impl->set(v); }
+Variant::Variant(const Variant& v) : impl(v.impl ? new VariantImpl() : 0) { if (impl) impl->set(v); }
 Variant::Variant(const Uuid& u) : impl(new VariantImpl()) { impl->set(u); }
 
 Variant::~Variant() { if (impl) delete impl; }
@@ -776,7 +850,7 @@ Variant& Variant::operator=(const std::string& s)
 
 Variant& Variant::operator=(const char* s)
 {
-    assure(impl)->set(std::string(s));
+    assure(impl)->set(s);
     return *this;
 }
 
@@ -800,6 +874,8 @@ Variant& Variant::operator=(const List& l)
 
 Variant& Variant::operator=(const Variant& v)
 {
+    if (this == &v) return *this;
+    if (!v.impl && !impl) return *this;
     assure(impl)->set(v);
     return *this;
 }
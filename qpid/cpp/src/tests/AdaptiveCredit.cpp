@@ -0,0 +1,106 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+#include "unit_test.h"
+#include "test_tools.h"
+#include "qpid/messaging/AdaptiveCredit.h"
+#include "qpid/sys/Time.h"
+
+namespace qpid {
+namespace tests {
+
+QPID_AUTO_TEST_SUITE(AdaptiveCreditTestSuite)
+
+using qpid::messaging::AdaptiveCredit;
+using qpid::sys::TIME_MSEC;
+using qpid::sys::TIME_USEC;
+
+// Consume messages until the window is re-evaluated.
+bool consumeHalf(AdaptiveCredit& credit, uint32_t& window) {
+    uint32_t before = window;
+    for (uint32_t i = 1; i < std::max(before/2, 1u); ++i)
+        BOOST_REQUIRE(!credit.consumed(window));
+    return credit.consumed(window);
+}
+
+QPID_AUTO_TEST_CASE(testBound) {
+    AdaptiveCredit credit(10, 100);
+    BOOST_CHECK_EQUAL(credit.bound(0), 10u);
+    BOOST_CHECK_EQUAL(credit.bound(50), 50u);
+    BOOST_CHECK_EQUAL(credit.bound(1000), 100u);
+    // A zero minimum still leaves room for one message.
+    BOOST_CHECK_EQUAL(AdaptiveCredit(0, 0).bound(0), 1u);
+}
+
+QPID_AUTO_TEST_CASE(testNoStallMeasured) {
+    AdaptiveCredit credit(2, 100);
+    uint32_t window = 50;
+    // Without a measured stall there is nothing to size the window from.
+    BOOST_CHECK(!consumeHalf(credit, window));
+    BOOST_CHECK_EQUAL(window, 50u);
+    credit.waited(10*TIME_USEC);
+    BOOST_CHECK(!consumeHalf(credit, window));
+    BOOST_CHECK_EQUAL(window, 50u);
+}
+
+QPID_AUTO_TEST_CASE(testShrinkWithoutStalls) {
+    AdaptiveCredit credit(2, 100);
+    uint32_t window = 50;
+    credit.waited(20*TIME_MSEC);
+    consumeHalf(credit, window);
+    // No more stalls: the measured delay decays and the window shrinks
+    // towards the minimum.
+    for (int i = 0; i < 1000 && window > 2; ++i)
+        consumeHalf(credit, window);
+    BOOST_CHECK_EQUAL(window, 2u);
+    BOOST_CHECK(!consumeHalf(credit, window));
+    BOOST_CHECK_EQUAL(window, 2u);
+}
+
+QPID_AUTO_TEST_CASE(testGrowOnStalls) {
+    AdaptiveCredit credit(2, 100);
+    uint32_t window = 2;
+    // Short waits were served from prefetched messages: no change.
+    credit.waited(10*TIME_USEC);
+    BOOST_CHECK(!consumeHalf(credit, window));
+    BOOST_CHECK_EQUAL(window, 2u);
+    // Waiting on every evaluation while consuming quickly grows the
+    // window up to, but not beyond, the maximum.
+    for (int i = 0; i < 20 && window < 100; ++i) {
+        uint32_t before = window;
+        credit.waited(20*TIME_MSEC);
+        if (consumeHalf(credit, window))
+            BOOST_CHECK(window > before);
+    }
+    BOOST_CHECK_EQUAL(window, 100u);
+}
+
+QPID_AUTO_TEST_CASE(testSmallChangesIgnored) {
+    AdaptiveCredit credit(40, 44);
+    uint32_t window = 40;
+    // The target of 44 is within a quarter window of the current size.
+    credit.waited(20*TIME_MSEC);
+    BOOST_CHECK(!consumeHalf(credit, window));
+    BOOST_CHECK_EQUAL(window, 40u);
+}
+
+QPID_AUTO_TEST_SUITE_END()
+
+}} // namespace qpid::tests
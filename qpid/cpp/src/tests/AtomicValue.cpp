@@ -46,6 +46,7 @@ QPID_AUTO_TEST_CASE(test) {
     BOOST_CHECK_EQUAL(x.get(), 10);
     BOOST_CHECK(x.boolCompareAndSwap(10, 6));
     BOOST_CHECK_EQUAL(x.get(), 6);
+    BOOST_CHECK_EQUAL(x.peek(), 6);
 }
 
 
@@ -0,0 +1,87 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/ha/CatchupCredit.h"
+#include "unit_test.h"
+
+namespace qpid {
+namespace tests {
+
+QPID_AUTO_TEST_SUITE(CatchupCreditTestSuite)
+
+using qpid::ha::CatchupCredit;
+
+// A message five times the per-tick share goes through on the first
+// grant and holds back the queue for the ticks it overdrew.
+QPID_AUTO_TEST_CASE(testLargeMessage)
+{
+    CatchupCredit c;
+    BOOST_CHECK_EQUAL(c.tick(1000), 1u);
+    c.received(5000);
+    BOOST_CHECK_EQUAL(c.getBalance(), -4000);
+    for (int i = 0; i < 4; ++i) BOOST_CHECK_EQUAL(c.tick(1000), 0u);
+    BOOST_CHECK_EQUAL(c.getBalance(), 0);
+    BOOST_CHECK_EQUAL(c.tick(1000), 1u);
+    c.received(5000);
+    BOOST_CHECK_EQUAL(c.tick(1000), 0u);
+}
+
+// Credit is granted to cover the balance at the average message size.
+QPID_AUTO_TEST_CASE(testSmallMessages)
+{
+    CatchupCredit c;
+    BOOST_CHECK_EQUAL(c.tick(1000), 1u);
+    c.received(100);
+    BOOST_CHECK_EQUAL(c.tick(1000), 10u);
+    for (int i = 0; i < 10; ++i) c.received(100);
+    BOOST_CHECK_EQUAL(c.getBalance(), 0);
+    // Nothing left on the primary, grant the next tick's share.
+    BOOST_CHECK_EQUAL(c.tick(1000), 10u);
+}
+
+// Balance unused while the queue had nothing to send is kept for one
+// tick only and isn't granted again.
+QPID_AUTO_TEST_CASE(testIdle)
+{
+    CatchupCredit c;
+    BOOST_CHECK_EQUAL(c.tick(1000), 1u);
+    c.received(100);
+    BOOST_CHECK_EQUAL(c.tick(1000), 10u);
+    for (int i = 0; i < 5; ++i) BOOST_CHECK_EQUAL(c.tick(1000), 0u);
+    BOOST_CHECK_EQUAL(c.getBalance(), 1000);
+}
+
+// Events use credit but aren't charged, and sent without credit they
+// don't leave the estimate below 0.
+QPID_AUTO_TEST_CASE(testEvents)
+{
+    CatchupCredit c;
+    c.receivedEvent();
+    c.receivedEvent();
+    BOOST_CHECK_EQUAL(c.tick(1000), 1u);
+    c.receivedEvent();
+    BOOST_CHECK_EQUAL(c.getBalance(), 1000);
+    BOOST_CHECK_EQUAL(c.tick(1000), 1u);
+}
+
+QPID_AUTO_TEST_SUITE_END()
+
+}} // namespace qpid::tests
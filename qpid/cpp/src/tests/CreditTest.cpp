@@ -0,0 +1,89 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+#include "qpid/broker/Credit.h"
+#include "unit_test.h"
+
+using namespace qpid::broker;
+
+namespace qpid {
+namespace tests {
+
+QPID_AUTO_TEST_SUITE(CreditTestSuite)
+
+QPID_AUTO_TEST_CASE(testBalanceConsume)
+{
+    CreditBalance b;
+    b.grant(10);
+    BOOST_CHECK(b.check(10));
+    b.consume(4);
+    BOOST_CHECK_EQUAL(b.remaining(), 6u);
+    BOOST_CHECK(!b.check(7));
+}
+
+// A delivery that bypasses the credit check, like an HA event, can
+// consume more than is left. The balance must stop at 0 rather than
+// wrap round to a huge or unlimited balance.
+QPID_AUTO_TEST_CASE(testBalanceOverConsume)
+{
+    CreditBalance b;
+    b.grant(10);
+    b.consume(25);
+    BOOST_CHECK_EQUAL(b.remaining(), 0u);
+    BOOST_CHECK(!b.unlimited());
+    BOOST_CHECK(!b.check(1));
+    b.grant(5);
+    BOOST_CHECK_EQUAL(b.remaining(), 5u);
+
+    b.clear();
+    b.grant(1);
+    b.consume(CreditBalance::INFINITE_CREDIT);
+    BOOST_CHECK_EQUAL(b.remaining(), 0u);
+    BOOST_CHECK(!b.unlimited());
+}
+
+QPID_AUTO_TEST_CASE(testBalanceUnlimited)
+{
+    CreditBalance b;
+    b.grant(CreditBalance::INFINITE_CREDIT);
+    b.consume(1000);
+    BOOST_CHECK(b.unlimited());
+    BOOST_CHECK(b.check(0xFFFFFFFE));
+}
+
+// HA catch-up grants message credit with no byte limit: one credit lets
+// a message of any size through.
+QPID_AUTO_TEST_CASE(testCreditModeMessageCredit)
+{
+    Credit c;
+    c.setWindowMode(false);
+    c.addByteCredit(CreditBalance::INFINITE_CREDIT);
+    c.addMessageCredit(1);
+    BOOST_CHECK(c.check(1, 0xFFFFFFFE));
+    c.consume(1, 1000000);
+    BOOST_CHECK(!c.check(1, 1));
+    c.addMessageCredit(2);
+    BOOST_CHECK(c.check(1, 1000000));
+    BOOST_CHECK_EQUAL(c.allocated().messages, 2u);
+}
+
+QPID_AUTO_TEST_SUITE_END()
+
+}} // namespace qpid::tests
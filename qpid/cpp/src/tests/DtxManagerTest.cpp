@@ -0,0 +1,123 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+#include "qpid/broker/DtxBuffer.h"
+#include "qpid/broker/DtxManager.h"
+#include "qpid/broker/DtxTimeout.h"
+#include "qpid/broker/DtxWorkRecord.h"
+#include "qpid/sys/Time.h"
+#include "qpid/sys/Timer.h"
+#include "unit_test.h"
+#include <boost/lexical_cast.hpp>
+#include <string>
+#include <vector>
+
+using namespace qpid::broker;
+using namespace qpid::sys;
+
+namespace qpid {
+namespace tests {
+
+QPID_AUTO_TEST_SUITE(DtxManagerTestSuite)
+
+QPID_AUTO_TEST_CASE(testTimeoutBatch)
+{
+    // Branches given the same timeout together share a timer task and
+    // expire together, no earlier than their timeout.
+    Timer timer;
+    DtxManager mgr(timer);
+    std::vector<std::string> xids;
+    for (int i = 0; i < 10; ++i) {
+        xids.push_back("xid" + boost::lexical_cast<std::string>(i));
+        mgr.start(xids.back(), boost::intrusive_ptr<DtxBuffer>(new DtxBuffer(xids.back())));
+        mgr.setTimeout(xids.back(), 1);
+    }
+    mgr.start("other", boost::intrusive_ptr<DtxBuffer>(new DtxBuffer("other")));
+    mgr.setTimeout("other", 5);
+
+    boost::intrusive_ptr<DtxTimeout> batch = mgr.getWork(xids[0])->getTimeout();
+    BOOST_CHECK(batch);
+    for (size_t i = 0; i < xids.size(); ++i) {
+        BOOST_CHECK(mgr.getWork(xids[i])->getTimeout() == batch);
+        BOOST_CHECK_EQUAL(mgr.getTimeout(xids[i]), 1u);
+    }
+    BOOST_CHECK(mgr.getWork("other")->getTimeout() != batch);
+
+    qpid::sys::usleep(800*1000);
+    for (size_t i = 0; i < xids.size(); ++i)
+        BOOST_CHECK(!mgr.getWork(xids[i])->isExpired());
+    qpid::sys::usleep(700*1000);
+    for (size_t i = 0; i < xids.size(); ++i)
+        BOOST_CHECK(mgr.getWork(xids[i])->isExpired());
+    BOOST_CHECK(!mgr.getWork("other")->isExpired());
+}
+
+QPID_AUTO_TEST_CASE(testTimeoutChanged)
+{
+    // A branch given a new timeout leaves its old batch.
+    Timer timer;
+    DtxManager mgr(timer);
+    mgr.start("a", boost::intrusive_ptr<DtxBuffer>(new DtxBuffer("a")));
+    mgr.start("b", boost::intrusive_ptr<DtxBuffer>(new DtxBuffer("b")));
+    mgr.setTimeout("a", 1);
+    mgr.setTimeout("b", 1);
+    mgr.setTimeout("b", 10);
+    BOOST_CHECK_EQUAL(mgr.getTimeout("b"), 10u);
+    qpid::sys::usleep(1500*1000);
+    BOOST_CHECK(mgr.getWork("a")->isExpired());
+    BOOST_CHECK(!mgr.getWork("b")->isExpired());
+}
+
+QPID_AUTO_TEST_CASE(testTimeoutXidRecreated)
+{
+    // The manager destroys a removed record outside the shard lock, so
+    // the xid may be re-created and join the same batch first. Destroying
+    // the old record must leave the new branch in the batch.
+    Timer timer;
+    DtxManager mgr(timer);
+    mgr.start("x", boost::intrusive_ptr<DtxBuffer>(new DtxBuffer("x")));
+    mgr.setTimeout("x", 1);
+    boost::intrusive_ptr<DtxTimeout> batch = mgr.getWork("x")->getTimeout();
+    {
+        DtxWorkRecord old("x", 0);
+        old.setTimeout(batch);
+        batch->add("x", old.getId());
+    }
+    qpid::sys::usleep(1500*1000);
+    BOOST_CHECK(mgr.getWork("x")->isExpired());
+}
+
+QPID_AUTO_TEST_CASE(testTimeoutStaleBranch)
+{
+    // A batch that fires after its branch's xid was re-created with a
+    // longer timeout doesn't expire the new branch.
+    Timer timer;
+    DtxManager mgr(timer);
+    mgr.start("x", boost::intrusive_ptr<DtxBuffer>(new DtxBuffer("x")));
+    mgr.setTimeout("x", 10);
+    DtxTimeout::Branches stale;
+    stale.push_back(std::make_pair(std::string("x"), mgr.getWork("x")->getId() + 1));
+    mgr.timedout(stale);
+    BOOST_CHECK(!mgr.getWork("x")->isExpired());
+}
+
+QPID_AUTO_TEST_SUITE_END()
+
+}} // namespace qpid::tests
@@ -210,6 +210,47 @@ QPID_AUTO_TEST_CASE(test64GetAndSetConverts)
 
 }
 
+QPID_AUTO_TEST_CASE(testLookupWithoutDecode)
+{
+    FieldTable in;
+    in.setString("zebra", "stripes");
+    in.setInt("aardvark", 7);
+    FieldTable nested;
+    nested.setDouble("pi", 3.14);
+    in.setTable("mid", nested);
+    in.setUInt64("", 42);
+
+    char buff[200];
+    Buffer wbuffer(buff, 200);
+    wbuffer.put(in);
+    Buffer rbuffer(buff, wbuffer.getPosition());
+    FieldTable a;
+    rbuffer.get(a);
+
+    BOOST_CHECK_EQUAL(std::string("stripes"), a.getAsString("zebra"));
+    BOOST_CHECK_EQUAL(7, a.getAsInt("aardvark"));
+    BOOST_CHECK_EQUAL(42u, a.getAsUInt64(""));
+    FieldTable n;
+    BOOST_CHECK(a.getTable("mid", n));
+    double d;
+    BOOST_CHECK(n.getDouble("pi", d));
+    BOOST_CHECK_EQUAL(3.14, d);
+    BOOST_CHECK(!a.isSet("zebr"));
+    BOOST_CHECK(!a.isSet("zebras"));
+    BOOST_CHECK(!a.isSet("b"));
+    BOOST_CHECK_EQUAL(4u, a.size());
+
+    // Modifying a copy leaves the original untouched
+    FieldTable b(a);
+    b.setString("zebra", "spots");
+    b.erase("aardvark");
+    BOOST_CHECK_EQUAL(std::string("spots"), b.getAsString("zebra"));
+    BOOST_CHECK(!b.isSet("aardvark"));
+    BOOST_CHECK_EQUAL(std::string("stripes"), a.getAsString("zebra"));
+    BOOST_CHECK_EQUAL(7, a.getAsInt("aardvark"));
+    BOOST_CHECK(a == in);
+}
+
 QPID_AUTO_TEST_SUITE_END()
 
 }} // namespace qpid::tests
@@ -163,6 +163,21 @@ QPID_AUTO_TEST_CASE(badStrings) {
     b.putMediumString(std::string(65535, 'X'));
 }
 
+QPID_AUTO_TEST_CASE(testIntegerByteOrder) {
+    char data[14];
+    Buffer w(data, sizeof(data));
+    w.putShort(0x0102);
+    w.putLong(0x03040506);
+    w.putLongLong(0x0708090a0b0c0d0eULL);
+    for (size_t i = 0; i < sizeof(data); ++i)
+        BOOST_CHECK_EQUAL(int(data[i]), int(i+1));
+    Buffer r(data, sizeof(data));
+    BOOST_CHECK_EQUAL(r.getShort(), 0x0102u);
+    BOOST_CHECK_EQUAL(r.getLong(), 0x03040506u);
+    BOOST_CHECK_EQUAL(r.getLongLong(), 0x0708090a0b0c0d0eULL);
+    BOOST_CHECK_THROW(r.getShort(), Exception);
+}
+
 QPID_AUTO_TEST_SUITE_END()
 
 }} // namespace qpid::tests
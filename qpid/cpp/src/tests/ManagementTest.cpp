@@ -20,8 +20,16 @@
  */
 
 #include "qpid/management/ManagementObject.h"
+#include "qpid/broker/Queue.h"
+#include "qpid/broker/QueueRegistry.h"
 #include "qpid/framing/Buffer.h"
+#include "qpid/sys/AtomicValue.h"
+#include "qpid/sys/Runnable.h"
+#include "qpid/sys/Thread.h"
+#include "qpid/sys/Time.h"
+#include "qmf/org/apache/qpid/broker/Queue.h"
 #include "unit_test.h"
+#include "BrokerFixture.h"
 
 namespace qpid {
 namespace tests {
@@ -92,6 +100,150 @@ QPID_AUTO_TEST_CASE(testObjectIdCreate) {
     BOOST_CHECK_EQUAL(oid.getV2Key(), "an-object-name");
 }
 
+QPID_AUTO_TEST_CASE(testHistogram) {
+    BOOST_CHECK_EQUAL(Histogram::bucket(0), 0u);
+    BOOST_CHECK_EQUAL(Histogram::bucket(1023), 0u);
+    BOOST_CHECK_EQUAL(Histogram::bucket(1024), 1u);
+    BOOST_CHECK_EQUAL(Histogram::bucket(2047), 1u);
+    BOOST_CHECK_EQUAL(Histogram::bucket(2048), 2u);
+    // The last bucket starts at 2^40ns, about 18.3 minutes
+    BOOST_CHECK_EQUAL(Histogram::bucket((uint64_t(1) << 40) - 1), Histogram::BUCKETS - 2);
+    BOOST_CHECK_EQUAL(Histogram::bucket(uint64_t(1) << 40), Histogram::BUCKETS - 1);
+    BOOST_CHECK_EQUAL(Histogram::bucket(uint64_t(1) << 63), Histogram::BUCKETS - 1);
+
+    uint64_t buckets[Histogram::BUCKETS] = {0};
+    for (int i = 0; i < 90; i++) buckets[Histogram::bucket(1500)]++;
+    for (int i = 0; i < 10; i++) buckets[Histogram::bucket(5000)]++;
+
+    BOOST_CHECK_EQUAL(Histogram::percentile(buckets, 100, 5000, 0.5), 2048u);
+    BOOST_CHECK_EQUAL(Histogram::percentile(buckets, 100, 5000, 0.9), 2048u);
+    BOOST_CHECK_EQUAL(Histogram::percentile(buckets, 100, 5000, 0.99), 5000u);
+    BOOST_CHECK_EQUAL(Histogram::percentile(buckets, 0, 0, 0.99), 0u);
+
+    qpid::types::Variant::List list = Histogram::list(buckets);
+    BOOST_CHECK_EQUAL(list.size(), Histogram::BUCKETS);
+    BOOST_CHECK_EQUAL(list.front().asUint64(), 0u);
+}
+
+namespace {
+struct TestObject : public ManagementObject
+{
+    TestObject() : ManagementObject(0) {}
+
+    // As generated statistic accessors do.
+    void change() { instChanged = true; notifyChange(); }
+
+    writeSchemaCall_t getWriteSchemaCall() { return 0; }
+    std::string getKey() const { return std::string(); }
+    void mapEncodeValues(types::Variant::Map&, bool, bool) {}
+    void mapDecodeValues(const types::Variant::Map&) {}
+    void doMethod(std::string&, const types::Variant::Map&, types::Variant::Map&, const std::string&) {}
+    std::string& getClassName() const { static std::string name("test"); return name; }
+    std::string& getPackageName() const { return getClassName(); }
+    uint8_t* getMd5Sum() const { static uint8_t md5[MD5_LEN] = {0}; return md5; }
+};
+
+struct CountingListener : public ManagementObjectListener
+{
+    uint32_t changes;
+    CountingListener() : changes(0) {}
+    void objectChanged(ManagementObject&) { ++changes; }
+};
+
+// Publishes the object whenever it is queued, remembering the last
+// change count it would have encoded.
+struct Publisher : public sys::Runnable
+{
+    TestObject& object;
+    sys::AtomicValue<uint32_t>& count;
+    sys::AtomicValue<uint32_t> done;
+    uint32_t published;
+
+    Publisher(TestObject& o, sys::AtomicValue<uint32_t>& c) : object(o), count(c), done(0), published(0) {}
+
+    void run() {
+        while (!done.get()) {
+            if (object.getChangeQueued()) {
+                object.clearChangeQueued();
+                published = count.get();
+            }
+        }
+    }
+};
+}
+
+QPID_AUTO_TEST_CASE(testChangeQueuedOnce) {
+    CountingListener listener;
+    TestObject object;
+    object.setListener(&listener);
+    object.change();
+    object.change();
+    BOOST_CHECK_EQUAL(listener.changes, 1u);
+
+    // The publisher takes the object, then it changes while being encoded.
+    object.clearChangeQueued();
+    object.change();
+    BOOST_CHECK_EQUAL(listener.changes, 2u);
+    BOOST_CHECK(object.getChangeQueued());
+
+    // Once detached from its listener the object no longer reports.
+    object.setListener(0);
+    object.clearChangeQueued();
+    object.change();
+    BOOST_CHECK_EQUAL(listener.changes, 2u);
+}
+
+QPID_AUTO_TEST_CASE(testChangeDuringPublishNotLost) {
+    TestObject object;
+    sys::AtomicValue<uint32_t> count;
+    Publisher publisher(object, count);
+    sys::Thread thread(publisher);
+    const uint32_t CHANGES = 100000;
+    for (uint32_t i = 0; i < CHANGES; ++i) {
+        ++count;
+        object.change();
+    }
+    ++publisher.done;
+    thread.join();
+    // Either the last change is still queued, or it was published.
+    if (!object.getChangeQueued())
+        BOOST_CHECK_EQUAL(publisher.published, CHANGES);
+}
+
+QPID_AUTO_TEST_CASE(testResidencyTimeBucket) {
+    SessionFixture f;
+    std::string q("residency-queue");
+    f.session.queueDeclare(client::arg::queue=q);
+    f.session.messageTransfer(client::arg::content=client::Message("a", q));
+    qpid::sys::usleep(20*1000);
+    client::Message msg;
+    BOOST_CHECK(f.subs.get(msg, q, qpid::sys::TIME_SEC));
+    f.session.sync();
+
+    boost::shared_ptr<broker::Queue> queue = f.broker->getQueues().find(q);
+    BOOST_REQUIRE(queue);
+    qmf::org::apache::qpid::broker::Queue::shared_ptr mgmt =
+        boost::dynamic_pointer_cast<qmf::org::apache::qpid::broker::Queue>(queue->GetManagementObject());
+    BOOST_REQUIRE(mgmt);
+    types::Variant::Map stats;
+    mgmt->mapEncodeValues(stats, false, true);
+
+    BOOST_CHECK_EQUAL(stats["residencyTimeSamples"].asUint64(), 1u);
+    uint64_t residency = stats["residencyTimeMax"].asUint64();
+    BOOST_CHECK(residency >= uint64_t(20*qpid::sys::TIME_MSEC));
+    BOOST_CHECK(residency < uint64_t(10*qpid::sys::TIME_SEC));
+
+    // The one sample is counted in the bucket for its value and no other
+    types::Variant::List histogram = stats["residencyTimeHistogram"].asList();
+    BOOST_REQUIRE_EQUAL(histogram.size(), Histogram::BUCKETS);
+    size_t expected = Histogram::bucket(residency);
+    BOOST_CHECK(expected >= Histogram::bucket(20*qpid::sys::TIME_MSEC));
+    size_t i = 0;
+    for (types::Variant::List::const_iterator b = histogram.begin(); b != histogram.end(); ++b, ++i) {
+        BOOST_CHECK_EQUAL(b->asUint64(), i == expected ? 1u : 0u);
+    }
+}
+
 QPID_AUTO_TEST_SUITE_END()
 
 }} // namespace qpid::tests
@@ -84,6 +84,26 @@ QPID_AUTO_TEST_CASE(testMessageProperties)
   BOOST_CHECK_EQUAL(msg.getProperty("abcdef").getType(), qpid::types::VAR_VOID);
 }
 
+namespace {
+struct TestTranslation : public qpid::RefCounted {};
+}
+
+QPID_AUTO_TEST_CASE(testTranslationCache)
+{
+    Message msg = MessageUtils::createMessage(qpid::types::Variant::Map(), "abc");
+    Message copy = msg;
+    BOOST_CHECK(!msg.getTranslation("a"));
+
+    boost::intrusive_ptr<const qpid::RefCounted> first(new TestTranslation());
+    boost::intrusive_ptr<const qpid::RefCounted> second(new TestTranslation());
+    BOOST_CHECK(msg.setTranslation("a", first) == first);
+    // Copies share the cache, and the first translation cached is kept.
+    BOOST_CHECK(copy.getTranslation("a") == first);
+    BOOST_CHECK(copy.setTranslation("a", second) == first);
+    BOOST_CHECK(!copy.getTranslation("b"));
+    BOOST_CHECK(msg.setTranslation("b", second) == second);
+}
+
 QPID_AUTO_TEST_SUITE_END()
 
 }} // namespace qpid::tests
@@ -32,9 +32,12 @@
 #include "qpid/framing/ExchangeQueryResult.h"
 #include "qpid/framing/reply_exceptions.h"
 #include "qpid/framing/Uuid.h"
+#include "qpid/broker/Queue.h"
+#include "qpid/broker/QueueRegistry.h"
 #include "qpid/sys/Time.h"
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -370,6 +373,90 @@ QPID_AUTO_TEST_CASE(testUnsettledAcks)
     BOOST_CHECK_EQUAL(fix.session.getUnsettledAcks(), 0u);
 }
 
+QPID_AUTO_TEST_CASE(testFetchBatch)
+{
+    QueueFixture fix;
+    Sender sender = fix.session.createSender(fix.queue);
+    for (uint i = 0; i < 10; ++i) {
+        sender.send(Message((boost::format("Message_%1%") % (i+1)).str()));
+    }
+    Receiver receiver = fix.session.createReceiver(fix.queue);
+    std::vector<Message> batch(4);
+    uint next = 0;
+    for (uint expected = 4; next < 10; expected = std::min(4u, 10 - next)) {
+        uint32_t count = receiver.fetch(batch, Duration::SECOND * 5);
+        BOOST_CHECK_EQUAL(count, expected);
+        for (uint32_t i = 0; i < count; ++i) {
+            BOOST_CHECK_EQUAL(batch[i].getContent(), (boost::format("Message_%1%") % (++next)).str());
+        }
+        fix.session.acknowledge(batch, count, true);
+        BOOST_CHECK_EQUAL(fix.session.getUnsettledAcks(), 0u);
+    }
+    BOOST_CHECK_EQUAL(receiver.fetch(batch, Duration::IMMEDIATE), 0u);
+}
+
+QPID_AUTO_TEST_CASE(testAdaptiveCapacity)
+{
+    QueueFixture fix;
+    Connection connection = fix.newConnection();
+    connection.setOption("adaptive-capacity", true);
+    connection.setOption("adaptive-capacity-min", 2);
+    connection.setOption("adaptive-capacity-max", 50);
+    connection.open();
+    Session session = connection.createSession();
+    Sender sender = session.createSender(fix.queue);
+    for (uint i = 0; i < 200; ++i) {
+        sender.send(Message((boost::format("Message_%1%") % (i+1)).str()));
+    }
+    Receiver receiver = session.createReceiver(fix.queue);
+    receiver.setCapacity(100);
+    BOOST_CHECK_EQUAL(receiver.getCapacity(), 50u);
+    for (uint i = 0; i < 200; ++i) {
+        BOOST_CHECK_EQUAL(receiver.fetch(Duration::SECOND * 5).getContent(), (boost::format("Message_%1%") % (i+1)).str());
+        BOOST_CHECK(receiver.getCapacity() >= 2u && receiver.getCapacity() <= 50u);
+    }
+    session.acknowledge(true);
+    connection.close();
+}
+
+QPID_AUTO_TEST_CASE(testAdaptiveCapacityCredit)
+{
+    QueueFixture fix;
+    Connection connection = fix.newConnection();
+    connection.setOption("adaptive-capacity", true);
+    connection.setOption("adaptive-capacity-min", 2);
+    connection.setOption("adaptive-capacity-max", 50);
+    connection.open();
+    Session session = connection.createSession();
+    Sender sender = session.createSender(fix.queue);
+    const uint count = 500;
+    for (uint i = 0; i < count; ++i) sender.send(Message("x"));
+    boost::shared_ptr<qpid::broker::Queue> queue = fix.broker->getQueues().find(fix.queue);
+    BOOST_REQUIRE(queue);
+
+    Receiver receiver = session.createReceiver(fix.queue);
+    receiver.setCapacity(50);
+    // The broker may have delivered up to the largest window granted
+    // since the prefetched messages last fitted in the current one.
+    uint32_t limit = receiver.getCapacity();
+    std::set<uint32_t> sizes;
+    for (uint i = 0; i < count; ++i) {
+        receiver.fetch(Duration::SECOND * 5);
+        uint32_t capacity = receiver.getCapacity();
+        sizes.insert(capacity);
+        uint32_t acquired = count - queue->getMessageCount();
+        uint32_t prefetched = acquired - (i+1);
+        if (prefetched <= capacity) limit = capacity;
+        else limit = std::max(limit, capacity);
+        BOOST_CHECK_MESSAGE(prefetched <= limit,
+                            "prefetched " << prefetched << " messages, window " << capacity
+                            << ", limit " << limit);
+    }
+    BOOST_CHECK(sizes.size() > 1);
+    session.acknowledge(true);
+    connection.close();
+}
+
 QPID_AUTO_TEST_CASE(testUnsettledSend)
 {
     QueueFixture fix;
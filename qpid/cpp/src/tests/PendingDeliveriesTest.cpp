@@ -0,0 +1,98 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/broker/amqp/PendingDeliveries.h"
+#include "unit_test.h"
+#include <vector>
+
+namespace qpid {
+namespace tests {
+
+QPID_AUTO_TEST_SUITE(PendingDeliveriesTestSuite)
+
+using qpid::broker::amqp::PendingDeliveries;
+
+namespace {
+bool odd(int d) { return d % 2; }
+}
+
+// Completions that arrive out of order are settled in the order received.
+QPID_AUTO_TEST_CASE(testReceiveOrder)
+{
+    PendingDeliveries<int> p;
+    for (int d = 10; d > 0; --d) p.add(d); // Received 10, 9, ... 1
+    BOOST_CHECK(p.complete(3));
+    BOOST_CHECK(!p.complete(7));
+    BOOST_CHECK(!p.complete(5));
+    std::vector<int> settle;
+    BOOST_CHECK(p.take(settle));
+    BOOST_REQUIRE_EQUAL(settle.size(), 3u);
+    BOOST_CHECK_EQUAL(settle[0], 7);
+    BOOST_CHECK_EQUAL(settle[1], 5);
+    BOOST_CHECK_EQUAL(settle[2], 3);
+    BOOST_CHECK(!p.isPending(5));
+    BOOST_CHECK(p.isPending(4));
+}
+
+// Only the first completion of a batch asks for the IO thread; a
+// completion after the batch was taken starts a new one.
+QPID_AUTO_TEST_CASE(testWakeOncePerBatch)
+{
+    PendingDeliveries<int> p;
+    p.add(1);
+    p.add(2);
+    p.add(3);
+    BOOST_CHECK(p.complete(1));
+    BOOST_CHECK(!p.complete(2));
+    std::vector<int> settle;
+    BOOST_CHECK(p.take(settle));
+    BOOST_CHECK_EQUAL(settle.size(), 2u);
+    settle.clear();
+    BOOST_CHECK(!p.take(settle));
+    BOOST_CHECK(p.complete(3));
+    BOOST_CHECK(p.take(settle));
+    BOOST_CHECK_EQUAL(settle.size(), 1u);
+}
+
+// Deliveries no longer pending, settled synchronously or aborted with
+// their link, are dropped from the batch.
+QPID_AUTO_TEST_CASE(testNoLongerPending)
+{
+    PendingDeliveries<int> p;
+    for (int d = 1; d <= 4; ++d) p.add(d);
+    BOOST_CHECK(!p.complete(9));
+    BOOST_CHECK(p.complete(1));
+    BOOST_CHECK(!p.complete(2));
+    BOOST_CHECK(!p.complete(3));
+    BOOST_CHECK(p.remove(2));
+    BOOST_CHECK(!p.remove(2));
+    p.removeIf(odd);
+    BOOST_CHECK(!p.isPending(1));
+    BOOST_CHECK(!p.isPending(3));
+    BOOST_CHECK(p.isPending(4));
+    std::vector<int> settle;
+    BOOST_CHECK(p.take(settle));
+    BOOST_CHECK(settle.empty());
+}
+
+QPID_AUTO_TEST_SUITE_END()
+
+}} // namespace qpid::tests
@@ -39,6 +39,7 @@
 #include "qpid/framing/reply_exceptions.h"
 #include "qpid/broker/QueueFlowLimit.h"
 #include "qpid/broker/QueueSettings.h"
+#include "qpid/broker/TxBuffer.h"
 #include "qpid/sys/Thread.h"
 #include "qpid/sys/Timer.h"
 
@@ -183,6 +184,68 @@ QPID_AUTO_TEST_CASE(testLVQEmptyKey){
     BOOST_CHECK_EQUAL(q->getMessageCount(), 2u);
 }
 
+QPID_AUTO_TEST_CASE(testTxPublishGrouping){
+    // A transaction's enqueues onto each queue are collected into one op,
+    // and committed in order.
+    Queue::shared_ptr a(new Queue("a"));
+    Queue::shared_ptr b(new Queue("b"));
+    qpid::types::Variant::Map none;
+    TxBuffer txn;
+    a->deliver(MessageUtils::createMessage(none, "a1"), &txn);
+    TxOp::shared_ptr op = txn.getEnlisted(a.get());
+    BOOST_CHECK(op);
+    b->deliver(MessageUtils::createMessage(none, "b1"), &txn);
+    a->deliver(MessageUtils::createMessage(none, "a2"), &txn);
+    b->deliver(MessageUtils::createMessage(none, "b2"), &txn);
+    a->deliver(MessageUtils::createMessage(none, "a3"), &txn);
+    BOOST_CHECK(txn.getEnlisted(a.get()) == op);
+    BOOST_CHECK(txn.getEnlisted(b.get()));
+    BOOST_CHECK(txn.getEnlisted(b.get()) != op);
+    BOOST_CHECK_EQUAL(a->getMessageCount(), 0u);
+
+    BOOST_CHECK(txn.prepare(0));
+    txn.commit();
+    BOOST_CHECK_EQUAL(a->getMessageCount(), 3u);
+    BOOST_CHECK_EQUAL(b->getMessageCount(), 2u);
+    TestConsumer::shared_ptr c(new TestConsumer("test", true));
+    const char* expected[] = { "a1", "a2", "a3" };
+    for (size_t i = 0; i < sizeof(expected)/sizeof(expected[0]); ++i) {
+        BOOST_CHECK(a->dispatch(c));
+        BOOST_CHECK_EQUAL(std::string(expected[i]), c->lastMessage.getContent());
+    }
+}
+
+QPID_AUTO_TEST_CASE(testLVQPushBatch){
+    // A transaction's enqueues onto an LVQ replace earlier messages with
+    // the same key, including ones in the same transaction.
+    QueueSettings settings;
+    string key="key";
+    settings.lvqKey = key;
+    QueueFactory factory;
+    Queue::shared_ptr q(factory.create("my-queue", settings));
+    qpid::types::Variant::Map properties;
+    properties[key] = "a";
+    q->deliver(MessageUtils::createMessage(properties, "1"));
+
+    TxBuffer txn;
+    const char* values[] = { "b", "a", "b", "c" };
+    for (size_t i = 0; i < sizeof(values)/sizeof(values[0]); ++i) {
+        properties[key] = values[i];
+        q->deliver(MessageUtils::createMessage(properties, boost::lexical_cast<string>(i+2)), &txn);
+    }
+    BOOST_CHECK_EQUAL(q->getMessageCount(), 1u);
+    BOOST_CHECK(txn.prepare(0));
+    txn.commit();
+    BOOST_CHECK_EQUAL(q->getMessageCount(), 3u);
+
+    TestConsumer::shared_ptr c(new TestConsumer("test", true));
+    const char* expected[] = { "3", "4", "5" };
+    for (size_t i = 0; i < sizeof(expected)/sizeof(expected[0]); ++i) {
+        BOOST_CHECK(q->dispatch(c));
+        BOOST_CHECK_EQUAL(std::string(expected[i]), c->lastMessage.getContent());
+    }
+}
+
 void addMessagesToQueue(uint count, Queue& queue, uint oddTtl = 200, uint evenTtl = 0)
 {
     for (uint i = 0; i < count; i++) {
@@ -0,0 +1,152 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "qpid/ha/types.h"
+#include "qpid/framing/Buffer.h"
+#include "qpid/Exception.h"
+#include "unit_test.h"
+#include <vector>
+
+namespace qpid {
+namespace tests {
+
+QPID_AUTO_TEST_SUITE(ReplicationIdSummaryTestSuite)
+
+using namespace qpid::ha;
+using qpid::framing::Buffer;
+
+namespace {
+
+// Encodes the set, checks encodedSize, decodes it again and returns the
+// type octet so tests can check which encoding was chosen.
+char roundTrip(const ReplicationIdSet& ids)
+{
+    ReplicationIdSummary summary(ids);
+    std::vector<char> data(summary.encodedSize());
+    Buffer out(&data[0], data.size());
+    summary.encode(out);
+    BOOST_CHECK_EQUAL(out.getPosition(), data.size());
+
+    ReplicationIdSummary decoded;
+    Buffer in(&data[0], data.size());
+    decoded.decode(in);
+    BOOST_CHECK_EQUAL(in.getPosition(), data.size());
+    BOOST_CHECK_EQUAL(decoded.getIds(), ids);
+    return data[0];
+}
+
+}
+
+QPID_AUTO_TEST_CASE(testEmpty)
+{
+    ReplicationIdSet ids;
+    BOOST_CHECK_EQUAL(ReplicationIdSummary(ids).encodedSize(), 1u);
+    BOOST_CHECK_EQUAL(roundTrip(ids), 0);
+}
+
+QPID_AUTO_TEST_CASE(testSingle)
+{
+    ReplicationIdSet ids;
+    ids.add(ReplicationId(42));
+    roundTrip(ids);
+    ids.clear();
+    ids.add(ReplicationId(0xffffffff));
+    roundTrip(ids);
+}
+
+QPID_AUTO_TEST_CASE(testSparse)
+{
+    // Gaps and sizes around the varint octet boundaries
+    ReplicationIdSet ids;
+    ids.add(ReplicationId(1));
+    ids.add(ReplicationId(129), ReplicationId(256));
+    ids.add(ReplicationId(16640), ReplicationId(16640+16383));
+    ids.add(ReplicationId(5000000));
+    ids.add(ReplicationId(3000000000u), ReplicationId(3000000127u));
+    BOOST_CHECK_EQUAL(roundTrip(ids), 'r');
+}
+
+QPID_AUTO_TEST_CASE(testDenseContiguous)
+{
+    ReplicationIdSet ids;
+    ids.add(ReplicationId(1000), ReplicationId(1000000));
+    BOOST_CHECK_EQUAL(roundTrip(ids), 'r');
+    // One range costs a handful of bytes however long it is
+    BOOST_CHECK(ReplicationIdSummary(ids).encodedSize() < 16);
+}
+
+QPID_AUTO_TEST_CASE(testDenseFragmented)
+{
+    // Every other ID, as left by out-of-order dequeues
+    ReplicationIdSet ids;
+    for (uint32_t i = 100; i < 1100; i += 2) ids.add(ReplicationId(i));
+    BOOST_CHECK_EQUAL(roundTrip(ids), 'b');
+    BOOST_CHECK(ReplicationIdSummary(ids).encodedSize() < 1 + 8 + 1000/8 + 1);
+
+    // Span not a multiple of 8, ending on a set bit
+    ids.clear();
+    for (uint32_t i = 7; i <= 7+2*60; i += 2) ids.add(ReplicationId(i));
+    ids.add(ReplicationId(130), ReplicationId(131));
+    BOOST_CHECK_EQUAL(roundTrip(ids), 'b');
+}
+
+QPID_AUTO_TEST_CASE(testWrapAround)
+{
+    // A single range across the wrap
+    ReplicationIdSet ids;
+    ids.add(ReplicationId(0xfffffff0), ReplicationId(0x10));
+    BOOST_CHECK_EQUAL(roundTrip(ids), 'r');
+
+    // Sparse ranges either side of the wrap
+    ids.clear();
+    ids.add(ReplicationId(0xffff0000), ReplicationId(0xffff00ff));
+    ids.add(ReplicationId(0xfffffffe));
+    ids.add(ReplicationId(3), ReplicationId(5));
+    ids.add(ReplicationId(70000));
+    BOOST_CHECK_EQUAL(roundTrip(ids), 'r');
+
+    // Fragmented IDs across the wrap, encoded as a bitmap
+    ids.clear();
+    for (uint32_t i = 0xffffff00; i != 0x100; i += 2) ids.add(ReplicationId(i));
+    BOOST_CHECK_EQUAL(roundTrip(ids), 'b');
+}
+
+QPID_AUTO_TEST_CASE(testInvalid)
+{
+    char unknown[] = { 'x' };
+    Buffer b1(unknown, sizeof(unknown));
+    ReplicationIdSummary summary;
+    BOOST_CHECK_THROW(summary.decode(b1), qpid::Exception);
+
+    // Bitmap claims more bits than there are bytes
+    char bitmap[] = { 'b', 0, 0, 0, 1, 0, 0, 1, 0, char(0xff) };
+    Buffer b2(bitmap, sizeof(bitmap));
+    BOOST_CHECK_THROW(summary.decode(b2), qpid::Exception);
+
+    // Varint with no final octet
+    char ranges[] = { 'r', char(0x80), char(0x80), char(0x80), char(0x80), char(0x80) };
+    Buffer b3(ranges, sizeof(ranges));
+    BOOST_CHECK_THROW(summary.decode(b3), qpid::Exception);
+}
+
+QPID_AUTO_TEST_SUITE_END()
+
+}} // namespace qpid::tests
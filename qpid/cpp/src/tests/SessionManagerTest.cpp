@@ -0,0 +1,77 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+#include "qpid/broker/SessionManager.h"
+#include "qpid/broker/SessionHandler.h"
+#include "qpid/broker/SessionState.h"
+#include "qpid/broker/amqp_0_10/Connection.h"
+#include "qpid/sys/ConnectionOutputHandler.h"
+#include "qpid/sys/SecuritySettings.h"
+#include "qpid/sys/Time.h"
+#include "unit_test.h"
+#include "BrokerFixture.h"
+#include <memory>
+
+using namespace qpid::broker;
+
+namespace qpid {
+namespace tests {
+
+QPID_AUTO_TEST_SUITE(SessionManagerTestSuite)
+
+namespace {
+struct NullOutput : public sys::ConnectionOutputHandler
+{
+    void close() {}
+    void abort() {}
+    void connectionEstablished() {}
+    void activateOutput() {}
+    void handle(framing::AMQFrame&) {}
+};
+}
+
+QPID_AUTO_TEST_CASE(testForceAttachDetachTwice)
+{
+    BrokerFixture fix;
+    NullOutput out;
+    broker::amqp_0_10::Connection connection(&out, *fix.broker, "test", sys::SecuritySettings());
+    SessionHandler handler(connection, 1);
+    SessionManager& manager = fix.broker->getSessionManager();
+    SessionId id("user", "session");
+
+    // Force-attaching leaves two sessions with the same id, both detach.
+    std::auto_ptr<broker::SessionState> older = manager.attach(handler, id, false);
+    std::auto_ptr<broker::SessionState> newer = manager.attach(handler, id, true);
+    // broker::SessionState ignores client timeouts, set them directly.
+    older->qpid::SessionState::setTimeout(1);
+    newer->qpid::SessionState::setTimeout(60);
+    broker::SessionState* expected = newer.get();
+    manager.detach(older);
+    manager.detach(newer);
+
+    // Expiry of the older session must not lose the newer one.
+    sys::usleep(1100*1000);
+    std::auto_ptr<broker::SessionState> resumed = manager.attach(handler, id, false);
+    BOOST_CHECK_EQUAL(expected, resumed.get());
+}
+
+QPID_AUTO_TEST_SUITE_END()
+
+}} // namespace qpid::tests
@@ -21,11 +21,13 @@
  */
 #include "qpid/sys/Timer.h"
 #include "qpid/sys/Monitor.h"
+#include "qpid/sys/AtomicValue.h"
 #include "qpid/Options.h"
 #include "unit_test.h"
 #include <math.h>
 #include <iostream>
 #include <memory>
+#include <vector>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -128,6 +130,131 @@ QPID_AUTO_TEST_CASE(testGeneral)
     dynamic_pointer_cast<TestTask>(task4)->check(2);
 }
 
+class CountedTask : public TimerTask
+{
+    AtomicValue<uint32_t>& live;
+  public:
+    CountedTask(Duration timeout, AtomicValue<uint32_t>& l) : TimerTask(timeout, "Counted"), live(l) { ++live; }
+    ~CountedTask() { --live; }
+    void fire() {}
+};
+
+QPID_AUTO_TEST_CASE(testCancelReleasesTask)
+{
+    // Cancelling a task removes it from the Timer at once, without
+    // waiting for its time to come round, so the Timer's reference goes
+    // too. Use times that file tasks in every wheel.
+    const int count = 10000;
+    AtomicValue<uint32_t> live;
+    Counter counter;
+    Timer timer;
+    std::vector<intrusive_ptr<TimerTask> > tasks;
+    for (int i = 0; i < count; ++i) {
+        tasks.push_back(new CountedTask(Duration((i % 600 + 1) * TIME_SEC + i * TIME_MSEC), live));
+        timer.add(tasks.back());
+    }
+    for (int i = 0; i < count; i += 2) tasks[i]->restart();
+    intrusive_ptr<TestTask> task1(new TestTask(Duration(100 * TIME_MSEC), counter));
+    intrusive_ptr<TestTask> task2(new TestTask(Duration(300 * TIME_MSEC), counter));
+    timer.add(task2);
+    timer.add(task1);
+    for (int i = 0; i < count; ++i) tasks[i]->cancel();
+    tasks.clear();
+    BOOST_CHECK_EQUAL(live.get(), 0u);
+
+    task2->wait(Duration(2 * TIME_SEC));
+    task1->check(1, 100 * TIME_MSEC);
+    task2->check(2, 100 * TIME_MSEC);
+}
+
+QPID_AUTO_TEST_CASE(testCancelAfterTimerDestroyed)
+{
+    AtomicValue<uint32_t> live;
+    intrusive_ptr<TimerTask> task(new CountedTask(Duration(10 * TIME_SEC), live));
+    {
+        Timer timer;
+        timer.add(task);
+    }
+    task->cancel();
+    task = 0;
+    BOOST_CHECK_EQUAL(live.get(), 0u);
+}
+
+class OrderedTask : public TimerTask
+{
+    Mutex& lock;
+    std::vector<AbsTime>& fired;
+    AbsTime due;
+  public:
+    OrderedTask(AbsTime t, Mutex& l, std::vector<AbsTime>& f)
+        : TimerTask(t, "Ordered"), lock(l), fired(f), due(t) {}
+    void fire()
+    {
+        Mutex::ScopedLock l(lock);
+        fired.push_back(due);
+    }
+};
+
+QPID_AUTO_TEST_CASE(testOrdering)
+{
+    // Tasks fire in order of due time, including tasks due within the
+    // same tick and tasks added out of order. Cancelled ones don't fire.
+    const int count = 2000;
+    Mutex lock;
+    std::vector<AbsTime> fired;
+    Timer timer;
+    AbsTime start(now());
+    std::vector<intrusive_ptr<TimerTask> > tasks;
+    for (int i = 0; i < count; ++i) {
+        // Spread over 300ms in a scrambled order, several to each millisecond
+        Duration offset((50 + (i * 7919) % 300) * TIME_MSEC + (i * 104729) % TIME_MSEC);
+        tasks.push_back(new OrderedTask(AbsTime(start, offset), lock, fired));
+        timer.add(tasks.back());
+    }
+    for (int i = 0; i < count; i += 3) tasks[i]->cancel();
+    const size_t expected = count - (count + 2) / 3;
+
+    AbsTime deadline(now(), 5 * TIME_SEC);
+    for (;;) {
+        {
+            Mutex::ScopedLock l(lock);
+            if (fired.size() >= expected || now() > deadline) break;
+        }
+        qpid::sys::usleep(10 * 1000);
+    }
+    Mutex::ScopedLock l(lock);
+    BOOST_CHECK_EQUAL(fired.size(), expected);
+    for (size_t i = 1; i < fired.size(); ++i)
+        BOOST_CHECK_MESSAGE(!(fired[i] < fired[i-1]), "task " << i << " fired out of order");
+}
+
+class PeriodicTask : public TimerTask
+{
+    Timer& timer;
+  public:
+    PeriodicTask(Duration period, Timer& t) : TimerTask(period, "Periodic"), timer(t) {}
+    void fire()
+    {
+        setupNextFire();
+        timer.add(this);
+    }
+};
+
+QPID_AUTO_TEST_CASE(testLongTaskWithPeriodicTask)
+{
+    // A frequent periodic task keeps the finest wheel occupied; a longer
+    // task filed in a coarser wheel must still be cascaded down on time.
+    Counter counter;
+    Timer timer;
+    intrusive_ptr<PeriodicTask> periodic(new PeriodicTask(Duration(50 * TIME_MSEC), timer));
+    intrusive_ptr<TestTask> task(new TestTask(Duration(1 * TIME_SEC), counter));
+    timer.add(periodic);
+    timer.add(task);
+    task->wait(Duration(3 * TIME_SEC));
+    periodic->cancel();
+    task->check(1, 100 * TIME_MSEC);
+}
+
 std::string toString(Duration d) { return boost::lexical_cast<std::string>(d); }
 Duration fromString(const std::string& str) { return boost::lexical_cast<Duration>(str); }
 
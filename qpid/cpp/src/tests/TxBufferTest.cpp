@@ -183,6 +183,34 @@ QPID_AUTO_TEST_CASE(testBufferIsClearedAfterCommit)
     opB->check();
 }
 
+QPID_AUTO_TEST_CASE(testEnlistWithKey)
+{
+    MockTxOp::shared_ptr opA(new MockTxOp());
+    opA->expectCommit();
+    MockTxOp::shared_ptr opB(new MockTxOp());
+    opB->expectCommit();
+    MockTxOp::shared_ptr opC(new MockTxOp());
+    opC->expectCommit();
+    int a, b;
+
+    TxBuffer buffer;
+    buffer.enlist(static_pointer_cast<TxOp>(opA), &a);
+    buffer.enlist(static_pointer_cast<TxOp>(opB), &b);
+    BOOST_CHECK(buffer.getEnlisted(&a) == opA);
+    BOOST_CHECK(buffer.getEnlisted(&b) == opB);
+    // An unkeyed op ends collection, later work must not move before it.
+    buffer.enlist(static_pointer_cast<TxOp>(opC));
+    BOOST_CHECK(!buffer.getEnlisted(&a));
+    BOOST_CHECK(!buffer.getEnlisted(&b));
+    buffer.enlist(static_pointer_cast<TxOp>(opA), &a);
+    BOOST_CHECK(buffer.getEnlisted(&a) == opA);
+
+    buffer.commit();
+    BOOST_CHECK(!buffer.getEnlisted(&a));
+    opB->check();
+    opC->check();
+}
+
 QPID_AUTO_TEST_SUITE_END()
 
 }} // namespace qpid::tests
@@ -829,6 +829,73 @@ QPID_AUTO_TEST_CASE(described)
     BOOST_CHECK(!a.isDescribed());
 }
 
+QPID_AUTO_TEST_CASE(testAssignFromContents)
+{
+    Variant::Map inner;
+    inner["s"] = "a string long enough not to fit in any small buffer";
+    Variant::List list;
+    list.push_back(inner);
+    Variant v(list);
+    v = v;
+    BOOST_CHECK_EQUAL(VAR_LIST, v.getType());
+    v = v.asList().front();
+    BOOST_CHECK_EQUAL(VAR_MAP, v.getType());
+    BOOST_CHECK_EQUAL(inner, v.asMap());
+    v = v.asMap()["s"];
+    BOOST_CHECK_EQUAL(VAR_STRING, v.getType());
+    BOOST_CHECK_EQUAL(inner["s"].getString(), v.getString());
+    v = "short";
+    BOOST_CHECK_EQUAL(std::string("short"), v.getString());
+    Variant copy(v);
+    BOOST_CHECK_EQUAL(v, copy);
+    Variant empty;
+    Variant emptyCopy(empty);
+    BOOST_CHECK(emptyCopy.isVoid());
+}
+
+QPID_AUTO_TEST_CASE(testSelfAssignString)
+{
+    const std::string text("a string long enough not to fit in any small buffer");
+    const std::string encoding("an encoding long enough not to fit in any small buffer");
+
+    // From the variant's own string
+    Variant v(text);
+    v = v.getString();
+    BOOST_CHECK_EQUAL(text, v.getString());
+    v = v.getString().c_str();
+    BOOST_CHECK_EQUAL(text, v.getString());
+
+    // From a string inside the map or list being replaced
+    Variant::Map map;
+    map["s"] = text;
+    v = map;
+    v = v.asMap()["s"].getString().c_str();
+    BOOST_CHECK_EQUAL(VAR_STRING, v.getType());
+    BOOST_CHECK_EQUAL(text, v.getString());
+    Variant::List list;
+    list.push_back(text);
+    v = list;
+    v = v.asList().front().getString().c_str();
+    BOOST_CHECK_EQUAL(text, v.getString());
+    v = list;
+    v = v.asList().front().getString();
+    BOOST_CHECK_EQUAL(text, v.getString());
+
+    // From the variant's own encoding, which assignment clears
+    v.setEncoding(encoding);
+    v = v.getEncoding();
+    BOOST_CHECK_EQUAL(encoding, v.getString());
+    BOOST_CHECK_EQUAL(std::string(), v.getEncoding());
+    v.setEncoding(encoding);
+    v = v.getEncoding().c_str();
+    BOOST_CHECK_EQUAL(encoding, v.getString());
+    BOOST_CHECK_EQUAL(std::string(), v.getEncoding());
+    v = 1;
+    v.setEncoding(encoding);
+    v = v.getEncoding().c_str();
+    BOOST_CHECK_EQUAL(encoding, v.getString());
+}
+
 QPID_AUTO_TEST_SUITE_END()
 
 }} // namespace qpid::tests
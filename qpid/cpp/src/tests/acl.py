@@ -2094,6 +2094,50 @@ class ACLTests(TestBase010):
         self.LookupPublish("joe@QPID", "", "unrestricted", "deny")
 
 
+    def test_publish_acl_reload_same_session(self):
+        """
+        Test that publish decisions made for a session are not reused once
+        the acl file is reloaded
+        """
+        aclf = self.get_acl_file()
+        aclf.write('acl allow bob@QPID publish exchange name=amq.direct routingkey=rk1\n')
+        aclf.write('acl allow anonymous all all \n')
+        aclf.write('acl deny all all')
+        aclf.close()
+
+        result = self.reload_acl()
+        if (result):
+            self.fail(result)
+
+        session = self.get_session('bob','bob')
+        props = session.delivery_properties(routing_key="rk1")
+
+        try:
+            session.message_transfer(destination="amq.direct", message=Message(props,"Test"))
+            session.message_transfer(destination="amq.direct", message=Message(props,"Test"))
+            session.sync()
+        except qpid.session.SessionException, e:
+            if (403 == e.args[0].error_code):
+                self.fail("ACL should allow message transfer to exchange amq.direct with routing key rk1");
+
+        aclf = self.get_acl_file()
+        aclf.write('acl deny bob@QPID publish exchange name=amq.direct routingkey=rk1\n')
+        aclf.write('acl allow anonymous all all \n')
+        aclf.write('acl allow all all')
+        aclf.close()
+
+        result = self.reload_acl()
+        if (result):
+            self.fail(result)
+
+        try:
+            session.message_transfer(destination="amq.direct", message=Message(props,"Test"))
+            session.sync()
+            self.fail("ACL should deny message transfer to name=amq.direct routingkey=rk1 after reload");
+        except qpid.session.SessionException, e:
+            self.assertEqual(403,e.args[0].error_code)
+
+
    #=====================================
    # ACL broker configuration tests
    #=====================================
@@ -0,0 +1,79 @@
+#!/usr/bin/env python
+
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+
+# Tests for broker authentication handling under load.
+
+import os, shutil, sys
+from threading import Thread
+from brokertest import *
+from qpid.harness import Skipped
+
+class AuthWorkersTest(BrokerTest):
+    """
+    Test authentication with SASL steps offloaded to --auth-workers
+    threads and connections accepted on several --accept-sockets.
+    """
+
+    def setUp(self):
+        BrokerTest.setUp(self)
+        self.args = ["--auth-workers", "2", "--accept-sockets", "4"]
+        self.credentials = {"username":"zig", "password":"zig", "sasl_mechanisms":"PLAIN"}
+        # The SASL test configuration is only generated by builds with SASL,
+        # without it the broker can't authenticate and accepts any client.
+        sasl_config = os.path.join(self.rootdir, "sasl_config")
+        self.sasl = os.path.exists(sasl_config)
+        if self.sasl: self.args += ["--auth", "yes", "--sasl-config", sasl_config]
+
+    def connect_all(self, broker, count):
+        """Connect count clients at once, return the errors they got."""
+        errors = []
+        def client():
+            try:
+                c = broker.connect(**self.credentials)
+                try: c.session().sender("amq.fanout").send("x")
+                finally: c.close()
+            except Exception, e:
+                errors.append(e)
+        threads = [Thread(target=client) for i in xrange(count)]
+        for t in threads: t.start()
+        for t in threads: t.join()
+        return errors
+
+    def test_concurrent_connects(self):
+        """Every client authenticates when many connect at once."""
+        b = self.broker(self.args)
+        errors = self.connect_all(b, 50)
+        self.assertEqual([], errors)
+        b.ready()
+
+    def test_bad_password(self):
+        """A failed offloaded authentication closes only that connection."""
+        if not self.sasl: raise Skipped("No SASL test configuration.")
+        b = self.broker(self.args)
+        try:
+            b.connect(username="zig", password="wrong", sasl_mechanisms="PLAIN")
+            self.fail("Expected authentication failure")
+        except Exception: pass
+        self.assertEqual([], self.connect_all(b, 10))
+
+if __name__ == "__main__":
+    shutil.rmtree("brokertest.tmp", True)
+    os.execvp("qpid-python-test",
+              ["qpid-python-test", "-m", "authentication_tests"] + sys.argv[1:])
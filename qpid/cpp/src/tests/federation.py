@@ -190,6 +190,68 @@ class FederationTests(TestBase010):
 
         self.verify_cleanup()
 
+    def test_link_stripes(self):
+        """ Routes declared on a link of a broker started with
+        --link-stripes are spread over parallel stripe links.
+        """
+        if not self.defines.get("striped-port"): return
+        striped_port = int(self.defines["striped-port"])
+        self.startQmf()
+        s_broker = self.qmf.addBroker("%s:%d" % (self.broker.host, striped_port))
+        try:
+            broker = self.qmf.getObjects(_class="broker", _broker=s_broker)[0]
+            link_args = {"host":self.remote_host(), "port":self.remote_port(), "durable":False,
+                         "authMechanism":"PLAIN", "username":"guest", "password":"guest",
+                         "transport":"tcp"}
+            result = broker.create("link", "test-striped-link", link_args, False)
+            self.assertEqual(result.status, 0, result)
+            for key in ["key-1", "key-2"]:
+                bridge_args = {"link":"test-striped-link", "src":"amq.direct", "dest":"amq.fanout",
+                               "key":key}
+                result = broker.create("bridge", "test-striped-bridge-" + key, bridge_args, False)
+                self.assertEqual(result.status, 0, result)
+
+            links = self.qmf.getObjects(_class="link", _broker=s_broker)
+            self.assertEqual(sorted([l.name for l in links]),
+                             ["test-striped-link", "test-striped-link.stripe-1"])
+            bridges = self.qmf.getObjects(_class="bridge", _broker=s_broker)
+            self.assertEqual(len(bridges), 2)
+            self.assertNotEqual(bridges[0].linkRef, bridges[1].linkRef)
+
+            #setup queue to receive messages from both routes
+            s_conn = self.connect(host=self.broker.host, port=striped_port)
+            s_session = s_conn.session("test_link_stripes")
+            s_session.queue_declare(queue="fed1", exclusive=True, auto_delete=True)
+            s_session.exchange_bind(queue="fed1", exchange="amq.fanout")
+            self.subscribe(session=s_session, queue="fed1", destination="f1")
+            queue = s_session.incoming("f1")
+            sleep(6)
+
+            r_conn = self.connect(host=self.remote_host(), port=self.remote_port())
+            r_session = r_conn.session("test_link_stripes")
+            for i in range(1, 11):
+                dp = r_session.delivery_properties(routing_key="key-%d" % (i % 2 + 1))
+                r_session.message_transfer(destination="amq.direct", message=Message(dp, "Message %d" % i))
+
+            received = []
+            for i in range(1, 11):
+                received.append(queue.get(timeout=5).body)
+            self.assertEqual(sorted(received), sorted(["Message %d" % i for i in range(1, 11)]))
+
+            # Deleting the link closes its stripe too
+            result = broker.delete("link", "test-striped-link", {})
+            self.assertEqual(result.status, 0, result)
+            attempts = 0
+            while self.qmf.getObjects(_class="link", _broker=s_broker) or \
+                  self.qmf.getObjects(_class="bridge", _broker=s_broker):
+                attempts += 1
+                if attempts >= 10: self.fail("Striped links didn't clean up")
+                sleep(1)
+            s_conn.close()
+            r_conn.close()
+        finally:
+            self.qmf.delBroker(s_broker)
+
     def test_push_to_exchange(self):
         session = self.session
         
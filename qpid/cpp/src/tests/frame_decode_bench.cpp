@@ -0,0 +1,168 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+// Microbenchmark for 0-10 input decoding: FrameDecoder on message
+// transfers read in fixed size chunks, and Buffer integer get/put.
+
+#include "qpid/Options.h"
+#include "qpid/framing/AMQContentBody.h"
+#include "qpid/framing/AMQFrame.h"
+#include "qpid/framing/AMQHeaderBody.h"
+#include "qpid/framing/Buffer.h"
+#include "qpid/framing/FrameDecoder.h"
+#include "qpid/framing/MessageTransferBody.h"
+#include "qpid/framing/ProtocolVersion.h"
+#include "qpid/sys/Time.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace qpid {
+namespace tests {
+
+using namespace qpid::framing;
+
+struct Args : public qpid::Options
+{
+    uint messages;
+    uint size;
+    uint readSize;
+    uint iterations;
+    bool help;
+
+    Args() : qpid::Options("Frame decode benchmark"),
+             messages(10000), size(64), readSize(65536), iterations(10), help(false)
+    {
+        addOptions()
+            ("messages", qpid::optValue(messages, "N"), "messages (3 frames each) per iteration")
+            ("size", qpid::optValue(size, "N"), "message content size")
+            ("read-size", qpid::optValue(readSize, "N"), "bytes handed to the decoder per read")
+            ("iterations", qpid::optValue(iterations, "N"), "times to decode the input")
+            ("help", qpid::optValue(help), "print this usage statement");
+    }
+
+    bool parse(int argc, char** argv) {
+        try {
+            qpid::Options::parse(argc, argv);
+            if (readSize == 0) throw qpid::Options::Exception("read-size must be greater than 0");
+            if (help) {
+                std::cerr << *this << std::endl << std::endl;
+            } else {
+                return true;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << *this << std::endl << std::endl << e.what() << std::endl;
+        }
+        return false;
+    }
+};
+
+double seconds(sys::AbsTime start) {
+    return double(sys::Duration(start, sys::now()))/sys::TIME_SEC;
+}
+
+void encode(std::vector<char>& out, const AMQFrame& frame) {
+    size_t offset = out.size();
+    out.resize(offset + frame.encodedSize());
+    Buffer b(&out[offset], frame.encodedSize());
+    frame.encode(b);
+}
+
+/** Encode a stream of message transfers. */
+std::vector<char> transfers(const Args& args) {
+    std::vector<char> out;
+    MessageTransferBody transfer(ProtocolVersion(), "amq.direct", 0, 0);
+    AMQHeaderBody header;
+    header.get<MessageProperties>(true)->setContentLength(args.size);
+    header.get<DeliveryProperties>(true)->setRoutingKey("key");
+    AMQContentBody content(std::string(args.size, 'x'));
+    for (uint i = 0; i < args.messages; ++i) {
+        encode(out, AMQFrame(transfer));
+        encode(out, AMQFrame(header));
+        encode(out, AMQFrame(content));
+    }
+    return out;
+}
+
+void decodeFrames(const Args& args) {
+    std::vector<char> input = transfers(args);
+    uint64_t frames = 0;
+    sys::AbsTime start = sys::now();
+    for (uint i = 0; i < args.iterations; ++i) {
+        FrameDecoder decoder;
+        for (size_t offset = 0; offset < input.size(); offset += args.readSize) {
+            Buffer b(&input[offset], std::min(size_t(args.readSize), input.size() - offset));
+            while (decoder.decode(b)) ++frames;
+        }
+    }
+    double secs = seconds(start);
+    std::cout << "FrameDecoder: " << frames << " frames, "
+              << uint64_t(frames/secs) << " frames/s, "
+              << uint64_t(double(input.size())*args.iterations/secs/1000000) << " MB/s"
+              << std::endl;
+    if (frames != uint64_t(args.messages)*3*args.iterations)
+        throw std::runtime_error("wrong number of frames decoded");
+}
+
+void integers(const Args& args) {
+    const uint32_t count = 8192;
+    std::vector<char> data(count*14);
+    uint64_t sum = 0;
+    sys::AbsTime start = sys::now();
+    for (uint i = 0; i < args.iterations*100; ++i) {
+        Buffer out(&data[0], data.size());
+        for (uint32_t j = 0; j < count; ++j) {
+            out.putShort(uint16_t(j));
+            out.putLong(j);
+            out.putLongLong(uint64_t(j) << 32);
+        }
+        Buffer in(&data[0], data.size());
+        for (uint32_t j = 0; j < count; ++j) {
+            sum += in.getShort();
+            sum += in.getLong();
+            sum += in.getLongLong();
+        }
+    }
+    double secs = seconds(start);
+    // Print sum so the loops can't be optimised away.
+    std::cout << "Buffer: " << uint64_t(count*6.0*args.iterations*100/secs)
+              << " integer get/put per second (checksum " << sum << ")" << std::endl;
+}
+
+}} // namespace qpid::tests
+
+using namespace qpid::tests;
+
+int main(int argc, char** argv)
+{
+    Args args;
+    if (!args.parse(argc, argv)) return 1;
+    try {
+        decodeFrames(args);
+        integers(args);
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return 1;
+}
@@ -278,6 +278,46 @@ class ReplicationTests(HaBrokerTest):
         sender.stop()
         receiver.stop()
 
+    def test_replication_batch(self):
+        """Verify --ha-replication-batch: a partial batch is acknowledged
+        without waiting for it to fill, dequeues in the middle of a batch are
+        replicated, and no messages are lost if the primary fails while a
+        batch is outstanding. Batch size 1 acknowledges each message."""
+        for batch in [1, 10, 0]:
+            cluster = HaCluster(self, 3, args=["--ha-replication-batch=%s"%batch])
+            q = "q%s"%batch
+            s = cluster[0].connect().session()
+            # Synchronous sends only complete when the backups acknowledge.
+            sender = s.sender(q+";{create:always}")
+            first = [str(i) for i in xrange(batch/2+1)] # Less than a batch
+            for m in first: sender.send(qm.Message(m))
+            for b in cluster[1:]: b.assert_browse_backup(q, first)
+            more = [str(i) for i in xrange(len(first), batch+3)] # Fill it and start another
+            for m in more: sender.send(qm.Message(m))
+            msgs = first + more
+            self.assertEqual(msgs[0], s.receiver(q).fetch(timeout=1).content)
+            s.acknowledge()
+            for b in cluster[1:]: b.assert_browse_backup(q, msgs[1:])
+
+            # Fail over while messages are streaming to the primary.
+            fq = "fq%s"%batch
+            sender = NumberedSender(cluster[0], url=cluster.url, queue=fq,
+                                    connection_options="reconnect:true,protocol:'amqp0-10'")
+            sender.start()
+            def depth(b):
+                queue = b.agent.getQueue(fq)
+                return queue and queue.msgDepth or 0
+            assert retry(lambda: depth(cluster[0]) > 100)
+            cluster.kill(0)
+            n = depth(cluster[1])
+            assert retry(lambda: depth(cluster[1]) > n + 100)
+            sender.stop()
+            receiver = NumberedReceiver(cluster[1], url=cluster.url, queue=fq,
+                                        connection_options="reconnect:true,protocol:'amqp0-10'")
+            receiver.start()
+            receiver.stop()
+            self.assertEqual(sender.sent, receiver.received)
+
     def test_backup_failover(self):
         """Verify that a backup broker fails over and recovers queue state"""
         brokers = HaCluster(self, 3)
@@ -290,6 +330,24 @@ class ReplicationTests(HaBrokerTest):
         s.acknowledge()
         brokers[2].assert_browse_backup("q", ["b"])
 
+    def test_fast_resync(self):
+        """Verify that backups using fast resync recover queue state on failover"""
+        brokers = HaCluster(self, 3, args=["--ha-fast-resync=yes"])
+        s = brokers[0].connect().session()
+        sender = s.sender("q;{create:always}")
+        for m in ["a","b","c","d"]: sender.send(m)
+        r = s.receiver("q")
+        self.assertEqual("a", r.fetch().content)
+        s.acknowledge()
+        brokers[2].assert_browse_backup("q", ["b","c","d"])
+        brokers.kill(0)
+        brokers[1].connect().session().sender("q").send("e")
+        brokers[2].assert_browse_backup("q", ["b","c","d","e"])
+        s = brokers[1].connect().session()
+        self.assertEqual("b", s.receiver("q").fetch().content)
+        s.acknowledge()
+        brokers[2].assert_browse_backup("q", ["c","d","e"])
+
     def test_empty_backup_failover(self):
         """Verify that a new primary becomes active with no queues.
         Regression test for QPID-5430"""
@@ -894,6 +952,51 @@ acl deny all all
         a.delQueue("q")
         a.addQueue("q")
 
+    def test_catchup_scheduler(self):
+        """Verify that a backup catches up all queues when only one queue at a
+        time may catch up, at a limited rate."""
+        cluster = HaCluster(self, 1, args=["--ha-catchup-queues=1",
+                                           "--ha-catchup-rate=1000000"])
+        s = cluster[0].connect().session()
+        queues = ["q%s"%i for i in xrange(5)]
+        for q in queues:
+            sender = s.sender(q+";{create:always}")
+            for i in xrange(10): sender.send(qm.Message("%s-%s"%(q,i)))
+        cluster.start()
+        cluster[1].wait_status("ready")
+        for q in queues:
+            cluster[1].assert_browse_backup(q, ["%s-%s"%(q,i) for i in xrange(10)])
+
+    def test_catchup_large_messages(self):
+        """Verify that messages larger than a queue's share of the rate per
+        tick are replicated without a catch-up timeout to release them."""
+        cluster = HaCluster(self, 1, args=["--ha-catchup-queues=2",
+                                           "--ha-catchup-rate=10000",
+                                           "--ha-catchup-timeout=0"])
+        s = cluster[0].connect().session()
+        big = "x"*2000          # Twice each queue's share per tick.
+        for q in ["a", "b"]:
+            sender = s.sender(q+";{create:always}")
+            for i in xrange(3): sender.send(qm.Message(big))
+        cluster.start()
+        cluster[1].wait_status("ready", timeout=20)
+        for q in ["a", "b"]: cluster[1].assert_browse_backup(q, [big]*3)
+
+    def test_catchup_timeout(self):
+        """Verify that catch-up completes with a --ha-catchup-timeout shorter
+        than the rate limit takes to send the backlog."""
+        cluster = HaCluster(self, 1, args=["--ha-catchup-queues=1",
+                                           "--ha-catchup-rate=1000",
+                                           "--ha-catchup-timeout=1"])
+        s = cluster[0].connect().session()
+        big = "x"*1000
+        for q in ["a", "b"]:
+            sender = s.sender(q+";{create:always}")
+            for i in xrange(3): sender.send(qm.Message(big))
+        cluster.start()
+        cluster[1].wait_status("ready", timeout=20)
+        for q in ["a", "b"]: cluster[1].assert_browse_backup(q, [big]*3)
+
 def fairshare(msgs, limit, levels):
     """
     Generator to return prioritised messages in expected order for a given fairshare limit
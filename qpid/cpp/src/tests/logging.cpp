@@ -17,11 +17,15 @@
  */
 
 #include "test_tools.h"
+#include "qpid/log/BinaryTrace.h"
 #include "qpid/log/Logger.h"
 #include "qpid/log/Options.h"
 #include "qpid/log/OstreamOutput.h"
 #include "qpid/memory.h"
 #include "qpid/Options.h"
+#include "qpid/sys/Monitor.h"
+#include "qpid/sys/Runnable.h"
+#include "qpid/sys/Thread.h"
 #if defined (_WIN32)
 #  include "qpid/log/windows/SinkOptions.h"
 #else
@@ -211,6 +215,128 @@ QPID_AUTO_TEST_CASE(testOstreamOutput) {
     BOOST_CHECK_EQUAL("foo\nbar\nbaz\n", os.str());
 }
 
+void configureAsync(Logger& l, const char* overflow, const char* buffer) {
+    const char* argv[]={
+        0,
+        "--log-to-stderr", "no",
+        "--log-async", "yes",
+        "--log-async-buffer", buffer,
+        "--log-async-overflow", overflow
+    };
+    qpid::log::Options opts("");
+    opts.parse(sizeof(argv)/sizeof(char*), const_cast<char**>(argv));
+    l.configure(opts);
+    l.format(0);
+    l.select(Selector(debug));
+}
+
+struct AsyncLogging : public qpid::sys::Runnable {
+    Logger& logger;
+    int id;
+    AsyncLogging(Logger& l, int i) : logger(l), id(i) {}
+    void run() {
+        Statement s=QPID_LOG_STATEMENT_INIT(debug);
+        for (int i = 0; i < 1000; ++i)
+            logger.log(s, (format("%d %d") % id % i).str());
+    }
+};
+
+QPID_AUTO_TEST_CASE(testAsyncOutput) {
+    Logger l;
+    configureAsync(l, "block", "8");
+    TestOutput* out=new TestOutput(l);
+
+    boost::ptr_vector<AsyncLogging> loggers;
+    vector<qpid::sys::Thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        loggers.push_back(new AsyncLogging(l, i));
+        threads.push_back(qpid::sys::Thread(loggers.back()));
+    }
+    for (int i = 0; i < 4; ++i) threads[i].join();
+    l.flush();
+
+    // Nothing lost with the block policy, each thread's messages in order.
+    BOOST_REQUIRE_EQUAL(4000u, out->msg.size());
+    vector<int> next(4, 0);
+    for (size_t i = 0; i < out->msg.size(); ++i) {
+        int id, n;
+        istringstream(out->msg[i]) >> id >> n;
+        BOOST_CHECK_EQUAL(next.at(id)++, n);
+    }
+    l.clear();
+}
+
+// Holds up the first message until released.
+struct HeldOutput : public TestOutput {
+    qpid::sys::Monitor monitor;
+    bool held, released;
+    HeldOutput(Logger& l) : TestOutput(l), held(false), released(false) {}
+    void log(const Statement& s, const string& m) {
+        TestOutput::log(s, m);
+        qpid::sys::Monitor::ScopedLock l(monitor);
+        held = true;
+        monitor.notifyAll();
+        while (!released) monitor.wait();
+    }
+    void waitHeld() {
+        qpid::sys::Monitor::ScopedLock l(monitor);
+        while (!held) monitor.wait();
+    }
+    void release() {
+        qpid::sys::Monitor::ScopedLock l(monitor);
+        released = true;
+        monitor.notifyAll();
+    }
+};
+
+QPID_AUTO_TEST_CASE(testAsyncOverflowCount) {
+    Logger l;
+    configureAsync(l, "count", "4");
+    HeldOutput* out=new HeldOutput(l);
+    Statement s=QPID_LOG_STATEMENT_INIT(debug);
+
+    l.log(s, "first");
+    out->waitHeld();
+    // The writer is stuck on the first message: 4 fit in the ring, 16 overflow.
+    for (int i = 0; i < 20; ++i)
+        l.log(s, "more");
+    out->release();
+    l.flush();
+
+    // The drop count is reported as soon as the writer is free again.
+    BOOST_REQUIRE_EQUAL(6u, out->msg.size());
+    BOOST_CHECK_EQUAL("first\n", out->msg[0]);
+    BOOST_CHECK(contains(out->msg[1], "16 log messages dropped"));
+    BOOST_CHECK_EQUAL("more\n", out->last());
+    l.clear();
+}
+
+QPID_AUTO_TEST_CASE(testAsyncReconfigure) {
+    Logger l;
+    configureAsync(l, "block", "8");
+
+    // Replace the writer while other threads are logging through it.
+    boost::ptr_vector<AsyncLogging> loggers;
+    vector<qpid::sys::Thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        loggers.push_back(new AsyncLogging(l, i));
+        threads.push_back(qpid::sys::Thread(loggers.back()));
+    }
+    for (int i = 0; i < 50; ++i)
+        configureAsync(l, i%2 ? "block" : "count", "8");
+    for (int i = 0; i < 4; ++i) threads[i].join();
+    l.flush();
+
+    // The writer left in place still writes and flushes.
+    TestOutput* out=new TestOutput(l);
+    Statement s=QPID_LOG_STATEMENT_INIT(debug);
+    l.log(s, "last");
+    l.flush();
+    BOOST_REQUIRE_EQUAL(1u, out->msg.size());
+    BOOST_CHECK_EQUAL("last\n", out->last());
+    l.clear();
+}
+
 #if 0 // This test requires manual intervention. Normally disabled.
 QPID_AUTO_TEST_CASE(testSyslogOutput) {
     Logger& l=Logger::instance();
@@ -458,6 +584,107 @@ QPID_AUTO_TEST_CASE(testQuoteNonPrintable) {
     unlink("logging.tmp");
 }
 
+void binaryTrace(const string& name, int n) {
+    QPID_LOG_BINARY(critical, "name={} n={}", << name << n, "name=" << name << " n=" << n);
+}
+
+QPID_AUTO_TEST_CASE(testBinaryTrace) {
+    Logger& l=Logger::instance();
+    ScopedSuppressLogging ls(l);
+    l.select(Selector(critical));
+    TestOutput* out=new TestOutput(l);
+
+    BinaryTrace::open("logging.tmp");
+    binaryTrace("foo", 42);
+    binaryTrace("bar", 43);
+    BinaryTrace::close();
+    BOOST_CHECK(out->msg.empty());
+
+    // Formatted as text when there is no binary trace file.
+    binaryTrace("baz", 44);
+    vector<string> expect=list_of("name=baz n=44\n");
+    BOOST_CHECK_EQUAL(expect, out->msg);
+
+    ifstream trace("logging.tmp", ios::in | ios::binary);
+    string bytes((istreambuf_iterator<char>(trace)), istreambuf_iterator<char>());
+    BOOST_CHECK_EQUAL(string("QPIDTRC\1"), bytes.substr(0, 8));
+    // The statement is defined once, followed by a record for each call.
+    BOOST_CHECK_EQUAL(bytes.find("name={} n={}"), bytes.rfind("name={} n={}"));
+    BOOST_CHECK(bytes.find("foo") < bytes.find("bar"));
+    BOOST_CHECK(contains(bytes, string("\0\0\0\0\0\0\0\x2b", 8)));
+    BOOST_CHECK(!contains(bytes, "baz"));
+    trace.close();
+    unlink("logging.tmp");
+}
+
+// Reads the records of a binary trace file whose arguments are all integers.
+struct TraceReader {
+    string bytes;
+    size_t pos;
+    TraceReader(const string& file) : pos(8) {
+        ifstream trace(file.c_str(), ios::in | ios::binary);
+        bytes.assign(istreambuf_iterator<char>(trace), istreambuf_iterator<char>());
+    }
+    uint8_t get8() { return uint8_t(bytes.at(pos++)); }
+    uint32_t get32() { uint32_t i = 0; for (int n = 0; n < 4; ++n) i = (i << 8) | get8(); return i; }
+    uint64_t get64() { uint64_t hi = get32(); return (hi << 32) | get32(); }
+    void skip() { pos += get32(); }
+
+    // Return the arguments of the next record, false at end of file.
+    bool next(vector<uint64_t>& args) {
+        args.clear();
+        while (pos < bytes.size()) {
+            if (get8() == 'D') {
+                get32(); get8(); get8(); skip(); get32(); skip(); skip();
+                continue;
+            }
+            get32(); get64(); get64();
+            for (uint8_t tag = get8(); tag != BinaryTrace::END; tag = get8())
+                args.push_back(get64());
+            return true;
+        }
+        return false;
+    }
+};
+
+struct BinaryTracing : public qpid::sys::Runnable {
+    int id;
+    BinaryTracing(int i) : id(i) {}
+    void run() {
+        for (int i = 0; i < 10000; ++i)
+            QPID_TRACE_BINARY(critical, "{} {}", << id << i);
+    }
+};
+
+QPID_AUTO_TEST_CASE(testBinaryTraceThreads) {
+    Logger& l=Logger::instance();
+    ScopedSuppressLogging ls(l);
+    l.select(Selector(critical));
+
+    BinaryTrace::open("logging.tmp");
+    boost::ptr_vector<BinaryTracing> tracers;
+    vector<qpid::sys::Thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        tracers.push_back(new BinaryTracing(i));
+        threads.push_back(qpid::sys::Thread(tracers.back()));
+    }
+    for (int i = 0; i < 4; ++i) threads[i].join();
+    BinaryTrace::close();
+
+    // Every record written, each thread's records in order.
+    TraceReader trace("logging.tmp");
+    vector<uint64_t> args;
+    vector<uint64_t> next(4, 0);
+    size_t records = 0;
+    while (trace.next(args)) {
+        BOOST_REQUIRE_EQUAL(2u, args.size());
+        BOOST_CHECK_EQUAL(next.at(args[0])++, args[1]);
+        ++records;
+    }
+    BOOST_CHECK_EQUAL(40000u, records);
+    unlink("logging.tmp");
+}
+
 QPID_AUTO_TEST_CASE(testSelectorElements) {
     SelectorElement s("debug");
     BOOST_CHECK_EQUAL(s.levelStr, "debug");
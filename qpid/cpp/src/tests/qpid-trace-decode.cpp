@@ -0,0 +1,284 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+/**
+ * Prints a binary trace file written by a broker or client run with
+ * --log-binary-trace as text, in the same form as the text log.
+ */
+
+#include "qpid/Options.h"
+#include "qpid/amqp/DataBuilder.h"
+#include "qpid/amqp/Decoder.h"
+#include "qpid/amqp/Descriptor.h"
+#include "qpid/framing/AMQFrame.h"
+#include "qpid/framing/Buffer.h"
+#include "qpid/log/BinaryTrace.h"
+#include "qpid/types/Variant.h"
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <time.h>
+#include <vector>
+
+using qpid::log::BinaryTrace;
+
+namespace qpid {
+namespace tests {
+
+struct Options : public qpid::Options {
+    bool help;
+    std::vector<std::string> files;
+    bool time, level, thread, source, category, sort;
+
+    Options() : qpid::Options("qpid-trace-decode options"),
+                help(false), time(true), level(true), thread(false), source(false), category(true),
+                sort(true)
+    {
+        addOptions()
+            ("file,f", qpid::optValue(files, "FILE"), "binary trace file to decode, may be repeated")
+            ("time", qpid::optValue(time, "yes|no"), "include time in output")
+            ("level", qpid::optValue(level, "yes|no"), "include severity level in output")
+            ("thread", qpid::optValue(thread, "yes|no"), "include thread ID in output")
+            ("source", qpid::optValue(source, "yes|no"), "include source file:line in output")
+            ("category", qpid::optValue(category, "yes|no"), "include category in output")
+            ("sort", qpid::optValue(sort, "yes|no"),
+             "print records in time order, reading the whole file first. "
+             "Each thread's records are written in batches so are not in time order in the file")
+            ("help", qpid::optValue(help), "print this usage statement");
+    }
+};
+
+struct Definition {
+    log::Level level;
+    log::Category category;
+    std::string file;
+    uint32_t line;
+    std::string function;
+    std::string format;
+};
+
+/** Reads the network byte order encoding written by BinaryTrace. */
+class Input {
+  public:
+    Input(std::istream& i) : in(i) {}
+
+    bool more() { return in.peek() != EOF; }
+
+    uint8_t get8() {
+        char c;
+        if (!in.get(c)) throw std::runtime_error("truncated trace file");
+        return uint8_t(c);
+    }
+
+    uint32_t get32() {
+        uint32_t i = 0;
+        for (int n = 0; n < 4; ++n) i = (i << 8) | get8();
+        return i;
+    }
+
+    uint64_t get64() {
+        uint64_t hi = get32();
+        return (hi << 32) | get32();
+    }
+
+    std::string getString() {
+        std::string s(get32(), '\0');
+        if (!s.empty() && !in.read(&s[0], s.size()))
+            throw std::runtime_error("truncated trace file");
+        return s;
+    }
+
+  private:
+    std::istream& in;
+};
+
+void printTime(std::ostream& os, uint64_t nanos) {
+    time_t seconds = time_t(nanos / 1000000000);
+    char text[32];
+    ::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", ::localtime(&seconds));
+    os << text << "." << std::setw(9) << std::setfill('0') << nanos % 1000000000
+       << std::setfill(' ') << " ";
+}
+
+void printFrames(std::ostream& os, std::string bytes) {
+    framing::Buffer buffer(&bytes[0], bytes.size());
+    framing::AMQFrame frame;
+    bool first = true;
+    while (frame.decode(buffer)) {
+        if (!first) os << " ";
+        os << frame;
+        first = false;
+    }
+    if (buffer.available())
+        os << " (" << buffer.available() << " bytes of partial frame)";
+}
+
+// AMQP 1.0 frames: size:u32 doff:u8 type:u8 channel:u16, body from doff*4
+void printAmqp(std::ostream& os, const std::string& bytes) {
+    size_t position = 0;
+    while (position < bytes.size()) {
+        const char* data = bytes.data() + position;
+        size_t available = bytes.size() - position;
+        if (available >= 8 && std::string(data, 4) == "AMQP") {
+            os << "AMQP(" << int(data[4]) << " " << int(data[5]) << "." << int(data[6])
+               << "." << int(data[7]) << ") ";
+            position += 8;
+            continue;
+        }
+        if (available < 8) break;
+        framing::Buffer header(const_cast<char*>(data), 8);
+        uint32_t size = header.getLong();
+        uint8_t doff = header.getOctet();
+        header.getOctet();      // type
+        uint16_t channel = header.getShort();
+        if (size > available || size < doff*4u) break;
+        os << "[" << channel << "] ";
+        if (size == doff*4u) {
+            os << "(empty) ";
+        } else {
+            try {
+                amqp::Decoder decoder(data + doff*4, size - doff*4);
+                if (decoder.readCode() == 0x00)
+                    os << decoder.readDescriptor() << " ";
+                amqp::DataBuilder fields((types::Variant::List()));
+                decoder.read(fields);
+                os << fields.getValue() << " ";
+            } catch (const std::exception&) {
+                os << "(" << size << " bytes, not decodable) ";
+            }
+        }
+        position += size;
+    }
+    if (position < bytes.size())
+        os << "(" << bytes.size() - position << " bytes of partial frame)";
+}
+
+void printArgument(std::ostream& os, Input& in, uint8_t tag) {
+    switch (tag) {
+      case BinaryTrace::INT64: os << int64_t(in.get64()); break;
+      case BinaryTrace::UINT64: os << in.get64(); break;
+      case BinaryTrace::STRING: os << in.getString(); break;
+      case BinaryTrace::FRAMES_0_10: printFrames(os, in.getString()); break;
+      case BinaryTrace::AMQP_1_0: printAmqp(os, in.getString()); break;
+      default:
+        throw std::runtime_error((boost::format("unknown argument type %d") % int(tag)).str());
+    }
+}
+
+struct EarlierRecord {
+    bool operator()(const std::pair<uint64_t, std::string>& a, const std::pair<uint64_t, std::string>& b) const {
+        return a.first < b.first;
+    }
+};
+
+void decode(const Options& opts, std::istream& file) {
+    Input in(file);
+    char magic[7];
+    if (!file.read(magic, sizeof(magic)) || std::string(magic, sizeof(magic)) != "QPIDTRC")
+        throw std::runtime_error("not a binary trace file");
+    if (in.get8() != BinaryTrace::VERSION)
+        throw std::runtime_error("unsupported binary trace version");
+
+    std::map<uint32_t, Definition> definitions;
+    std::vector<std::pair<uint64_t, std::string> > records;
+    while (in.more()) {
+        uint8_t type = in.get8();
+        if (type == 'D') {
+            uint32_t id = in.get32();
+            Definition& d = definitions[id];
+            d.level = log::Level(in.get8());
+            d.category = log::Category(in.get8());
+            d.file = in.getString();
+            d.line = in.get32();
+            d.function = in.getString();
+            d.format = in.getString();
+        } else if (type == 'R') {
+            uint32_t id = in.get32();
+            uint64_t time = in.get64();
+            uint64_t thread = in.get64();
+            std::map<uint32_t, Definition>::const_iterator i = definitions.find(id);
+            if (i == definitions.end())
+                throw std::runtime_error("record for undefined statement");
+            const Definition& d = i->second;
+
+            std::ostringstream os;
+            if (opts.time) printTime(os, time);
+            if (opts.category) os << "[" << log::CategoryTraits::name(d.category) << "] ";
+            if (opts.level) os << log::LevelTraits::name(d.level) << " ";
+            if (opts.thread) os << "[0x" << std::hex << thread << std::dec << "] ";
+            if (opts.source) os << d.file << ":" << d.line << ": ";
+            // Substitute each argument for the next {} in the format.
+            std::string::size_type start = 0, mark;
+            for (uint8_t tag = in.get8(); tag != BinaryTrace::END; tag = in.get8()) {
+                mark = d.format.find("{}", start);
+                os << d.format.substr(start, mark == std::string::npos ? mark : mark - start);
+                if (mark == std::string::npos) {
+                    os << " ";
+                    start = d.format.size();
+                } else {
+                    start = mark + 2;
+                }
+                printArgument(os, in, tag);
+            }
+            os << d.format.substr(std::min(start, d.format.size()));
+            if (opts.sort)
+                records.push_back(std::make_pair(time, os.str()));
+            else
+                std::cout << os.str() << std::endl;
+        } else {
+            throw std::runtime_error("corrupt binary trace file");
+        }
+    }
+    std::stable_sort(records.begin(), records.end(), EarlierRecord());
+    for (size_t i = 0; i < records.size(); ++i)
+        std::cout << records[i].second << std::endl;
+}
+
+}} // namespace qpid::tests
+
+int main(int argc, char** argv)
+{
+    using namespace qpid::tests;
+    try {
+        Options opts;
+        opts.parse(argc, argv);
+        if (opts.help || opts.files.empty()) {
+            std::cout << opts << std::endl
+                      << "Prints binary trace files written with --log-binary-trace as text." << std::endl;
+            return opts.help ? 0 : 1;
+        }
+        for (std::vector<std::string>::const_iterator i = opts.files.begin(); i != opts.files.end(); ++i) {
+            std::ifstream file(i->c_str(), std::ios::in | std::ios::binary);
+            if (!file) throw std::runtime_error("cannot open " + *i);
+            decode(opts, file);
+        }
+        return 0;
+    } catch(const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << std::endl;
+    }
+    return 2;
+}
@@ -37,6 +37,7 @@
 #include <qpid/log/Options.h>
 #include "qpid/sys/Runnable.h"
 #include "qpid/sys/Thread.h"
+#include "qpid/sys/Time.h"
 
 using namespace qpid::messaging;
 using namespace qpid::sys;
@@ -44,6 +45,8 @@ using namespace qpid::sys;
 namespace qpid {
 namespace tests {
 
+using qpid::messaging::Duration;
+
 typedef std::vector<std::string> StringSet;
 
 struct Options : public qpid::Options {
@@ -64,11 +67,13 @@ struct Options : public qpid::Options {
     uint port;
     bool quiet;
     double fetchTimeout;
+    uint benchmarkSpan;
 
     Options() : help(false), init(true), transfer(true), check(true),
                 size(256), durable(true), queues(2),
                 base("tx"), msgsPerTx(1), txCount(5), totalMsgCount(10),
-                capacity(1000), url("localhost"), port(0), quiet(false), fetchTimeout(5)
+                capacity(1000), url("localhost"), port(0), quiet(false), fetchTimeout(5),
+                benchmarkSpan(0)
     {
         addOptions()
             ("init", qpid::optValue(init, "yes|no"), "Declare queues and populate one with the initial set of messages.")
@@ -87,6 +92,7 @@ struct Options : public qpid::Options {
             ("port,p", qpid::optValue(port, "PORT"), "(for test compatibility only, use broker option instead)")
             ("quiet", qpid::optValue(quiet), "reduce output from test")
             ("fetch-timeout", qpid::optValue(fetchTimeout, "SECONDS"), "Timeout for transactional fetch")
+            ("benchmark-span", qpid::optValue(benchmarkSpan, "N"), "Instead of moving messages, time transactions that each send messages-per-tx messages to every one of 1 up to N queues")
             ("help", qpid::optValue(help), "print this usage statement");
         add(log);
     }
@@ -340,6 +346,54 @@ struct Controller : public Client
         }
     }
 };
+/**
+ * Times transactions that each send to a number of queues, to measure how
+ * commit cost grows with the number of queues a transaction spans.
+ */
+struct Benchmark : public TransactionalClient
+{
+    Benchmark(const Options& opts) : TransactionalClient(opts) {}
+
+    void run(uint span)
+    {
+        StringSet queues;
+        generateSet(opts.base + "-span", span, queues);
+        std::vector<Sender> senders;
+        for (StringSet::iterator i = queues.begin(); i != queues.end(); i++) {
+            std::string address = *i + "; {create:always, delete:always"
+                + (opts.durable ? ", node:{durable:True}}" : "}");
+            senders.push_back(session.createSender(address));
+        }
+        Message msg(generateData(opts.size));
+        msg.setDurable(opts.durable);
+
+        qpid::sys::AbsTime start = qpid::sys::AbsTime::now();
+        for (uint t = 0; t < opts.txCount; t++) {
+            for (std::vector<Sender>::iterator i = senders.begin(); i != senders.end(); i++) {
+                for (uint m = 0; m < opts.msgsPerTx; m++) i->send(msg);
+            }
+            session.commit();
+        }
+        qpid::sys::Duration elapsed(start, qpid::sys::AbsTime::now());
+        double secs = double(int64_t(elapsed))/qpid::sys::TIME_SEC;
+        std::cout << std::setw(5) << span << " queues: "
+                  << std::setw(10) << std::fixed << std::setprecision(1) << opts.txCount/secs << " tx/s, "
+                  << std::setw(10) << std::setprecision(3) << secs*1000/opts.txCount << " ms/tx" << std::endl;
+
+        // Closing the senders deletes the queues and their messages.
+        for (std::vector<Sender>::iterator i = senders.begin(); i != senders.end(); i++) i->close();
+    }
+
+    void run()
+    {
+        const uint spans[] = { 1, 2, 5, 10, 20, 50, 100 };
+        uint last = 0;
+        for (uint i = 0; i < sizeof(spans)/sizeof(spans[0]) && spans[i] <= opts.benchmarkSpan; i++) {
+            run(last = spans[i]);
+        }
+        if (last < opts.benchmarkSpan) run(opts.benchmarkSpan);
+    }
+};
 }} // namespace qpid::tests
 
 using namespace qpid::tests;
@@ -349,6 +403,10 @@ int main(int argc, char** argv)
     try {
         Options opts;
         if (opts.parse(argc, argv)) {
+            if (opts.benchmarkSpan) {
+                Benchmark(opts).run();
+                return 0;
+            }
             Controller controller(opts);
             if (opts.init) controller.init();
             if (opts.transfer) controller.transfer();
@@ -0,0 +1,116 @@
+/*
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+// Microbenchmark for sys::Timer: add, restart and cancel many long
+// running tasks, much as connection heartbeats and idle timeouts do.
+
+#include "qpid/Options.h"
+#include "qpid/sys/Time.h"
+#include "qpid/sys/Timer.h"
+#include <exception>
+#include <iostream>
+#include <vector>
+
+namespace qpid {
+namespace tests {
+
+using namespace qpid::sys;
+using boost::intrusive_ptr;
+
+struct Args : public qpid::Options
+{
+    uint tasks;
+    uint spread;
+    uint iterations;
+    bool help;
+
+    Args() : qpid::Options("Timer benchmark"), tasks(100000), spread(600), iterations(10), help(false)
+    {
+        addOptions()
+            ("tasks", qpid::optValue(tasks, "N"), "number of tasks")
+            ("spread", qpid::optValue(spread, "SECONDS"), "task timeouts range from 1 to this many seconds")
+            ("iterations", qpid::optValue(iterations, "N"), "times to repeat")
+            ("help", qpid::optValue(help), "print this usage statement");
+    }
+
+    bool parse(int argc, char** argv) {
+        try {
+            qpid::Options::parse(argc, argv);
+            if (spread == 0) throw qpid::Options::Exception("spread must be greater than 0");
+            if (help) {
+                std::cerr << *this << std::endl << std::endl;
+            } else {
+                return true;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << *this << std::endl << std::endl << e.what() << std::endl;
+        }
+        return false;
+    }
+};
+
+class IdleTask : public TimerTask
+{
+  public:
+    IdleTask(Duration timeout) : TimerTask(timeout, "Idle") {}
+    void fire() {}
+};
+
+int64_t each(AbsTime start, AbsTime end, uint count) {
+    return Duration(start, end) / count;
+}
+
+void run(const Args& args, Timer& timer) {
+    std::vector<intrusive_ptr<TimerTask> > tasks;
+    tasks.reserve(args.tasks);
+    for (uint i = 0; i < args.tasks; ++i)
+        tasks.push_back(new IdleTask(Duration((i % args.spread + 1) * TIME_SEC)));
+
+    AbsTime start(now());
+    for (uint i = 0; i < args.tasks; ++i) timer.add(tasks[i]);
+    AbsTime added(now());
+    for (uint i = 0; i < args.tasks; ++i) tasks[i]->restart();
+    AbsTime restarted(now());
+    for (uint i = 0; i < args.tasks; ++i) tasks[i]->cancel();
+    AbsTime cancelled(now());
+
+    std::cout << args.tasks << " tasks: add " << each(start, added, args.tasks)
+              << "ns, restart " << each(added, restarted, args.tasks)
+              << "ns, cancel " << each(restarted, cancelled, args.tasks) << "ns each" << std::endl;
+}
+
+}} // namespace qpid::tests
+
+using namespace qpid::tests;
+
+int main(int argc, char** argv)
+{
+    Args args;
+    if (!args.parse(argc, argv)) return 1;
+    try {
+        qpid::sys::Timer timer;
+        for (uint i = 0; i < args.iterations; ++i) run(args, timer);
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    return 1;
+}